@@ -0,0 +1,68 @@
+//
+// Heap allocations and time to parse and build the AST of large inputs, and
+// time to tear the tree down again.
+//
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <utility>
+
+#include "bench_util.h"
+#include "grammar/parser_slr.h"
+#include "lexer/lexer.h"
+#include "token.h"
+
+using namespace front;
+
+static bool counting = false;
+static size_t allocations = 0;
+
+void *operator new(const std::size_t size) {
+    if (counting) ++allocations;
+    if (void *p = std::malloc(size == 0 ? 1 : size)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+int main(int argc, char *argv[]) {
+    const size_t iterations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 5;
+    const auto &parser = grammar::SLRParser::shared();
+    lexer::Lexer lexer{};
+
+    std::cout << std::fixed << std::setprecision(3);
+    for (const size_t functions: {100, 400, 1600}) {
+        lexer.reset(bench::generate_source(functions, 24));
+        const auto tokens = post_process(lexer.tokenize());
+
+        allocations = 0;
+        counting = true;
+        auto counted = parser.parse(tokens);
+        counting = false;
+        const size_t parse_allocations = allocations;
+        counted = {};
+
+        double build_ms = 0, teardown_ms = 0;
+        for (size_t i = 0; i < iterations; ++i) {
+            using clock = std::chrono::steady_clock;
+            const auto start = clock::now();
+            auto result = parser.parse(tokens);
+            const auto built = clock::now();
+            result = {};
+            const auto released = clock::now();
+            build_ms += std::chrono::duration<double, std::milli>(built - start).count();
+            teardown_ms += std::chrono::duration<double, std::milli>(released - built).count();
+        }
+
+        std::cout << "tokens: " << std::setw(7) << tokens.size()
+                << "  allocations: " << std::setw(8) << parse_allocations
+                << "  parse+build: " << std::setw(9) << build_ms / static_cast<double>(iterations) << " ms"
+                << "  teardown: " << std::setw(7) << teardown_ms / static_cast<double>(iterations) << " ms"
+                << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <utility>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+
+namespace front::bench {
+    // Synthetic program accepted by both the SLR and the LL(1) grammar:
+    // `functions` functions of `statements` statements each, plus main.
+    inline std::string generate_source(const size_t functions, const size_t statements) {
+        std::string src;
+        src += "int g = 1;\nconst int k = 3;\n";
+        for (size_t f = 0; f < functions; ++f) {
+            // appended, not "f" + to_string(f): GCC 12 warns -Wrestrict on that
+            const auto name = std::string{"f"}.append(std::to_string(f));
+            src += "int " + name + "(int a, int b) {\n";
+            for (size_t s = 0; s < statements; ++s) {
+                const auto v = std::string{"v"}.append(std::to_string(s));
+                switch (s % 4) {
+                    case 0:
+                        src += "    int " + v + " = a * (b - " + std::to_string(s) + ") + k;\n";
+                        break;
+                    case 1:
+                        src += "    a = a + b * 2 - g / 3;\n";
+                        break;
+                    case 2:
+                        src += "    if (a < b) { a = a + 1; } else { b = b - 1; }\n";
+                        break;
+                    default:
+                        src += "    if (a == b || b != 0 && a > 1) b = b % 7;\n";
+                        break;
+                }
+            }
+            src += "    return a + b;\n}\n";
+        }
+        src += "int main() {\n    return 0;\n}\n";
+        return src;
+    }
+
+    // mean wall time of `fn` in milliseconds over `iterations` runs, after one warm-up run
+    template<typename F>
+    double time_ms(const size_t iterations, F &&fn) {
+        fn();
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; ++i) {
+            fn();
+        }
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / static_cast<double>(iterations);
+    }
+
+    // keeps the optimizer from discarding a result
+    template<typename T>
+    void do_not_optimize(T &&value) {
+#ifdef _MSC_VER
+        // no inline asm on MSVC: publish the address through a volatile sink
+        static const void *volatile sink;
+        sink = static_cast<const void *>(&value);
+        _ReadWriteBarrier();
+#else
+        asm volatile("" : : "r,m"(value) : "memory");
+#endif
+    }
+}
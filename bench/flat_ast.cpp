@@ -0,0 +1,227 @@
+//
+// Traversal time, and cache misses where perf counters are available, of the
+// pointer AST against its flat structure-of-arrays encoding.
+//
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <ostream>
+#include <streambuf>
+#include <string>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define FRONT_BENCH_PERF 1
+#endif
+
+#include "bench_util.h"
+#include "ast/ast.h"
+#include "ast/flat_ast.h"
+#include "grammar/parser_slr.h"
+#include "lexer/lexer.h"
+#include "token.h"
+
+using namespace front;
+
+namespace {
+    // last-level cache misses of this thread, when the kernel lets us count
+    // them; n/a off Linux
+    class CacheMissCounter {
+    public:
+        CacheMissCounter() {
+#ifdef FRONT_BENCH_PERF
+            perf_event_attr attr{};
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.size = sizeof(attr);
+            attr.config = PERF_COUNT_HW_CACHE_MISSES;
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+        }
+
+        CacheMissCounter(const CacheMissCounter &) = delete;
+
+        CacheMissCounter &operator=(const CacheMissCounter &) = delete;
+
+        ~CacheMissCounter() {
+#ifdef FRONT_BENCH_PERF
+            if (fd_ >= 0) close(fd_);
+#endif
+        }
+
+        template<typename F>
+        std::optional<uint64_t> measure(F &&fn) const {
+            if (fd_ < 0) {
+                fn();
+                return std::nullopt;
+            }
+#ifdef FRONT_BENCH_PERF
+            ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+            fn();
+            ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+            uint64_t count = 0;
+            if (read(fd_, &count, sizeof(count)) != sizeof(count)) return std::nullopt;
+            return count;
+#else
+            return std::nullopt;
+#endif
+        }
+
+    private:
+        int fd_{-1};
+    };
+
+    struct NullBuffer : std::streambuf {
+        int overflow(const int c) override { return c; }
+    };
+
+    // what a typical analysis pass does: visit every node, read payloads
+    struct Totals {
+        size_t nodes{0};
+        int64_t literal_sum{0};
+    };
+
+    void walk(const ast::Expr *e, Totals &t) {
+        ++t.nodes;
+        if (const auto *lit = ast::node_cast<ast::LiteralInt>(e)) {
+            t.literal_sum += lit->value;
+        } else if (const auto *unary = ast::node_cast<ast::UnaryExpr>(e)) {
+            walk(unary->operand.get(), t);
+        } else if (const auto *binary = ast::node_cast<ast::BinaryExpr>(e)) {
+            walk(binary->lhs.get(), t);
+            walk(binary->rhs.get(), t);
+        } else if (const auto *call = ast::node_cast<ast::CallExpr>(e)) {
+            for (const auto &arg: call->args) walk(arg.get(), t);
+        }
+    }
+
+    void walk(const ast::Decl *d, Totals &t);
+
+    void walk(const ast::Stmt *s, Totals &t) {
+        ++t.nodes;
+        if (const auto *block = ast::node_cast<ast::BlockStmt>(s)) {
+            for (const auto &item: block->items) {
+                if (item.type == ast::BlockItem::Type::Decl) walk(item.decl.get(), t);
+                else walk(item.stmt.get(), t);
+            }
+        } else if (const auto *expr_stmt = ast::node_cast<ast::ExprStmt>(s)) {
+            walk(expr_stmt->expr.get(), t);
+        } else if (const auto *assign = ast::node_cast<ast::AssignStmt>(s)) {
+            walk(assign->expr.get(), t);
+        } else if (const auto *ret = ast::node_cast<ast::ReturnStmt>(s)) {
+            if (ret->value) walk(ret->value.get(), t);
+        } else if (const auto *ifs = ast::node_cast<ast::IfStmt>(s)) {
+            walk(ifs->condition.get(), t);
+            walk(ifs->then_branch.get(), t);
+            if (ifs->else_branch) walk(ifs->else_branch.get(), t);
+        }
+    }
+
+    void walk(const ast::Decl *d, Totals &t) {
+        ++t.nodes;
+        for (const auto &init: ast::node_cast<ast::VarDecl>(d)->items) {
+            ++t.nodes;
+            if (init.value) walk(init.value.get(), t);
+        }
+    }
+
+    Totals walk(const ast::Program &program) {
+        Totals t;
+        for (const auto &decl: program.globals) walk(decl.get(), t);
+        for (const auto &func: program.functions) {
+            t.nodes += 1 + func->params.size();
+            walk(func->body.get(), t);
+        }
+        return t;
+    }
+
+    void walk(const ast::FlatAst &flat, const ast::NodeId id, Totals &t) {
+        ++t.nodes;
+        if (flat.kinds[id] == ast::FlatKind::LiteralInt) {
+            t.literal_sum += flat.int_value(id);
+        }
+        for (const ast::NodeId child: flat.children_of(id)) walk(flat, child, t);
+    }
+
+    Totals walk(const ast::FlatAst &flat) {
+        Totals t;
+        for (const ast::NodeId id: flat.globals) walk(flat, id, t);
+        for (const ast::NodeId id: flat.functions) walk(flat, id, t);
+        return t;
+    }
+
+    // passes that do not care about nesting can sweep the arrays directly
+    Totals scan(const ast::FlatAst &flat) {
+        Totals t;
+        t.nodes = flat.size();
+        for (ast::NodeId id = 0; id < flat.size(); ++id) {
+            if (flat.kinds[id] == ast::FlatKind::LiteralInt) t.literal_sum += flat.int_value(id);
+        }
+        return t;
+    }
+
+    std::string misses(const std::optional<uint64_t> count) {
+        return count ? std::to_string(*count) : "n/a";
+    }
+}
+
+int main(int argc, char *argv[]) {
+    const size_t iterations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10;
+    const auto &parser = grammar::SLRParser::shared();
+    const CacheMissCounter counter;
+    NullBuffer null_buffer;
+    std::ostream null_stream{&null_buffer};
+
+    std::cout << std::fixed << std::setprecision(3);
+    for (const size_t functions: {100, 400, 1600}) {
+        lexer::Lexer lexer{bench::generate_source(functions, 24)};
+        const auto result = parser.parse(post_process(lexer.tokenize()));
+        if (!result.success) {
+            std::cerr << "parse failed" << std::endl;
+            return 1;
+        }
+        const auto &program = *result.program;
+
+        const double flatten_ms = bench::time_ms(iterations, [&] {
+            bench::do_not_optimize(ast::flatten(program));
+        });
+        const auto flat = ast::flatten(program);
+
+        const auto tree_totals = walk(program);
+        const auto flat_totals = walk(flat);
+        if (tree_totals.literal_sum != flat_totals.literal_sum ||
+            scan(flat).literal_sum != tree_totals.literal_sum) {
+            std::cerr << "flat encoding disagrees with the tree" << std::endl;
+            return 1;
+        }
+
+        const double tree_walk_ms = bench::time_ms(iterations, [&] { bench::do_not_optimize(walk(program)); });
+        const double flat_walk_ms = bench::time_ms(iterations, [&] { bench::do_not_optimize(walk(flat)); });
+        const double flat_scan_ms = bench::time_ms(iterations, [&] { bench::do_not_optimize(scan(flat)); });
+        const double tree_print_ms = bench::time_ms(iterations, [&] { ast::print_ast(result.program, null_stream); });
+        const double flat_print_ms = bench::time_ms(iterations, [&] { ast::print_ast(flat, null_stream); });
+
+        const auto tree_misses = counter.measure([&] { bench::do_not_optimize(walk(program)); });
+        const auto flat_misses = counter.measure([&] { bench::do_not_optimize(walk(flat)); });
+
+        std::cout << "nodes: " << std::setw(8) << flat.size()
+                << "  flat bytes: " << std::setw(9) << flat.footprint()
+                << "  flatten: " << std::setw(8) << flatten_ms << " ms\n"
+                << "    walk   tree: " << std::setw(8) << tree_walk_ms << " ms"
+                << "  flat: " << std::setw(8) << flat_walk_ms << " ms"
+                << "  flat scan: " << std::setw(8) << flat_scan_ms << " ms\n"
+                << "    print  tree: " << std::setw(8) << tree_print_ms << " ms"
+                << "  flat: " << std::setw(8) << flat_print_ms << " ms\n"
+                << "    cache misses per walk  tree: " << misses(tree_misses)
+                << "  flat: " << misses(flat_misses) << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,214 @@
+//
+// Cost of building the SLR tables for synthetic grammars of 100 to 10,000
+// productions, phase by phase, with the state count and the peak RSS of
+// each build. Each build runs in a forked child so peak RSS is its own.
+//
+//   bench_grammar_scaling [max-productions]
+//
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#define FRONT_BENCH_FORK 1
+#endif
+
+#include "grammar/grammar.h"
+#include "grammar/parser_slr.h"
+
+using namespace front::grammar;
+
+namespace {
+    // productions as owned bodies, since Grammar::RawProduction only borrows them
+    struct GrammarSpec {
+        std::string start;
+        std::vector<std::string> heads{};
+        std::vector<std::vector<Symbol> > bodies{};
+
+        void add(std::string head, std::vector<Symbol> body) {
+            heads.push_back(std::move(head));
+            bodies.push_back(std::move(body));
+        }
+
+        [[nodiscard]] Grammar build() const {
+            std::vector<Grammar::RawProduction> productions;
+            productions.reserve(heads.size());
+            for (size_t i = 0; i < heads.size(); ++i) {
+                productions.emplace_back(heads[i], bodies[i]);
+            }
+            return Grammar{start, productions};
+        }
+    };
+
+    // appended rather than prefix + to_string(i): GCC 12 warns -Wrestrict on that
+    std::string indexed(const char *prefix, const size_t i) {
+        return std::string{prefix}.append(std::to_string(i));
+    }
+
+    // E0 -> E0 op0 E1 | E1, ..., En -> ( E0 ) | id: a precedence ladder whose
+    // closures grow with its height
+    GrammarSpec expression_tower(const size_t productions) {
+        const size_t levels = std::max<size_t>(1, (productions - 3) / 2);
+        GrammarSpec g{.start = "S"};
+        g.add("S", {NT("E0")});
+        for (size_t i = 0; i < levels; ++i) {
+            g.add(indexed("E", i), {NT(indexed("E", i)), T(indexed("op", i)), NT(indexed("E", i + 1))});
+            g.add(indexed("E", i), {NT(indexed("E", i + 1))});
+        }
+        g.add(indexed("E", levels), {T("("), NT("E0"), T(")")});
+        g.add(indexed("E", levels), {T("id")});
+        return g;
+    }
+
+    // a statement list over many statement keywords, each followed by a
+    // comma-separated argument list
+    GrammarSpec long_lists(const size_t productions) {
+        const size_t keywords = std::max<size_t>(1, productions - 7);
+        GrammarSpec g{.start = "S"};
+        g.add("S", {NT("List")});
+        g.add("List", {NT("List"), NT("Stmt")});
+        g.add("List", {NT("Stmt")});
+        g.add("Stmt", {NT("Kw"), NT("Args"), T(";")});
+        for (size_t i = 0; i < keywords; ++i) {
+            g.add("Kw", {T(indexed("kw", i))});
+        }
+        g.add("Args", {NT("Args"), T(","), NT("Arg")});
+        g.add("Args", {NT("Arg")});
+        g.add("Arg", {T("id")});
+        return g;
+    }
+
+    // N0 -> N1 A0, N1 -> N2 A1, ..., Ai -> ti | ε: a run of optional
+    // tokens, so nullability, FIRST and FOLLOW propagate along the whole
+    // chain. The terminals repeat every 16 links, which leaves shift/reduce
+    // conflicts that the table builder resolves as shifts.
+    GrammarSpec nullable_chain(const size_t productions) {
+        constexpr size_t kAlphabet = 16;
+        const size_t links = std::max<size_t>(1, (productions - 2) / 3);
+        GrammarSpec g{.start = "S"};
+        g.add("S", {NT("N0"), T("end")});
+        for (size_t i = 0; i < links; ++i) {
+            g.add(indexed("N", i), {NT(indexed("N", i + 1)), NT(indexed("A", i))});
+            g.add(indexed("A", i), {T(indexed("t", i % kAlphabet))});
+            g.add(indexed("A", i), {Epsilon()});
+        }
+        g.add(indexed("N", links), {Epsilon()});
+        return g;
+    }
+
+    struct Sample {
+        size_t productions{0};
+        double first_ms{0};
+        double follow_ms{0};
+        SLRBuildStats build{};
+        long peak_rss_kb{-1};
+    };
+
+    Sample measure(const GrammarSpec &spec) {
+        Grammar grammar = spec.build();
+        Sample sample;
+        sample.productions = grammar.productions.size();
+        sample.first_ms = grammar.analysis_times_.first_ms;
+        sample.follow_ms = grammar.analysis_times_.follow_ms;
+        const SLRParser parser{std::move(grammar)};
+        sample.build = parser.build_stats();
+#ifdef FRONT_BENCH_FORK
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+        sample.peak_rss_kb = usage.ru_maxrss / 1024;
+#else
+        sample.peak_rss_kb = usage.ru_maxrss;
+#endif
+#endif
+        return sample;
+    }
+
+    // measures in a child process, so its peak RSS is not inflated by
+    // earlier, larger builds
+    Sample measure_isolated(const GrammarSpec &spec) {
+#ifdef FRONT_BENCH_FORK
+        int fds[2];
+        if (pipe(fds) == 0) {
+            if (const pid_t child = fork(); child == 0) {
+                close(fds[0]);
+                const Sample sample = measure(spec);
+                const bool written = write(fds[1], &sample, sizeof sample) == sizeof sample;
+                _exit(written ? 0 : 1);
+            } else if (child > 0) {
+                close(fds[1]);
+                Sample sample;
+                const bool read_ok = read(fds[0], &sample, sizeof sample) == sizeof sample;
+                close(fds[0]);
+                int status = 0;
+                waitpid(child, &status, 0);
+                if (read_ok && WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+                    return sample;
+                }
+                std::cerr << "child build failed, measuring in process" << std::endl;
+            } else {
+                close(fds[0]);
+                close(fds[1]);
+            }
+        }
+#endif
+        return measure(spec);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    const size_t max_productions = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10'000;
+
+    struct Family {
+        const char *name;
+        std::function<GrammarSpec(size_t)> generate;
+        std::vector<size_t> sizes;
+    };
+
+    // a tower of height n has O(n^2) LR(0) items, so it stops earlier
+    const std::vector<Family> families{
+        {"expression-tower", expression_tower, {100, 300, 1'000}},
+        {"long-lists", long_lists, {100, 300, 1'000, 3'000, 10'000}},
+        {"nullable-chain", nullable_chain, {100, 300, 1'000, 3'000, 10'000}},
+    };
+
+    std::cout << std::left << std::setw(18) << "grammar"
+            << std::right << std::setw(8) << "prods"
+            << std::setw(10) << "first"
+            << std::setw(10) << "follow"
+            << std::setw(11) << "items"
+            << std::setw(10) << "tables"
+            << std::setw(9) << "states"
+            << std::setw(10) << "actions"
+            << std::setw(12) << "peak RSS" << "\n"
+            << std::left << std::setw(18) << ""
+            << std::right << std::setw(8) << ""
+            << std::setw(10) << "ms" << std::setw(10) << "ms"
+            << std::setw(11) << "ms" << std::setw(10) << "ms"
+            << std::setw(9) << "" << std::setw(10) << ""
+            << std::setw(12) << "KiB" << "\n";
+
+    std::cout << std::fixed << std::setprecision(2);
+    for (const auto &[name, generate, sizes]: families) {
+        for (const size_t size: sizes) {
+            if (size > max_productions) break;
+            const Sample s = measure_isolated(generate(size));
+            std::cout << std::left << std::setw(18) << name
+                    << std::right << std::setw(8) << s.productions
+                    << std::setw(10) << s.first_ms
+                    << std::setw(10) << s.follow_ms
+                    << std::setw(11) << s.build.item_sets_ms
+                    << std::setw(10) << s.build.tables_ms
+                    << std::setw(9) << s.build.states
+                    << std::setw(10) << s.build.action_entries
+                    << std::setw(12) << s.peak_rss_kb << std::endl;
+        }
+    }
+    return 0;
+}
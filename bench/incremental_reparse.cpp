@@ -0,0 +1,55 @@
+//
+// Reparse time after a one-token edit in the middle of the file, against a
+// full parse, for growing file sizes.
+//
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <utility>
+
+#include "bench_util.h"
+#include "grammar/grammar.h"
+#include "grammar/parser_slr.h"
+#include "lexer/lexer.h"
+#include "token.h"
+
+using namespace front;
+
+int main(int argc, char *argv[]) {
+    const size_t iterations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10;
+    const grammar::SLRParser parser{grammar::Grammar{}};
+
+    std::cout << std::fixed << std::setprecision(3);
+    for (const size_t functions: {100, 400, 1600}) {
+        const auto source = bench::generate_source(functions, 24);
+        lexer::Lexer lexer{source};
+        const auto tokens = post_process(lexer.tokenize());
+
+        // flip one integer literal in the middle of the file
+        auto edited = tokens;
+        size_t pos = edited.size() / 2;
+        while (edited[pos].type != TokenType::LiteralInt) ++pos;
+        edited[pos].lexeme += "1";
+        const grammar::TokenEdit edit{pos, pos + 1, pos + 1};
+
+        const double full_ms = bench::time_ms(iterations, [&] {
+            bench::do_not_optimize(parser.parse(tokens).program);
+        });
+
+        auto parsed = parser.parse_incremental(tokens);
+        bool flip = false;
+        const double incremental_ms = bench::time_ms(iterations, [&] {
+            flip = !flip;
+            parsed = parser.reparse(std::move(parsed), flip ? edited : tokens, edit);
+        });
+        if (!parsed.result.success) {
+            std::cerr << "reparse failed" << std::endl;
+            return 1;
+        }
+
+        std::cout << "tokens: " << std::setw(8) << tokens.size()
+                << "  full: " << std::setw(10) << full_ms << " ms"
+                << "  incremental: " << std::setw(8) << incremental_ms << " ms\n";
+    }
+    return 0;
+}
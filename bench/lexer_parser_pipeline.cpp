@@ -0,0 +1,54 @@
+//
+// Lexing and SLR parsing of one large file three ways: sequentially over a
+// token vector, fused through a TokenRing, and pipelined with the lexer on
+// its own thread. Reports the speedup over the sequential path.
+//
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+#include "bench_util.h"
+#include "grammar/parser_slr.h"
+#include "lexer/lexer.h"
+#include "lexer/token_pipeline.h"
+#include "lexer/token_ring.h"
+#include "token.h"
+
+using namespace front;
+
+int main(int argc, char *argv[]) {
+    const size_t iterations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 5;
+    const size_t functions = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 400;
+
+    const auto &parser = grammar::SLRParser::shared();
+    const auto source = bench::generate_source(functions, 24);
+    lexer::Lexer lexer{};
+
+    lexer.reset(source);
+    const size_t n_tokens = lexer.tokenize().size();
+
+    const double sequential_ms = bench::time_ms(iterations, [&] {
+        lexer.reset(source);
+        const auto tokens = post_process(lexer.tokenize());
+        bench::do_not_optimize(parser.parse(tokens).program);
+    });
+    const double fused_ms = bench::time_ms(iterations, [&] {
+        lexer.reset(source);
+        lexer::TokenRing ring{lexer};
+        bench::do_not_optimize(parser.parse_source(ring).program);
+    });
+    const double pipelined_ms = bench::time_ms(iterations, [&] {
+        lexer.reset(source);
+        lexer::TokenPipeline pipeline{lexer};
+        bench::do_not_optimize(parser.parse_source(pipeline).program);
+    });
+
+    std::cout << "tokens: " << n_tokens << ", iterations: " << iterations
+            << ", hardware threads: " << std::thread::hardware_concurrency() << "\n"
+            << std::fixed << std::setprecision(3)
+            << "sequential: " << sequential_ms << " ms\n"
+            << "fused:      " << fused_ms << " ms (" << sequential_ms / fused_ms << "x)\n"
+            << "pipelined:  " << pipelined_ms << " ms (" << sequential_ms / pipelined_ms << "x)\n";
+    return 0;
+}
@@ -0,0 +1,54 @@
+//
+// SLR parsing (with AST construction) vs table-driven LL(1) and generated
+// recursive-descent recognition on the same generated token streams.
+//
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+#include "bench_util.h"
+#include "grammar/grammar.h"
+#include "grammar/parser_ll.h"
+#include "grammar/parser_rd.h"
+#include "grammar/parser_slr.h"
+#include "lexer/lexer.h"
+#include "token.h"
+
+using namespace front;
+
+int main(int argc, char *argv[]) {
+    const size_t functions = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200;
+    const size_t iterations = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 10;
+
+    const auto source = bench::generate_source(functions, 24);
+    lexer::Lexer lexer{source};
+    const auto tokens = post_process(lexer.tokenize());
+
+    const grammar::SLRParser slr{grammar::Grammar{}};
+    const grammar::LL1Parser ll1{};
+    const grammar::RDParser rd{};
+
+    grammar::NullTraceSink sink;
+    if (!slr.parse(tokens).success || !ll1.parse(tokens, sink) || !rd.parse(tokens)) {
+        std::cerr << "generated source was rejected" << std::endl;
+        return 1;
+    }
+
+    const double slr_ms = bench::time_ms(iterations, [&] {
+        bench::do_not_optimize(slr.parse(tokens).program);
+    });
+    const double ll1_ms = bench::time_ms(iterations, [&] {
+        bench::do_not_optimize(ll1.parse(tokens, sink));
+    });
+    const double rd_ms = bench::time_ms(iterations, [&] {
+        bench::do_not_optimize(rd.parse(tokens));
+    });
+
+    const auto rate = [&](const double ms) { return static_cast<double>(tokens.size()) / ms / 1000.0; };
+    std::cout << std::fixed << std::setprecision(3)
+            << "tokens: " << tokens.size() << ", iterations: " << iterations << '\n'
+            << "SLR (with AST): " << slr_ms << " ms/parse, " << rate(slr_ms) << " Mtok/s\n"
+            << "LL(1):          " << ll1_ms << " ms/parse, " << rate(ll1_ms) << " Mtok/s\n"
+            << "RD (generated): " << rd_ms << " ms/parse, " << rate(rd_ms) << " Mtok/s\n";
+    return 0;
+}
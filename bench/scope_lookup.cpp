@@ -0,0 +1,81 @@
+//
+// Codegen time for programs whose variable references sit under deeply
+// nested blocks, where each reference resolves against every enclosing scope,
+// and for many small functions whose locals all have distinct names, where
+// per-function scope state must not grow with the interned name count.
+//
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "bench_util.h"
+#include "grammar/parser_slr.h"
+#include "ir/ir_generator.h"
+#include "lexer/lexer.h"
+#include "token.h"
+
+using namespace front;
+
+// `functions` functions nesting `depth` blocks; every level shadows `x`, and
+// the innermost block reads the outermost `a0` and the innermost `x`
+static std::string nested_source(const size_t functions, const size_t depth, const size_t statements) {
+    std::string src;
+    for (size_t f = 0; f < functions; ++f) {
+        src += "int f" + std::to_string(f) + "() {\n  int a0 = 1;\n";
+        for (size_t d = 1; d <= depth; ++d) {
+            src += "{ int x = " + std::to_string(d) + "; int a" + std::to_string(d) + " = x;\n";
+        }
+        for (size_t s = 0; s < statements; ++s) {
+            src += "  a0 = a0 + x;\n";
+        }
+        src += std::string(depth, '}') + "\n  return a0;\n}\n";
+    }
+    src += "int main() {\n  return 0;\n}\n";
+    return src;
+}
+
+// `functions` one-line functions, each with its own parameter and local names
+static std::string unique_names_source(const size_t functions) {
+    std::string src;
+    for (size_t f = 0; f < functions; ++f) {
+        const auto n = std::to_string(f);
+        src += "int f" + n + "(int p" + n + ") { int v" + n + " = p" + n + "; return v" + n + "; }\n";
+    }
+    src += "int main() {\n  return 0;\n}\n";
+    return src;
+}
+
+int main(int argc, char *argv[]) {
+    const size_t iterations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10;
+    const auto &parser = grammar::SLRParser::shared();
+
+    std::cout << std::fixed << std::setprecision(3);
+    for (const size_t depth: {1, 16, 64, 256}) {
+        lexer::Lexer lexer{nested_source(20, depth, 400)};
+        const auto result = parser.parse(post_process(lexer.tokenize()));
+        if (!result.success) {
+            std::cerr << "parse failed" << std::endl;
+            return 1;
+        }
+        const double codegen_ms = bench::time_ms(iterations, [&] {
+            bench::do_not_optimize(ir::IRGenerator::generate(result.program).module);
+        });
+        std::cout << "depth: " << std::setw(4) << depth
+                << "  codegen: " << std::setw(9) << codegen_ms << " ms\n";
+    }
+    for (const size_t functions: {2048, 16384}) {
+        lexer::Lexer lexer{unique_names_source(functions)};
+        const auto result = parser.parse(post_process(lexer.tokenize()));
+        if (!result.success) {
+            std::cerr << "parse failed" << std::endl;
+            return 1;
+        }
+        const double codegen_ms = bench::time_ms(iterations, [&] {
+            bench::do_not_optimize(ir::IRGenerator::generate(result.program).module);
+        });
+        std::cout << "unique names: " << std::setw(6) << functions
+                << "  codegen: " << std::setw(9) << codegen_ms << " ms\n";
+    }
+    return 0;
+}
@@ -9,6 +9,7 @@
 #define SYSYC_BASICBLOCK_H
 
 #include "Function.h"
+#include "IList.h"
 #include "Instruction.h"
 #include "Module.h"
 #include "Value.h"
@@ -29,9 +30,11 @@ class BasicBlock : public Value {
 private:
   std::list<BasicBlock *> pre_bbs_;     //!<  pre basic blocks
   std::list<BasicBlock *> succ_bbs_;    //!<  subsequence basic blocks
-  std::list<Instruction *> instr_list_; //!<  instruction in basic block
+  IList<Instruction> instr_list_;       //!<  instruction in basic block
   Function *parent_;                    //!<  belong to which function
   bool _fake;                           //!<  is fake basicblock
+  IListHook<BasicBlock> hook_;          //!<  所属函数基本块链表中的前后块
+  template <typename> friend class IList;
 
 public:
   /*!
@@ -59,7 +62,7 @@ public:
   static BasicBlock *create(Module *m, const std::string &name,
                             Function *parent, bool fake = false) {
     auto prefix = name.empty() ? "" : "label_";
-    return new BasicBlock(m, prefix + name, parent, fake);
+    return new (m) BasicBlock(m, prefix + name, parent, fake);
   }
 
   /*!
@@ -284,8 +287,9 @@ public:
    *@return 指令指针链表引用
    *@note
    *----------
+   *侵入式链表，遍历得到指令指针
    */
-  std::list<Instruction *> &get_instructions() { return instr_list_; }
+  IList<Instruction> &get_instructions() { return instr_list_; }
 
   /*!
    *@brief 将基本块从从属的函数中删除
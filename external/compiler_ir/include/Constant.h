@@ -27,8 +27,11 @@ public:
    *@return 自身类对象
    *constant variable
    */
+  /// 常量在模块内唯一化，可被多个函数同时使用
   Constant(Type *ty, const std::string &name = "", unsigned num_ops = 0)
-      : User(ty, name, num_ops) {}
+      : User(ty, name, num_ops) {
+    share_uses();
+  }
   /*!
    *@brief 常量基类析构函数
    *constant variable
@@ -52,7 +55,9 @@ public:
    *@return 自身类对象
    *constant variable
    */
-  ConstantInt(Type *ty, int val) : Constant(ty, "", 0), value_(val) {}
+  ConstantInt(Type *ty, int val) : Constant(ty, "", 0), value_(val) {
+    kind_ = ValueKind::ConstantInt;
+  }
   /*!
    *@brief 获取常量值
    *@param const_val 常量对象指针
@@ -94,7 +99,9 @@ private:
   float value_; /// 初始值
 
 public:
-  ConstantFloat(Type *ty, float val) : Constant(ty, "", 0), value_(val) {}
+  ConstantFloat(Type *ty, float val) : Constant(ty, "", 0), value_(val) {
+    kind_ = ValueKind::ConstantFloat;
+  }
 
   float get_value() const { return value_; }
 
@@ -210,6 +217,7 @@ public:
  */
 class ConstantZero : public Constant {
 private:
+  friend class Module;
   explicit ConstantZero(Type *ty) : Constant(ty, "", 0) {}
 
 public:
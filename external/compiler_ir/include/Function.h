@@ -117,13 +117,13 @@ public:
    *
    * @note 获取管理的基本块链第一个基本块
    */
-  BasicBlock *get_entry_block() { return *basic_blocks_.begin(); }
+  BasicBlock *get_entry_block() { return basic_blocks_.front(); }
   /**
    * @brief Get the basic blocks object，获取基本块链
    *
-   * @return std::list<BasicBlock *>& 基本块链的引用
+   * @return IList<BasicBlock>& 基本块链的引用，遍历得到基本块指针
    */
-  std::list<BasicBlock *> &get_basic_blocks() { return basic_blocks_; }
+  IList<BasicBlock> &get_basic_blocks() { return basic_blocks_; }
   /**
    * @brief Get the args object，获取参数列表
    *
@@ -150,7 +150,7 @@ public:
   std::string print();
 
 private:
-  std::list<BasicBlock *> basic_blocks_; // basic blocks
+  IList<BasicBlock> basic_blocks_;       // basic blocks
   std::list<Argument *> arguments_;      // arguments
   Module *parent_;
   unsigned seq_cnt_;
@@ -200,7 +200,9 @@ public:
    *
    * @return Argument* ，获取新的参数对象指针
    */
-  Argument *deepcopy() { return new Argument(type_, name_, parent_, arg_no_); }
+  Argument *deepcopy() {
+    return new (parent_->get_parent()) Argument(type_, name_, parent_, arg_no_);
+  }
   /**
    * @brief Get the arg no object，获取参数列表参数个数
    *
@@ -0,0 +1,137 @@
+/*!
+ *@file IList.h
+ *@brief 侵入式双向链表接口头文件
+ *@version 1.0.0
+ *@date 2022-10-04
+ */
+
+#ifndef SYSYC_ILIST_H
+#define SYSYC_ILIST_H
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+
+/*! 嵌入在节点对象中的前后指针，节点类以成员hook_持有 */
+template <typename T> struct IListHook {
+  T *prev_ = nullptr;
+  T *next_ = nullptr;
+};
+
+/*!
+ *@brief 侵入式双向链表
+ *@note
+ *---------
+ *链接指针存放在节点自身的hook_中，插入、删除、替换都是O(1)且不分配内存；
+ *遍历得到节点指针，用法与std::list<T *>一致。
+ *一个节点同一时刻只能位于一个链表中，删除节点只使指向它的迭代器失效
+ */
+template <typename T> class IList {
+public:
+  /*! 双向迭代器，解引用得到节点指针 */
+  class iterator {
+  public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = T *;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T **;
+    using reference = T *;
+
+    iterator() = default;
+    iterator(T *node, const IList *list) : node_(node), list_(list) {}
+
+    T *operator*() const { return node_; }
+    iterator &operator++() {
+      node_ = node_->hook_.next_;
+      return *this;
+    }
+    iterator operator++(int) {
+      auto old = *this;
+      ++*this;
+      return old;
+    }
+    /// end()的前一个位置是表尾
+    iterator &operator--() {
+      node_ = node_ ? node_->hook_.prev_ : list_->tail_;
+      return *this;
+    }
+    iterator operator--(int) {
+      auto old = *this;
+      --*this;
+      return old;
+    }
+    bool operator==(const iterator &other) const {
+      return node_ == other.node_;
+    }
+
+  private:
+    T *node_ = nullptr;
+    const IList *list_ = nullptr;
+  };
+
+  IList() = default;
+  IList(const IList &) = delete;
+  IList &operator=(const IList &) = delete;
+
+  iterator begin() const { return {head_, this}; }
+  iterator end() const { return {nullptr, this}; }
+  bool empty() const { return head_ == nullptr; }
+  std::size_t size() const { return size_; }
+  T *front() const { return head_; }
+  T *back() const { return tail_; }
+
+  void push_back(T *node) { insert(end(), node); }
+  void push_front(T *node) { insert(begin(), node); }
+
+  /*!
+   *@brief 在pos之前插入节点
+   *@param pos 插入位置
+   *@param node 不在任何链表中的节点
+   *@return 指向node的迭代器
+   */
+  iterator insert(iterator pos, T *node) {
+    T *next = *pos;
+    T *prev = next ? next->hook_.prev_ : tail_;
+    node->hook_.prev_ = prev;
+    node->hook_.next_ = next;
+    (prev ? prev->hook_.next_ : head_) = node;
+    (next ? next->hook_.prev_ : tail_) = node;
+    ++size_;
+    return {node, this};
+  }
+
+  /*!
+   *@brief 从链表中摘下节点
+   *@param node 位于本链表中的节点
+   */
+  void erase(T *node) {
+    T *prev = node->hook_.prev_;
+    T *next = node->hook_.next_;
+    assert((prev ? prev->hook_.next_ : head_) == node && "node not in list");
+    (prev ? prev->hook_.next_ : head_) = next;
+    (next ? next->hook_.prev_ : tail_) = prev;
+    node->hook_ = {};
+    --size_;
+  }
+
+  /*!
+   *@brief 让node占据old在链表中的位置，old被摘下
+   *@param old 位于本链表中的节点
+   *@param node 不在任何链表中的节点
+   */
+  void replace(T *old, T *node) {
+    T *prev = old->hook_.prev_;
+    T *next = old->hook_.next_;
+    node->hook_ = old->hook_;
+    (prev ? prev->hook_.next_ : head_) = node;
+    (next ? next->hook_.prev_ : tail_) = node;
+    old->hook_ = {};
+  }
+
+private:
+  T *head_ = nullptr;
+  T *tail_ = nullptr;
+  std::size_t size_ = 0;
+};
+
+#endif // SYSYC_ILIST_H
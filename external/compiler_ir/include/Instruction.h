@@ -64,14 +64,12 @@ public:
   ///              维护一个基本块内的指令关系链，用于优化处理
 
 private:
-  Instruction *_prev_inst = nullptr;
-  Instruction *_next_inst = nullptr;
+  template <typename> friend class IList;
+  IListHook<Instruction> hook_; // 所属基本块指令链表中的前后指令
 
 public:
-  Instruction *getPrevInst() const { return _prev_inst; }
-  Instruction *getSuccInst() const { return _next_inst; }
-  void setPrevInst(Instruction *inst) { _prev_inst = inst; }
-  void setSuccInst(Instruction *inst) { _next_inst = inst; }
+  Instruction *getPrevInst() const { return hook_.prev_; }
+  Instruction *getSuccInst() const { return hook_.next_; }
 
   /// ============= INLINE OPTIMIZATION HELPER FUNCTIONS ==============
 
@@ -79,26 +77,8 @@ public:
   virtual Instruction *deepcopy(BasicBlock *parent) = 0;
   // 利用map映射替换指令内部所有指针到新值
   virtual void transplant(std::map<Value *, Value *> ptMap) {
-    // 替换UseList
-    auto it = use_list_.begin();
-    auto ite = use_list_.end();
-    while (it != ite) {
-      auto u = *it;
-      if (ptMap.find(u.val_) != ptMap.end()) {
-        *it = Use(ptMap[u.val_], u.arg_no_);
-      }
-      it++;
-    }
-    // 替换Operands
-    auto it1 = operands_.begin();
-    auto ite1 = operands_.end();
-    while (it1 != ite1) {
-      auto o = *it1;
-      if (ptMap.find(o) != ptMap.end()) {
-        *it1 = ptMap[o];
-      }
-      it1++;
-    }
+    // 替换Operands，use list随之更新
+    transplant_operands(ptMap);
   };
 
   /// ============= INLINE OPTIMIZATION HELPER FUNCTIONS ==============
@@ -264,17 +244,9 @@ public:
 
   virtual BinaryInst *deepcopy(BasicBlock *parent) override {
     // 复制基本信息
-    BinaryInst *newInst = new BinaryInst(type_, op_id_, parent);
-    // 复制UseList
-    newInst->use_list_.clear();
-    for (auto u : use_list_) {
-      newInst->use_list_.push_back(u);
-    }
-    // 复制Operands
-    newInst->operands_.clear();
-    for (auto o : operands_) {
-      newInst->operands_.push_back(o);
-    }
+    BinaryInst *newInst = new (get_module()) BinaryInst(type_, op_id_, parent);
+    // 复制Operands，新指令登记到各操作数的use list中
+    newInst->copy_operands(this);
     return newInst;
   };
 
@@ -316,17 +288,9 @@ public:
 
   virtual CmpInst *deepcopy(BasicBlock *parent) override {
     // 复制基本信息
-    CmpInst *newInst = new CmpInst(type_, cmp_op_, parent);
-    // 复制UseList
-    newInst->use_list_.clear();
-    for (auto u : use_list_) {
-      newInst->use_list_.push_back(u);
-    }
-    // 复制Operands
-    newInst->operands_.clear();
-    for (auto o : operands_) {
-      newInst->operands_.push_back(o);
-    }
+    CmpInst *newInst = new (get_module()) CmpInst(type_, cmp_op_, parent);
+    // 复制Operands，新指令登记到各操作数的use list中
+    newInst->copy_operands(this);
     return newInst;
   };
 
@@ -354,40 +318,15 @@ public:
 
   virtual CallInst *deepcopy(BasicBlock *parent) override {
     // 复制基本信息
-    CallInst *newInst = new CallInst(type_, operands_.size(), parent);
-    // 复制UseList
-    newInst->use_list_.clear();
-    for (auto u : use_list_) {
-      newInst->use_list_.push_back(u);
-    }
-    // 复制Operands
-    newInst->operands_.clear();
-    for (auto o : operands_) {
-      newInst->operands_.push_back(o);
-    }
+    CallInst *newInst = new (get_module()) CallInst(type_, operands_.size(), parent);
+    // 复制Operands，新指令登记到各操作数的use list中
+    newInst->copy_operands(this);
     return newInst;
   };
 
   virtual void transplant(std::map<Value *, Value *> ptMap) override {
-    // 替换UseList
-    auto it = use_list_.begin();
-    auto ite = use_list_.end();
-    while (it != ite) {
-      auto u = *it;
-      if (ptMap.find(u.val_) != ptMap.end()) {
-        *it = Use(ptMap[u.val_], u.arg_no_);
-      }
-    }
     // 替换Operands，跳过第一个。第一个为函数指针，无需处理
-    auto it1 = operands_.begin();
-    auto ite1 = operands_.end();
-    it1++;
-    while (it1 != ite1) {
-      auto o = *it1;
-      if (ptMap.find(o) != ptMap.end()) {
-        *it1 = ptMap[o];
-      }
-    }
+    transplant_operands(ptMap, 1);
   };
 };
 
@@ -417,17 +356,9 @@ public:
 
   virtual BranchInst *deepcopy(BasicBlock *parent) override {
     // 复制基本信息
-    BranchInst *newInst = new BranchInst(num_ops_, parent);
-    // 复制UseList
-    newInst->use_list_.clear();
-    for (auto u : use_list_) {
-      newInst->use_list_.push_back(u);
-    }
-    // 复制Operands
-    newInst->operands_.clear();
-    for (auto o : operands_) {
-      newInst->operands_.push_back(o);
-    }
+    BranchInst *newInst = new (get_module()) BranchInst(num_ops_, parent);
+    // 复制Operands，新指令登记到各操作数的use list中
+    newInst->copy_operands(this);
     return newInst;
   };
 };
@@ -447,17 +378,9 @@ public:
 
   virtual ReturnInst *deepcopy(BasicBlock *parent) override {
     // 复制基本信息
-    ReturnInst *newInst = new ReturnInst(parent, num_ops_);
-    // 复制UseList
-    newInst->use_list_.clear();
-    for (auto u : use_list_) {
-      newInst->use_list_.push_back(u);
-    }
-    // 复制Operands
-    newInst->operands_.clear();
-    for (auto o : operands_) {
-      newInst->operands_.push_back(o);
-    }
+    ReturnInst *newInst = new (get_module()) ReturnInst(parent, num_ops_);
+    // 复制Operands，新指令登记到各操作数的use list中
+    newInst->copy_operands(this);
     return newInst;
   };
 };
@@ -480,17 +403,9 @@ public:
   virtual GetElementPtrInst *deepcopy(BasicBlock *parent) override {
     // 复制基本信息
     GetElementPtrInst *newInst =
-        new GetElementPtrInst(element_ty_, num_ops_, parent);
-    // 复制UseList
-    newInst->use_list_.clear();
-    for (auto u : use_list_) {
-      newInst->use_list_.push_back(u);
-    }
-    // 复制Operands
-    newInst->operands_.clear();
-    for (auto o : operands_) {
-      newInst->operands_.push_back(o);
-    }
+        new (get_module()) GetElementPtrInst(element_ty_, num_ops_, parent);
+    // 复制Operands，新指令登记到各操作数的use list中
+    newInst->copy_operands(this);
     return newInst;
   };
 
@@ -513,17 +428,9 @@ public:
 
   virtual StoreInst *deepcopy(BasicBlock *parent) override {
     // 复制基本信息
-    StoreInst *newInst = new StoreInst(parent);
-    // 复制UseList
-    newInst->use_list_.clear();
-    for (auto u : use_list_) {
-      newInst->use_list_.push_back(u);
-    }
-    // 复制Operands
-    newInst->operands_.clear();
-    for (auto o : operands_) {
-      newInst->operands_.push_back(o);
-    }
+    StoreInst *newInst = new (get_module()) StoreInst(parent);
+    // 复制Operands，新指令登记到各操作数的use list中
+    newInst->copy_operands(this);
     return newInst;
   };
 };
@@ -544,17 +451,9 @@ public:
 
   virtual LoadInst *deepcopy(BasicBlock *parent) override {
     // 复制基本信息
-    LoadInst *newInst = new LoadInst(type_, parent);
-    // 复制UseList
-    newInst->use_list_.clear();
-    for (auto u : use_list_) {
-      newInst->use_list_.push_back(u);
-    }
-    // 复制Operands
-    newInst->operands_.clear();
-    for (auto o : operands_) {
-      newInst->operands_.push_back(o);
-    }
+    LoadInst *newInst = new (get_module()) LoadInst(type_, parent);
+    // 复制Operands，新指令登记到各操作数的use list中
+    newInst->copy_operands(this);
     return newInst;
   };
 };
@@ -572,13 +471,7 @@ public:
 
   virtual AllocaInst *deepcopy(BasicBlock *parent) override {
     // 复制基本信息
-    AllocaInst *newInst = new AllocaInst(alloca_ty_, parent);
-    // 复制UseList
-    newInst->use_list_.clear();
-    for (auto u : use_list_) {
-      newInst->use_list_.push_back(u);
-    }
-    newInst->operands_.clear();
+    AllocaInst *newInst = new (get_module()) AllocaInst(alloca_ty_, parent);
     return newInst;
   };
   void set_init() { init = true; }
@@ -607,17 +500,9 @@ public:
 
   virtual ZextInst *deepcopy(BasicBlock *parent) override {
     // 复制基本信息
-    ZextInst *newInst = new ZextInst(type_, parent);
-    // 复制UseList
-    newInst->use_list_.clear();
-    for (auto u : use_list_) {
-      newInst->use_list_.push_back(u);
-    }
-    // 复制Operands
-    newInst->operands_.clear();
-    for (auto o : operands_) {
-      newInst->operands_.push_back(o);
-    }
+    ZextInst *newInst = new (get_module()) ZextInst(type_, parent);
+    // 复制Operands，新指令登记到各操作数的use list中
+    newInst->copy_operands(this);
     return newInst;
   };
 
@@ -653,40 +538,16 @@ public:
 
   virtual PhiInst *deepcopy(BasicBlock *parent) override {
     // 复制基本信息
-    PhiInst *newInst = new PhiInst(type_, num_ops_, parent);
+    PhiInst *newInst = new (get_module()) PhiInst(type_, num_ops_, parent);
     newInst->l_val_ = l_val_;
-    // 复制UseList
-    newInst->use_list_.clear();
-    for (auto u : use_list_) {
-      newInst->use_list_.push_back(u);
-    }
-    // 复制Operands
-    newInst->operands_.clear();
-    for (auto o : operands_) {
-      newInst->operands_.push_back(o);
-    }
+    // 复制Operands，新指令登记到各操作数的use list中
+    newInst->copy_operands(this);
     return newInst;
   };
 
   virtual void transplant(std::map<Value *, Value *> ptMap) override {
-    // 替换UseList
-    auto it = use_list_.begin();
-    auto ite = use_list_.end();
-    while (it != ite) {
-      auto u = *it;
-      if (ptMap.find(u.val_) != ptMap.end()) {
-        *it = Use(ptMap[u.val_], u.arg_no_);
-      }
-    }
-    // 替换Operands
-    auto it1 = operands_.begin();
-    auto ite1 = operands_.end();
-    while (it1 != ite1) {
-      auto o = *it1;
-      if (ptMap.find(o) != ptMap.end()) {
-        *it1 = ptMap[o];
-      }
-    }
+    // 替换Operands，use list随之更新
+    transplant_operands(ptMap);
     // 替换lval
     if (ptMap.find(l_val_) != ptMap.end())
       l_val_ = ptMap[l_val_];
@@ -8,9 +8,14 @@
 #ifndef SYSYC_MODULE_H
 #define SYSYC_MODULE_H
 
+#include <cstdint>
 #include <list>
 #include <map>
+#include <memory_resource>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "Function.h"
 #include "GlobalVariable.h"
@@ -19,6 +24,9 @@
 #include "Value.h"
 
 class GlobalVariable;
+class ConstantInt;
+class ConstantFloat;
+class ConstantZero;
 
 /**
  * @brief 模块类，中间结构的大类
@@ -26,6 +34,17 @@ class GlobalVariable;
  */
 class Module {
 private:
+  /// @brief 模块的所有类型和value都分配在这个内存池中，模块析构时一次释放
+  std::pmr::monotonic_buffer_resource arena_;
+  /// @brief 按创建顺序登记的对象，析构时逆序调用其析构函数。
+  /// 类层次均为单继承且根类有虚函数，对象首地址即为Value/Type子对象
+  std::vector<Value *> values_;
+  std::vector<Type *> types_;
+  /// @brief 函数体可在多个线程上并发生成，分配需加锁
+  std::mutex arena_mutex_;
+  /// @brief 是否正由多个线程并发生成函数体；为false时下列各锁都不获取
+  bool concurrent_{false};
+
   /// @brief 各基础类型指针
   IntegerType *int1_ty_;
   IntegerType *int32_ty_;
@@ -36,6 +55,19 @@ private:
   /// @brief 指针映射图和数组映射图
   std::map<Type *, PointerType *> pointer_map_;
   std::map<std::pair<Type *, int>, ArrayType *> array_map_;
+  /// @brief 保护上面两个映射图，函数体可在多个线程上并发生成
+  std::mutex type_mutex_;
+
+  /// @brief 常量唯一化表：相同的常量共享同一个对象，由模块统一释放
+  std::unordered_map<int, ConstantInt *> int_constants_;
+  ConstantInt *bool_constants_[2]{};
+  /// 以位模式为键，-0.0 与 0.0 是不同的常量
+  std::unordered_map<uint32_t, ConstantFloat *> float_constants_;
+  std::map<Type *, ConstantZero *> zero_constants_;
+  std::mutex constant_mutex_;
+  /// @brief 保护本模块中被共享value（常量、全局变量、函数）的use list，
+  /// 多个函数体可同时引用它们
+  std::mutex use_mutex_;
 
   /// @brief 全局变量列表
   /// The Global Variables in the module
@@ -64,6 +96,65 @@ public:
    */
   ~Module();
 
+  Module(const Module &) = delete;
+  Module &operator=(const Module &) = delete;
+
+  /**
+   * @brief 为value分配内存并登记，由Value::operator new调用
+   *
+   * @param size 对象大小
+   * @return void* 对象内存
+   */
+  void *allocate_value(std::size_t size);
+  /**
+   * @brief 为类型分配内存并登记，由Type::operator new调用
+   *
+   * @param size 对象大小
+   * @return void* 对象内存
+   */
+  void *allocate_type(std::size_t size);
+  /**
+   * @brief 撤销未构造成功的value的登记
+   *
+   * @param p 对象内存
+   */
+  void discard_value(void *p);
+  /**
+   * @brief 撤销未构造成功的类型的登记
+   *
+   * @param p 对象内存
+   */
+  void discard_type(void *p);
+  /**
+   * @brief 已分配的对象数，用于检查模块是否持有全部IR对象
+   *
+   * @return std::size_t 类型和value的总数
+   */
+  std::size_t num_objects();
+  /**
+   * @brief 设置是否由多个线程并发生成函数体，只能在没有其他线程使用本模块时调用
+   *
+   * @param on 并发生成期间为true，单线程生成时为false
+   */
+  void set_concurrent(bool on) { concurrent_ = on; }
+  /**
+   * @brief 并发生成时获取锁m，单线程时返回不持有锁的unique_lock
+   *
+   * @param m 要获取的锁
+   * @return std::unique_lock<std::mutex> 作用域内持有的锁
+   */
+  std::unique_lock<std::mutex> lock_if_concurrent(std::mutex &m) {
+    return concurrent_ ? std::unique_lock(m) : std::unique_lock<std::mutex>();
+  }
+  /**
+   * @brief 获取保护共享use list的锁，仅在并发生成时实际加锁
+   *
+   * @return std::unique_lock<std::mutex> 作用域内持有的锁
+   */
+  std::unique_lock<std::mutex> lock_uses() {
+    return lock_if_concurrent(use_mutex_);
+  }
+
   /**
    * @brief Get the void type object，获取一个构建好的void类型指针
    *
@@ -121,6 +212,34 @@ public:
    * @return ArrayType*
    */
   ArrayType *get_array_type(Type *contained, unsigned num_elements);
+  /**
+   * @brief 获取值为val的i32常量，相同的值返回同一个对象
+   *
+   * @param val 常量值
+   * @return ConstantInt*
+   */
+  ConstantInt *get_int_constant(int val);
+  /**
+   * @brief 获取i1常量 true/false，每个模块各只有一个
+   *
+   * @param val 常量值
+   * @return ConstantInt*
+   */
+  ConstantInt *get_bool_constant(bool val);
+  /**
+   * @brief 获取float常量，位模式相同的值返回同一个对象
+   *
+   * @param val 常量值
+   * @return ConstantFloat*
+   */
+  ConstantFloat *get_float_constant(float val);
+  /**
+   * @brief 获取类型ty的零初始化常量，每种类型一个
+   *
+   * @param ty 常量类型
+   * @return ConstantZero*
+   */
+  ConstantZero *get_zero_constant(Type *ty);
   /**
    * @brief 添加函数
    *
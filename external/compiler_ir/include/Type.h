@@ -8,6 +8,7 @@
 #ifndef SYSYC_TYPE_H
 #define SYSYC_TYPE_H
 
+#include <cstddef>
 #include <iostream>
 #include <vector>
 
@@ -45,6 +46,13 @@ private:
   Module *m_;
   virtual void _t(){};
 
+protected:
+  /**
+   * @brief 内存归所属模块，不能单独delete，仅为虚析构函数提供
+   *
+   */
+  static void operator delete(void *) {}
+
 public:
   /**
    * @brief Construct a new Type object
@@ -59,6 +67,20 @@ public:
    */
   virtual ~Type() = default;
 
+  /**
+   * @brief 在模块m的内存池中创建类型：new (m) ArrayType(...)
+   *
+   * @param size 对象大小
+   * @param m 所属模块，模块析构时释放该类型
+   * @return void* 对象内存
+   */
+  static void *operator new(std::size_t size, Module *m);
+  /**
+   * @brief 构造函数抛出异常时撤销登记
+   *
+   */
+  static void operator delete(void *p, Module *m);
+
   /**
    * @brief Get the type id object，获取类型ID
    *
@@ -9,14 +9,29 @@
 #define SYSYC_USER_H
 
 #include "Value.h"
+#include <map>
 #include <vector>
 
 /*! user类，中间IR的基础*/
 class User : public Value {
 private:
 protected:
-  std::vector<Value *> operands_; // operands of this value
-  unsigned num_ops_;              // value值的个数
+  std::vector<Use> operands_; // operands of this value，即各操作数的use
+  unsigned num_ops_;          // value值的个数
+
+  /*!
+   *@brief 深拷贝时复制from的全部操作数，并在各操作数的use list中登记
+   *@param from 被复制的User，操作数个数与本对象相同
+   */
+  void copy_operands(User *from);
+
+  /*!
+   *@brief 按映射替换操作数，use list随之更新
+   *@param ptMap 旧value到新value的映射
+   *@param first 从第几个操作数开始替换
+   */
+  void transplant_operands(const std::map<Value *, Value *> &ptMap,
+                           unsigned first = 0);
 
 public:
   /*!
@@ -35,9 +50,9 @@ public:
 
   /*!
    *@brief 获得包含value指针的数组
-   *@return 返回User维护的Value数组
+   *@return 各操作数的副本，修改操作数需通过set_operand
    */
-  std::vector<Value *> &get_operands();
+  std::vector<Value *> get_operands() const;
 
   /*!
    *@brief 获得数组中的第i个value数值指针
@@ -74,11 +89,7 @@ public:
   unsigned get_num_operand() const;
 
   /*!
-   *@brief 添加新的value数值指针
-   *@param v value数值指针
-   *@note
-   *--------
-   *
+   *@brief 将本User从各操作数的use list中摘下，操作数保持不变
    */
   void remove_use_of_ops();
 
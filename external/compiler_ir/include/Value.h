@@ -8,18 +8,51 @@
 #ifndef SYSYC_VALUE_H
 #define SYSYC_VALUE_H
 
+#include <cstddef>
 #include <iostream>
-#include <list>
 #include <string>
 
+#include "IList.h"
+
+class Module;
 class Type;
 class Value;
 
-/*! use结构体，作为中间IR的基础*/
+/*! value的具体种类标签，热点路径据此判断而不必使用RTTI */
+enum class ValueKind : unsigned char { Other, ConstantInt, ConstantFloat };
+
+/*!
+ *@brief use结构体，作为中间IR的基础
+ *@note
+ *---------
+ *每个use即User的一个操作数槽位，同时是被使用value的use list中的节点，
+ *设置、替换、删除操作数都是O(1)且不分配内存。
+ *use随User的操作数数组移动时会在use list中接替原位置
+ */
 struct Use {
-  Value *val_;      // 使用value的value
-  unsigned arg_no_; // the no. of operand, e.g., func(a, b), a is 0, b is 1
+  Value *val_;             // 使用value的value
+  unsigned arg_no_;        // the no. of operand, e.g., func(a, b), a is 0, b is 1
+  bool linked_ = false;    // 是否位于value_的use list中
+  Value *value_ = nullptr; // 操作数，即被使用的value
+  IListHook<Use> hook_;    // use list中的前后节点
+
   Use(Value *val, unsigned no) : val_(val), arg_no_(no) {} // 构造函数
+  Use(const Use &) = delete;
+  Use &operator=(const Use &) = delete;
+  Use(Use &&other) noexcept;
+  Use &operator=(Use &&other) noexcept;
+  ~Use();
+
+  /*!
+   *@brief 将操作数改为v，从原value的use list移到v的use list
+   *@param v 新的操作数，可以为空
+   */
+  void set(Value *v);
+
+  /*!
+   *@brief 从value_的use list中摘下，操作数本身保持不变
+   */
+  void unlink();
 
   /*!
    *@brief 判定两个use是否相等
@@ -37,8 +70,43 @@ class Value {
 private:
 protected:
   Type *type_;
-  std::list<Use> use_list_; // 使用value的value list
+  IList<Use> use_list_;     // 使用value的value list
   std::string name_;        // value名称
+  bool shared_uses_{false}; // use list 由多个函数并发修改
+  ValueKind kind_{ValueKind::Other}; // 由具体子类构造时设置
+
+  /*!
+   *@brief 标记该value可被多个函数同时使用（全局变量、函数），
+   *       其use list的修改需持有所属模块的use list锁
+   */
+  void share_uses() { shared_uses_ = true; }
+
+  /*!
+   *@brief 内存归所属模块，不能单独delete，仅为虚析构函数提供
+   */
+  static void operator delete(void *) {}
+
+private:
+  friend struct Use;
+
+  /*!
+   *@brief 将use挂到use list尾部
+   *@param use 使用该value的操作数
+   */
+  void add_use(Use *use);
+
+  /*!
+   *@brief 从use list中摘下use
+   *@param use 使用该value的操作数
+   */
+  void remove_use(Use *use);
+
+  /*!
+   *@brief 操作数移动后，新位置now接替old在use list中的位置
+   *@param old 原操作数
+   *@param now 新操作数
+   */
+  void replace_use(Use *old, Use *now);
 
 public:
   /*!
@@ -49,9 +117,24 @@ public:
    */
   explicit Value(Type *ty, const std::string &name = "");
   /*!
-   *@brief Value的析构函数
+   *@brief Value的析构函数，由所属模块析构时统一调用
+   *@note
+   *---------
+   *仍在使用该value的操作数被置为未链接，之后析构其User时不再访问本对象
    */
-  ~Value() = default;
+  virtual ~Value();
+
+  /*!
+   *@brief 在模块m的内存池中创建value：new (m) Inst(...)
+   *@param size 对象大小
+   *@param m 所属模块，模块析构时释放该对象
+   *@return 对象内存
+   */
+  static void *operator new(std::size_t size, Module *m);
+  /*!
+   *@brief 构造函数抛出异常时撤销登记
+   */
+  static void operator delete(void *p, Module *m);
 
   /*!
    *@brief 获取value的类型
@@ -60,17 +143,16 @@ public:
   Type *get_type() const { return type_; }
 
   /*!
-   *@brief 获取使用该value的use list
-   *@return 返回use-list的引用
+   *@brief 获取value的种类标签
+   *@return 标签，未单独标记的子类均为Other
    */
-  std::list<Use> &get_use_list() { return use_list_; }
+  ValueKind get_value_kind() const { return kind_; }
 
   /*!
-   *@brief 添加use
-   *@param val 使用该value的value
-   *@param arg_no 在指令中的顺序
+   *@brief 获取使用该value的use list，遍历得到Use指针
+   *@return 返回use-list的引用
    */
-  void add_use(Value *val, unsigned arg_no = 0);
+  IList<Use> &get_use_list() { return use_list_; }
 
   /*!
    *@brief 对于value设置名称
@@ -103,15 +185,6 @@ public:
    */
   void replace_all_use_with(Value *new_val);
 
-  /*!
-   *@brief 替换所有对于旧value的引用，改为新的
-   *@param val value型指针
-   *@note
-   *----------
-   *支持对于指令级别value的替换
-   */
-  void remove_use(Value *val);
-
   /*!
    *@brief value的打印
    *@return 默认为空
@@ -36,24 +36,9 @@ BasicBlock::BasicBlock(Module *m, const std::string &name = "",
  *@param 待添加的指令指针
  *@note
  *----------
- *在基本块的尾部添加指令
- *&emsp; 设置待添加的指令后缀为空
- *&emsp; **if** 如果指令链表为空
- *&emsp;&emsp; 设置指令为后继为空
- *&emsp;&emsp; 不为空，则获取指令链表的最后一个指令
- *&emsp;&emsp; 设置插入指令的前继为最后一个指令
- *&emsp;&emsp; 最后一个指令后继为待插入指令
- *&emsp; 尾部插入指令
+ *在基本块的尾部添加指令，指令自带链表指针，无需分配
  */
 void BasicBlock::add_instruction(Instruction *instr) {
-  instr->setSuccInst(nullptr);
-  if (instr_list_.empty()) {
-    instr->setSuccInst(nullptr);
-  } else {
-    Instruction *last_inst = instr_list_.back();
-    instr->setPrevInst(last_inst);
-    last_inst->setSuccInst(instr);
-  }
   instr_list_.push_back(instr);
 }
 
@@ -80,23 +65,8 @@ void BasicBlock::add_instruction(Instruction *instr) {
  *@note
  *----------
  *在基本块的头部添加指令
- *&emsp; 设置待添加的指令前继为空
- *&emsp; **if** 如果指令链表为空
- *&emsp;&emsp; 设置指令为后继为空
- *&emsp;&emsp; 不为空，则获取指令链表的第一个指令
- *&emsp;&emsp; 设置插入指令的后继为第一个指令
- *&emsp;&emsp; 第一个指令前继为待插入指令
- *&emsp; 头部插入指令
  */
 void BasicBlock::add_instr_begin(Instruction *instr) {
-  instr->setPrevInst(nullptr);
-  if (instr_list_.empty()) {
-    instr->setSuccInst(nullptr);
-  } else {
-    Instruction *first_inst = instr_list_.front();
-    instr->setSuccInst(first_inst);
-    first_inst->setPrevInst(instr);
-  }
   instr_list_.push_front(instr);
 }
 
@@ -109,9 +79,7 @@ void BasicBlock::add_instr_begin(Instruction *instr) {
  *&emsp; 设置指令的从属基本块
  *&emsp; 获取指令链表的开始
  *&emsp;&emsp; **for** 循环，遍历获得phi指令点
- *&emsp; **if** 如果不是链表头，phi节点前继为节点前继
- *&emsp; **if** 如果不是链表尾，phi节点后继设置为节点本身
- *&emsp; 修正插入节点的连接关系，前继和后继的修改
+ *&emsp; 在第一条非phi指令之前插入
  */
 void BasicBlock::add_instr_after_phi(Instruction *instr) {
   instr->set_parent(this);
@@ -122,24 +90,6 @@ void BasicBlock::add_instr_after_phi(Instruction *instr) {
       break;
     }
   }
-  //获取插入点
-  Instruction *front = nullptr, *back = nullptr;
-  if (it != instr_list_.begin()) {
-    front = *(--it);
-    ++it;
-  }
-  if (it != instr_list_.end()) {
-    back = *it;
-  }
-  if (front != nullptr) {
-    front->setSuccInst(instr);
-  }
-  if (back != nullptr) {
-    back->setPrevInst(instr);
-  }
-  // 设置待插入节点的前后继
-  instr->setPrevInst(front);
-  instr->setSuccInst(back);
   instr_list_.insert(it, instr);
 }
 
@@ -148,26 +98,11 @@ void BasicBlock::add_instr_after_phi(Instruction *instr) {
  *@param 待删除的指令指针
  *@note
  *----------
- *&emsp; 删除维护的指令链表中的指令
- *&emsp; 获取删除的指令的前后指令
- *&emsp; 修正指令的链接关系：
- *&emsp; **if** 如果前置指令不为空
- *&emsp;&emsp; 为前置指令设置新的后置指令
- *&emsp; **if** 如果后置指令不为空
- *&emsp;&emsp; 为后置指令设置新的前置指令
+ *&emsp; 从指令链表中摘下该指令，O(1)
  *&emsp; 被删除的指令进行相关use的删除
  */
 void BasicBlock::delete_instr(Instruction *instr) {
-  instr_list_.remove(instr);
-  Instruction *prev = instr->getPrevInst();
-  Instruction *succ = instr->getSuccInst();
-  //修正指令的链接关系
-  if (prev != nullptr) {
-    prev->setSuccInst(succ);
-  }
-  if (succ != nullptr) {
-    succ->setPrevInst(prev);
-  }
+  instr_list_.erase(instr);
   //被删除的指令进行相关use的删除
   instr->remove_use_of_ops();
 }
@@ -14,29 +14,29 @@
  *@brief 常量整数类32位创建函数
  *@param val 常量值
  *@param m 所属模块
- *@return 常量类对象指针
+ *@return 常量类对象指针，相同的值在模块内共享同一个对象
  */
 ConstantInt *ConstantInt::get(int val, Module *m) {
-  return new ConstantInt(Type::get_int32_type(m), val);
+  return m->get_int_constant(val);
 }
 /*!
  *@brief 常量整数类1位创建函数
  *@param val 常量值
  *@param m 所属模块
- *@return 常量类对象指针
+ *@return 常量类对象指针，相同的值在模块内共享同一个对象
  */
 ConstantInt *ConstantInt::get(bool val, Module *m) {
-  return new ConstantInt(Type::get_int1_type(m), val ? 1 : 0);
+  return m->get_bool_constant(val);
 }
 
 /*!
  *@brief 常量浮点创建函数
  *@param val 常量值
  *@param m 所属模块
- *@return 常量类对象指针
+ *@return 常量类对象指针，相同的值在模块内共享同一个对象
  */
 ConstantFloat *ConstantFloat::get(float val, Module *m) {
-  return new ConstantFloat(Type::get_float_type(m), val);
+  return m->get_float_constant(val);
 }
 
 /*!
@@ -108,7 +108,7 @@ Constant *ConstantArray::get_element_value(int index) {
  */
 ConstantArray *ConstantArray::get(ArrayType *ty,
                                   const std::vector<Constant *> &val) {
-  return new ConstantArray(ty, val);
+  return new (ty->get_module()) ConstantArray(ty, val);
 }
 /*!
  *@brief 常量数组类打印函数
@@ -137,7 +137,7 @@ std::string ConstantArray::print() {
  *constant int zero
  */
 ConstantZero *ConstantZero::get(Type *ty, Module *m) {
-  return new ConstantZero(ty);
+  return m->get_zero_constant(ty);
 }
 /*!
  *@brief 打印常量零值
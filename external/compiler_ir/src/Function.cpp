@@ -20,10 +20,17 @@
  */
 Function::Function(FunctionType *ty, const std::string &name, Module *parent)
     : Value(ty, name), parent_(parent), seq_cnt_(0) {
+  share_uses();
   parent->add_function(this);
   build_args();
 }
 
+/**
+ * @brief Destroy the Function object，由所属模块析构时调用
+ *
+ */
+Function::~Function() = default;
+
 /**
  * @brief 创建函数对象
  *
@@ -34,7 +41,7 @@ Function::Function(FunctionType *ty, const std::string &name, Module *parent)
  */
 Function *Function::create(FunctionType *ty, const std::string &name,
                            Module *parent) {
-  return new Function(ty, name, parent);
+  return new (parent) Function(ty, name, parent);
 }
 
 /**
@@ -87,10 +94,10 @@ Module *Function::get_parent() const { return parent_; }
  * @note 删除后继基本块中对于该基本块的前继
  */
 void Function::remove(BasicBlock *bb) {
-  basic_blocks_.remove(bb);
+  basic_blocks_.erase(bb);
   std::vector<PhiInst *> phis;
-  for (auto user : bb->get_use_list()) {
-    auto phi = dynamic_cast<PhiInst *>(user.val_);
+  for (auto *use : bb->get_use_list()) {
+    auto phi = dynamic_cast<PhiInst *>(use->val_);
     if (phi != nullptr) {
       phis.push_back(phi);
     }
@@ -120,7 +127,7 @@ void Function::build_args() {
   auto *func_ty = get_function_type();
   unsigned num_args = get_num_of_args();
   for (int i = 0; i < (int)num_args; i++) {
-    arguments_.push_back(new Argument(func_ty->get_param_type(i), "", this, i));
+    arguments_.push_back(new (parent_) Argument(func_ty->get_param_type(i), "", this, i));
   }
 }
 
@@ -23,6 +23,7 @@
 GlobalVariable::GlobalVariable(std::string name, Module *m, Type *ty,
                                bool is_const, Constant *init)
     : User(ty, name, init != nullptr), is_const_(is_const), init_val_(init) {
+  share_uses();
   m->add_global_variable(this);
   if (init) {
     this->set_operand(0, init);
@@ -45,7 +46,7 @@ GlobalVariable::GlobalVariable(std::string name, Module *m, Type *ty,
 GlobalVariable *GlobalVariable::create(std::string name, Module *m, Type *ty,
                                        bool is_const,
                                        Constant *init = nullptr) {
-  return new GlobalVariable(name, m, PointerType::get(ty), is_const, init);
+  return new (m) GlobalVariable(name, m, PointerType::get(ty), is_const, init);
 }
 
 /*!
@@ -62,47 +62,47 @@ void BinaryInst::assertValid()
 
 BinaryInst *BinaryInst::create_add(Value *v1, Value *v2, BasicBlock *bb, Module *m)
 {
-    return new BinaryInst(Type::get_int32_type(m), Instruction::add, v1, v2, bb);
+    return new (m) BinaryInst(Type::get_int32_type(m), Instruction::add, v1, v2, bb);
 }
 
 BinaryInst *BinaryInst::create_sub(Value *v1, Value *v2, BasicBlock *bb, Module *m)
 {
-    return new BinaryInst(Type::get_int32_type(m), Instruction::sub, v1, v2, bb);
+    return new (m) BinaryInst(Type::get_int32_type(m), Instruction::sub, v1, v2, bb);
 }
 
 BinaryInst *BinaryInst::create_mul(Value *v1, Value *v2, BasicBlock *bb, Module *m)
 {
-    return new BinaryInst(Type::get_int32_type(m), Instruction::mul, v1, v2, bb);
+    return new (m) BinaryInst(Type::get_int32_type(m), Instruction::mul, v1, v2, bb);
 }
 
 BinaryInst *BinaryInst::create_sdiv(Value *v1, Value *v2, BasicBlock *bb, Module *m)
 {
-    return new BinaryInst(Type::get_int32_type(m), Instruction::sdiv, v1, v2, bb);
+    return new (m) BinaryInst(Type::get_int32_type(m), Instruction::sdiv, v1, v2, bb);
 }
 
 BinaryInst *BinaryInst::create_mod(Value *v1, Value *v2, BasicBlock *bb, Module *m)
 {
-    return new BinaryInst(Type::get_int32_type(m), Instruction::mod, v1, v2, bb);
+    return new (m) BinaryInst(Type::get_int32_type(m), Instruction::mod, v1, v2, bb);
 }
 
 BinaryInst *BinaryInst::create_fadd(Value *v1, Value *v2, BasicBlock *bb, Module *m)
 {
-    return new BinaryInst(Type::get_float_type(m), Instruction::fadd, v1, v2, bb);
+    return new (m) BinaryInst(Type::get_float_type(m), Instruction::fadd, v1, v2, bb);
 }
 
 BinaryInst *BinaryInst::create_fsub(Value *v1, Value *v2, BasicBlock *bb, Module *m)
 {
-    return new BinaryInst(Type::get_float_type(m), Instruction::fsub, v1, v2, bb);
+    return new (m) BinaryInst(Type::get_float_type(m), Instruction::fsub, v1, v2, bb);
 }
 
 BinaryInst *BinaryInst::create_fmul(Value *v1, Value *v2, BasicBlock *bb, Module *m)
 {
-    return new BinaryInst(Type::get_float_type(m), Instruction::fmul, v1, v2, bb);
+    return new (m) BinaryInst(Type::get_float_type(m), Instruction::fmul, v1, v2, bb);
 }
 
 BinaryInst *BinaryInst::create_fdiv(Value *v1, Value *v2, BasicBlock *bb, Module *m)
 {
-    return new BinaryInst(Type::get_float_type(m), Instruction::fdiv, v1, v2, bb);
+    return new (m) BinaryInst(Type::get_float_type(m), Instruction::fdiv, v1, v2, bb);
 }
 
 bool BinaryInst::isStaticCalculable() {
@@ -158,13 +158,13 @@ int BinaryInst::calculate() {
 
 /*
 UnaryInst *UnaryInst::create_pos(Value *v1, BasicBlock *bb, Module *m){
-    return new UnaryInst(Type::get_int32_type(m),Instruction::pos,v1,bb);
+    return new (m) UnaryInst(Type::get_int32_type(m),Instruction::pos,v1,bb);
 }
 UnaryInst *UnaryInst::create_neg(Value *v1, BasicBlock *bb, Module *m){
-    return new UnaryInst(Type::get_int32_type(m),Instruction::neg,v1,bb);
+    return new (m) UnaryInst(Type::get_int32_type(m),Instruction::neg,v1,bb);
 }
 UnaryInst *UnaryInst::create_rev(Value *v1, BasicBlock *bb, Module *m){
-    return new UnaryInst(Type::get_int32_type(m),Instruction::rev,v1,bb);
+    return new (m) UnaryInst(Type::get_int32_type(m),Instruction::rev,v1,bb);
 }
 
 std::string UnaryInst::print(){
@@ -202,7 +202,7 @@ void CmpInst::assertValid()
 CmpInst *CmpInst::create_cmp(CmpOp op, Value *lhs, Value *rhs, 
                         BasicBlock *bb, Module *m)
 {
-    return new CmpInst(m->get_int1_type(), op, lhs, rhs, bb);
+    return new (m) CmpInst(m->get_int1_type(), op, lhs, rhs, bb);
 }
 
 std::string CmpInst::print()
@@ -272,7 +272,7 @@ CallInst::CallInst(Function *func, std::vector<Value *> args, BasicBlock *bb)
 
 CallInst *CallInst::create(Function *func, std::vector<Value *> args, BasicBlock *bb)
 {
-    return new CallInst(func, args, bb);
+    return new (bb->get_module()) CallInst(func, args, bb);
 }
 
 FunctionType *CallInst::get_function_type() const
@@ -331,14 +331,14 @@ BranchInst *BranchInst::create_cond_br(Value *cond, BasicBlock *if_true, BasicBl
     if_false->add_pre_basic_block(bb);
     bb->add_succ_basic_block(if_false);
     bb->add_succ_basic_block(if_true);
-    return new BranchInst(cond, if_true, if_false, bb);
+    return new (bb->get_module()) BranchInst(cond, if_true, if_false, bb);
 }
 
 BranchInst *BranchInst::create_br(BasicBlock *if_true, BasicBlock *bb)
 {
     if_true->add_pre_basic_block(bb);
     bb->add_succ_basic_block(if_true);
-    return new BranchInst(if_true, bb);
+    return new (bb->get_module()) BranchInst(if_true, bb);
 }
 
 bool BranchInst::is_cond_br() const
@@ -377,12 +377,12 @@ ReturnInst::ReturnInst(BasicBlock *bb)
 
 ReturnInst *ReturnInst::create_ret(Value *val, BasicBlock *bb)
 {
-    return new ReturnInst(val, bb);
+    return new (bb->get_module()) ReturnInst(val, bb);
 }
 
 ReturnInst *ReturnInst::create_void_ret(BasicBlock *bb)
 {
-    return new ReturnInst(bb);
+    return new (bb->get_module()) ReturnInst(bb);
 }
 
 bool ReturnInst::is_void_ret() const
@@ -448,7 +448,7 @@ Type *GetElementPtrInst::get_element_type() const
 
 GetElementPtrInst *GetElementPtrInst::create_gep(Value *ptr, std::vector<Value *> idxs, BasicBlock *bb)
 {
-    return new GetElementPtrInst(ptr, idxs, bb);
+    return new (bb->get_module()) GetElementPtrInst(ptr, idxs, bb);
 }
 
 std::string GetElementPtrInst::print()
@@ -482,7 +482,7 @@ StoreInst::StoreInst(Value *val, Value *ptr, BasicBlock *bb)
 
 StoreInst *StoreInst::create_store(Value *val, Value *ptr, BasicBlock *bb)
 {
-    return new StoreInst(val, ptr, bb);
+    return new (bb->get_module()) StoreInst(val, ptr, bb);
 }
 
 std::string StoreInst::print()
@@ -509,7 +509,7 @@ LoadInst::LoadInst(Type *ty, Value *ptr, BasicBlock *bb)
 
 LoadInst *LoadInst::create_load(Type *ty, Value *ptr, BasicBlock *bb)
 {
-    return new LoadInst(ty, ptr, bb);
+    return new (bb->get_module()) LoadInst(ty, ptr, bb);
 }
 
 Type *LoadInst::get_load_type() const
@@ -542,7 +542,7 @@ AllocaInst::AllocaInst(Type *ty, BasicBlock *bb)
 
 AllocaInst *AllocaInst::create_alloca(Type *ty, BasicBlock *bb)
 {
-    return new AllocaInst(ty, bb);
+    return new (bb->get_module()) AllocaInst(ty, bb);
 }
 Type *AllocaInst::get_alloca_type() const
 {
@@ -570,17 +570,17 @@ ZextInst::ZextInst(OpID op, Value *val, Type *ty, BasicBlock *bb)
 
 ZextInst *ZextInst::create_zext(Value *val, Type *ty, BasicBlock *bb)
 {
-    return new ZextInst(Instruction::zext, val, ty, bb);
+    return new (bb->get_module()) ZextInst(Instruction::zext, val, ty, bb);
 }
 
 ZextInst *ZextInst::create_sitofp(Value *val, Type *ty, BasicBlock *bb)
 {
-    return new ZextInst(Instruction::sitofp, val, ty, bb);
+    return new (bb->get_module()) ZextInst(Instruction::sitofp, val, ty, bb);
 }
 
 ZextInst *ZextInst::create_fptosi(Value *val, Type *ty, BasicBlock *bb)
 {
-    return new ZextInst(Instruction::fptosi, val, ty, bb);
+    return new (bb->get_module()) ZextInst(Instruction::fptosi, val, ty, bb);
 }
 
 Type *ZextInst::get_dest_type() const
@@ -619,7 +619,7 @@ PhiInst *PhiInst::create_phi( Type *ty, BasicBlock *bb)
 {
     std::vector<Value *> vals;
     std::vector<BasicBlock *> val_bbs;
-    return new PhiInst(Instruction::phi, vals, val_bbs, ty, bb);
+    return new (bb->get_module()) PhiInst(Instruction::phi, vals, val_bbs, ty, bb);
 }
 
 std::string PhiInst::print()
@@ -644,9 +644,10 @@ std::string PhiInst::print()
     }
     if ( (int)this->get_num_operand()/2 < (int)(this->get_parent()->get_pre_basic_blocks().size()) )
     {
+        const auto operands = this->get_operands();
         for ( auto pre_bb : this->get_parent()->get_pre_basic_blocks() )
         {
-            if (std::find(this->get_operands().begin(), this->get_operands().end(), static_cast<Value *>(pre_bb)) == this->get_operands().end())
+            if (std::find(operands.begin(), operands.end(), static_cast<Value *>(pre_bb)) == operands.end())
             {
                 // find a pre_bb is not in phi
                 instr_ir += ", [ undef, " +print_as_op(pre_bb, false)+" ]";
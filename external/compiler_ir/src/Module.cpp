@@ -5,17 +5,20 @@
  *@date 2022-10-04
  */
 #include "Module.h"
+#include "Constant.h"
 
+#include <algorithm>
+#include <bit>
 #include <utility>
 
 Module::Module(std::string name) : module_name_(std::move(name)) {
   /// @brief 创建类型指针对象
   /// @param name
-  void_ty_ = new Type(Type::VoidTyID, this);
-  label_ty_ = new Type(Type::LabelTyID, this);
-  int1_ty_ = new IntegerType(1, this);
-  int32_ty_ = new IntegerType(32, this);
-  float32_ty_ = new FloatType(this);
+  void_ty_ = new (this) Type(Type::VoidTyID, this);
+  label_ty_ = new (this) Type(Type::LabelTyID, this);
+  int1_ty_ = new (this) IntegerType(1, this);
+  int32_ty_ = new (this) IntegerType(32, this);
+  float32_ty_ = new (this) FloatType(this);
 
   /// @brief id 与 字符串的映射添加
   instr_id2string_.insert({Instruction::ret, "ret"});
@@ -49,11 +52,70 @@ Module::Module(std::string name) : module_name_(std::move(name)) {
  *
  */
 Module::~Module() {
-  delete void_ty_;
-  delete label_ty_;
-  delete int1_ty_;
-  delete int32_ty_;
-  delete float32_ty_;
+  // 逆序析构：后创建的对象可能引用先创建的对象，内存随arena_一并释放
+  for (auto it = values_.rbegin(); it != values_.rend(); ++it) {
+    (*it)->~Value();
+  }
+  for (auto it = types_.rbegin(); it != types_.rend(); ++it) {
+    (*it)->~Type();
+  }
+}
+/**
+ * @brief 为value分配内存并登记
+ *
+ * @param size 对象大小
+ * @return void* 对象内存
+ */
+void *Module::allocate_value(std::size_t size) {
+  auto lock = lock_if_concurrent(arena_mutex_);
+  void *p = arena_.allocate(size, alignof(std::max_align_t));
+  values_.push_back(static_cast<Value *>(p));
+  return p;
+}
+/**
+ * @brief 为类型分配内存并登记
+ *
+ * @param size 对象大小
+ * @return void* 对象内存
+ */
+void *Module::allocate_type(std::size_t size) {
+  auto lock = lock_if_concurrent(arena_mutex_);
+  void *p = arena_.allocate(size, alignof(std::max_align_t));
+  types_.push_back(static_cast<Type *>(p));
+  return p;
+}
+/**
+ * @brief 撤销未构造成功的value的登记，其内存留在内存池中
+ *
+ * @param p 对象内存
+ */
+void Module::discard_value(void *p) {
+  auto lock = lock_if_concurrent(arena_mutex_);
+  auto it = std::find(values_.rbegin(), values_.rend(), p);
+  if (it != values_.rend()) {
+    values_.erase(std::next(it).base());
+  }
+}
+/**
+ * @brief 撤销未构造成功的类型的登记，其内存留在内存池中
+ *
+ * @param p 对象内存
+ */
+void Module::discard_type(void *p) {
+  auto lock = lock_if_concurrent(arena_mutex_);
+  auto it = std::find(types_.rbegin(), types_.rend(), p);
+  if (it != types_.rend()) {
+    types_.erase(std::next(it).base());
+  }
+}
+/**
+ * @brief 已分配的对象数
+ *
+ * @return std::size_t 类型和value的总数
+ */
+std::size_t Module::num_objects() {
+  auto lock = lock_if_concurrent(arena_mutex_);
+  return values_.size() + types_.size();
 }
 /**
  * @brief Get the void type object，获取一个构建好的void类型指针
@@ -86,8 +148,9 @@ IntegerType *Module::get_int32_type() { return int32_ty_; }
  * @return PointerType*
  */
 PointerType *Module::get_pointer_type(Type *contained) {
+  auto lock = lock_if_concurrent(type_mutex_);
   if (pointer_map_.find(contained) == pointer_map_.end()) {
-    pointer_map_[contained] = new PointerType(contained);
+    pointer_map_[contained] = new (this) PointerType(contained);
   }
   return pointer_map_[contained];
 }
@@ -99,9 +162,10 @@ PointerType *Module::get_pointer_type(Type *contained) {
  * @return ArrayType*
  */
 ArrayType *Module::get_array_type(Type *contained, unsigned num_elements) {
+  auto lock = lock_if_concurrent(type_mutex_);
   if (array_map_.find({contained, num_elements}) == array_map_.end()) {
     array_map_[{contained, num_elements}] =
-        new ArrayType(contained, num_elements);
+        new (this) ArrayType(contained, num_elements);
   }
   return array_map_[{contained, num_elements}];
 }
@@ -127,6 +191,62 @@ FloatType *Module::get_float_type() { return float32_ty_; }
 PointerType *Module::get_float_ptr_type() {
   return get_pointer_type(float32_ty_);
 }
+/**
+ * @brief 获取值为val的i32常量，相同的值返回同一个对象
+ *
+ * @param val 常量值
+ * @return ConstantInt*
+ */
+ConstantInt *Module::get_int_constant(int val) {
+  auto lock = lock_if_concurrent(constant_mutex_);
+  auto &c = int_constants_[val];
+  if (c == nullptr) {
+    c = new (this) ConstantInt(int32_ty_, val);
+  }
+  return c;
+}
+/**
+ * @brief 获取i1常量 true/false，每个模块各只有一个
+ *
+ * @param val 常量值
+ * @return ConstantInt*
+ */
+ConstantInt *Module::get_bool_constant(bool val) {
+  auto lock = lock_if_concurrent(constant_mutex_);
+  auto &c = bool_constants_[val ? 1 : 0];
+  if (c == nullptr) {
+    c = new (this) ConstantInt(int1_ty_, val ? 1 : 0);
+  }
+  return c;
+}
+/**
+ * @brief 获取float常量，位模式相同的值返回同一个对象
+ *
+ * @param val 常量值
+ * @return ConstantFloat*
+ */
+ConstantFloat *Module::get_float_constant(float val) {
+  auto lock = lock_if_concurrent(constant_mutex_);
+  auto &c = float_constants_[std::bit_cast<uint32_t>(val)];
+  if (c == nullptr) {
+    c = new (this) ConstantFloat(float32_ty_, val);
+  }
+  return c;
+}
+/**
+ * @brief 获取类型ty的零初始化常量，每种类型一个
+ *
+ * @param ty 常量类型
+ * @return ConstantZero*
+ */
+ConstantZero *Module::get_zero_constant(Type *ty) {
+  auto lock = lock_if_concurrent(constant_mutex_);
+  auto &c = zero_constants_[ty];
+  if (c == nullptr) {
+    c = new (this) ConstantZero(ty);
+  }
+  return c;
+}
 /**
  * @brief 添加函数
  *
@@ -25,6 +25,23 @@ Type::Type(TypeID tid, Module *m) {
  * @return Module* 模块指针
  */
 Module *Type::get_module() { return m_; }
+/**
+ * @brief 在模块m的内存池中分配类型
+ *
+ * @param size 对象大小
+ * @param m 所属模块
+ * @return void* 对象内存
+ */
+void *Type::operator new(std::size_t size, Module *m) {
+  return m->allocate_type(size);
+}
+/**
+ * @brief 构造函数抛出异常时撤销登记，内存留在内存池中
+ *
+ * @param p 对象内存
+ * @param m 所属模块
+ */
+void Type::operator delete(void *p, Module *m) { m->discard_type(p); }
 /**
  * @brief 判断两个类型是否一致
  *
@@ -226,7 +243,7 @@ IntegerType::IntegerType(unsigned num_bits, Module *m)
  * @return IntegerType*
  */
 IntegerType *IntegerType::get(unsigned num_bits, Module *m) {
-  return new IntegerType(num_bits, m);
+  return new (m) IntegerType(num_bits, m);
 }
 /**
  * @brief Get the num bits object，获取整数类型对应的位数
@@ -243,7 +260,7 @@ unsigned IntegerType::get_num_bits() { return num_bits_; }
  * @return 创建对象本身
  */
 FunctionType::FunctionType(Type *result, std::vector<Type *> params)
-    : Type(Type::FunctionTyID, nullptr) {
+    : Type(Type::FunctionTyID, result->get_module()) {
   assert(is_valid_return_type(result) && "Invalid return type for function!");
   result_ = result;
 
@@ -281,7 +298,7 @@ bool FunctionType::is_valid_argument_type(Type *ty) {
  * @return FunctionType* 函数类型指针
  */
 FunctionType *FunctionType::get(Type *result, std::vector<Type *> params) {
-  return new FunctionType(result, params);
+  return new (result->get_module()) FunctionType(result, params);
 }
 /**
  * @brief Get the num of args object，获取参数个数
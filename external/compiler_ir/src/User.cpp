@@ -20,20 +20,30 @@
  */
 User::User(Type *ty, const std::string &name, unsigned num_ops)
     : Value(ty, name), num_ops_(num_ops) {
-  operands_.resize(num_ops_, nullptr);
+  operands_.reserve(num_ops_);
+  for (unsigned i = 0; i < num_ops_; i++) {
+    operands_.emplace_back(this, i);
+  }
 }
 
 /*!
  *@brief 获得包含value指针的数组
- *@return 返回User维护的Value数组
+ *@return 各操作数的副本
  */
-std::vector<Value *> &User::get_operands() { return operands_; }
+std::vector<Value *> User::get_operands() const {
+  std::vector<Value *> ops;
+  ops.reserve(operands_.size());
+  for (auto &use : operands_) {
+    ops.push_back(use.value_);
+  }
+  return ops;
+}
 
 /*!
  *@brief 获得数组中的第i个value数值指针
  *@return 获得数组中的第i个value数值常量指针
  */
-Value *User::get_operand(unsigned i) const { return operands_[i]; }
+Value *User::get_operand(unsigned i) const { return operands_[i].value_; }
 
 /*!
  *@brief 设置数组中的第i个value数值指针
@@ -42,15 +52,11 @@ Value *User::get_operand(unsigned i) const { return operands_[i]; }
  *设置数组中的第i个value数值常量指针
  *设置界限检查，查看索引i是否超限
  *--------
- *&emsp; value数组尾插入一个value
- *&emsp; 为value添加一个use关系
- *&emsp; 计数加一
+ *&emsp; 该操作数从原value的use list移到v的use list
  */
 void User::set_operand(unsigned i, Value *v) {
   assert(i < num_ops_ && "set_operand out of index");
-  // assert(operands_[i] == nullptr && "ith operand is not null");
-  operands_[i] = v;
-  v->add_use(this, i);
+  operands_[i].set(v);
 }
 
 /*!
@@ -63,8 +69,8 @@ void User::set_operand(unsigned i, Value *v) {
  *&emsp; 计数加一
  */
 void User::add_operand(Value *v) {
-  operands_.push_back(v);
-  v->add_use(this, num_ops_);
+  operands_.emplace_back(this, num_ops_);
+  operands_.back().set(v);
   num_ops_++;
 }
 
@@ -78,16 +84,14 @@ void User::add_operand(Value *v) {
 unsigned User::get_num_operand() const { return num_ops_; }
 
 /*!
- *@brief 添加新的value数值指针
- *@param v value数值指针
+ *@brief 将本User从各操作数的use list中摘下
  *@note
  *--------
- *遍历operands链表，对于每个value量的use_list进行检查
- *在operands表中删除对于本对象的使用
+ *每个操作数的use直接从链表中摘下，操作数保持不变
  */
 void User::remove_use_of_ops() {
-  for (auto op : operands_) {
-    op->remove_use(this);
+  for (auto &use : operands_) {
+    use.unlink();
   }
 }
 
@@ -97,14 +101,40 @@ void User::remove_use_of_ops() {
  *@param index2 索引2
  *@note
  *--------
- *遍历operands表索引范围，删除对于本user的使用
- *删除本表的相关operands
+ *删除本表的相关operands，其use随之从use list中摘下
+ *后面的operands前移并重新编号
  *修改operands_size
  */
 void User::remove_operands(int index1, int index2) {
-  for (int i = index1; i <= index2; i++) {
-    operands_[i]->remove_use(this);
-  }
   operands_.erase(operands_.begin() + index1, operands_.begin() + index2 + 1);
   num_ops_ = operands_.size();
+  for (unsigned i = index1; i < num_ops_; i++) {
+    operands_[i].arg_no_ = i;
+  }
+}
+
+/*!
+ *@brief 深拷贝时复制from的全部操作数
+ *@param from 被复制的User
+ */
+void User::copy_operands(User *from) {
+  assert(num_ops_ == from->num_ops_ && "copy_operands size mismatch");
+  for (unsigned i = 0; i < num_ops_; i++) {
+    operands_[i].set(from->get_operand(i));
+  }
+}
+
+/*!
+ *@brief 按映射替换操作数
+ *@param ptMap 旧value到新value的映射
+ *@param first 从第几个操作数开始替换
+ */
+void User::transplant_operands(const std::map<Value *, Value *> &ptMap,
+                               unsigned first) {
+  for (unsigned i = first; i < num_ops_; i++) {
+    auto it = ptMap.find(operands_[i].value_);
+    if (it != ptMap.end()) {
+      operands_[i].set(it->second);
+    }
+  }
 }
@@ -6,8 +6,10 @@
  */
 
 #include <cassert>
+#include <mutex>
 
 #include "BasicBlock.h"
+#include "Module.h"
 #include "Type.h"
 #include "User.h"
 #include "Value.h"
@@ -18,17 +20,69 @@
  *@return 当前对象本身
  */
 Value::Value(Type *ty, const std::string &name) : type_(ty), name_(name) {}
+/*!
+ *@brief 在模块m的内存池中分配value
+ *@param size 对象大小
+ *@param m 所属模块
+ *@return 对象内存
+ */
+void *Value::operator new(std::size_t size, Module *m) {
+  return m->allocate_value(size);
+}
+/*!
+ *@brief 构造函数抛出异常时撤销登记，内存留在内存池中
+ *@param p 对象内存
+ *@param m 所属模块
+ */
+void Value::operator delete(void *p, Module *m) { m->discard_value(p); }
 
 /*!
- *@brief 添加use
- *@param val 使用该value的value
- *@param arg_no 在指令中的顺序
+ *@brief Value的析构函数
  *@note
  *---------
- *在use链中添加
+ *将仍在使用本value的操作数置为未链接，User之后析构时不再访问本对象
+ */
+Value::~Value() {
+  for (auto *use : use_list_) {
+    use->linked_ = false;
+  }
+}
+/*!
+ *@brief 将use挂到use list尾部
+ *@param use 使用该value的操作数
+ */
+void Value::add_use(Use *use) {
+  if (shared_uses_) {
+    auto lock = type_->get_module()->lock_uses();
+    use_list_.push_back(use);
+    return;
+  }
+  use_list_.push_back(use);
+}
+/*!
+ *@brief 从use list中摘下use，O(1)
+ *@param use 使用该value的操作数
+ */
+void Value::remove_use(Use *use) {
+  if (shared_uses_) {
+    auto lock = type_->get_module()->lock_uses();
+    use_list_.erase(use);
+    return;
+  }
+  use_list_.erase(use);
+}
+/*!
+ *@brief 操作数移动后，新位置now接替old在use list中的位置
+ *@param old 原操作数
+ *@param now 新操作数
  */
-void Value::add_use(Value *val, unsigned arg_no) {
-  use_list_.push_back(Use(val, arg_no));
+void Value::replace_use(Use *old, Use *now) {
+  if (shared_uses_) {
+    auto lock = type_->get_module()->lock_uses();
+    use_list_.replace(old, now);
+    return;
+  }
+  use_list_.replace(old, now);
 }
 /*!
  *@brief 获取value的名称
@@ -41,15 +95,15 @@ std::string Value::get_name() const { return name_; }
  *@note
  *--------
  *支持对于所有的value的修改，包括基本块
- *&emsp; 首先遍历所属的use_list，修改其他value中对于当前value的引用为新value
+ *&emsp; 首先将use_list中的每个操作数改为新value，操作数随之移入新value的use list
  *&emsp; 转换value类型为basicblock，修改成功即为对基本块间的类型调用修改，
  *&emsp; 依次修改前置后置的链表中对于该基本块的引用
  */
 void Value::replace_all_use_with(Value *new_val) {
-  for (auto use : use_list_) {
-    auto val = dynamic_cast<User *>(use.val_);
-    assert(val && "new_val is not a user");
-    val->set_operand(use.arg_no_, new_val);
+  if (new_val != this) {
+    while (!use_list_.empty()) {
+      use_list_.front()->set(new_val);
+    }
   }
   auto val = dynamic_cast<BasicBlock *>(this);
   if (val) {
@@ -68,14 +122,58 @@ void Value::replace_all_use_with(Value *new_val) {
 }
 
 /*!
- *@brief 替换所有对于旧value的引用，改为新的
- *@param val value型指针
- *@note
- *----------
- *设置lambda函数，判定val的匹配
- *匹配成功则进行value的相关删除
+ *@brief use的移动构造：接替other在use list中的位置
+ *@param other 被移动的use，之后不再链接
+ */
+Use::Use(Use &&other) noexcept
+    : val_(other.val_), arg_no_(other.arg_no_), linked_(other.linked_),
+      value_(other.value_) {
+  if (linked_) {
+    value_->replace_use(&other, this);
+    other.linked_ = false;
+  }
+}
+/*!
+ *@brief use的移动赋值：先摘下自身，再接替other在use list中的位置
+ *@param other 被移动的use，之后不再链接
+ *@return 当前对象本身
  */
-void Value::remove_use(Value *val) {
-  auto is_val = [val](const Use &use) { return use.val_ == val; };
-  use_list_.remove_if(is_val);
-}
\ No newline at end of file
+Use &Use::operator=(Use &&other) noexcept {
+  if (this != &other) {
+    unlink();
+    val_ = other.val_;
+    arg_no_ = other.arg_no_;
+    linked_ = other.linked_;
+    value_ = other.value_;
+    if (linked_) {
+      value_->replace_use(&other, this);
+      other.linked_ = false;
+    }
+  }
+  return *this;
+}
+/*!
+ *@brief use的析构函数，从use list中摘下
+ */
+Use::~Use() { unlink(); }
+/*!
+ *@brief 将操作数改为v，从原value的use list移到v的use list
+ *@param v 新的操作数，可以为空
+ */
+void Use::set(Value *v) {
+  unlink();
+  value_ = v;
+  if (v != nullptr) {
+    v->add_use(this);
+    linked_ = true;
+  }
+}
+/*!
+ *@brief 从value_的use list中摘下，操作数本身保持不变
+ */
+void Use::unlink() {
+  if (linked_) {
+    value_->remove_use(this);
+    linked_ = false;
+  }
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+
+namespace front::ast {
+    // Bump allocator owning the nodes of one parse. Nodes are never
+    // destroyed one by one; the whole arena is released at once, so
+    // everything placed in it must either be trivially destructible or
+    // allocate only from resource().
+    class Arena {
+    public:
+        static constexpr size_t kInitialBlock = 16 * 1024;
+
+        Arena() : resource_(kInitialBlock) {
+        }
+
+        Arena(const Arena &) = delete;
+
+        Arena &operator=(const Arena &) = delete;
+
+        [[nodiscard]] std::pmr::memory_resource *resource() { return &resource_; }
+
+        // constructs a T in the arena, handing containers the arena resource
+        template<typename T, typename... Args>
+        T *create(Args &&... args) {
+            void *p = resource_.allocate(sizeof(T), alignof(T));
+            ++objects_;
+            if constexpr (std::is_constructible_v<T, std::pmr::memory_resource *, Args...>) {
+                return ::new(p) T(&resource_, std::forward<Args>(args)...);
+            } else {
+                return ::new(p) T(std::forward<Args>(args)...);
+            }
+        }
+
+        [[nodiscard]] size_t objects() const { return objects_; }
+
+        // the arena semantic actions allocate from on this thread
+        static Arena &current() {
+            if (current_ == nullptr) {
+                throw std::logic_error("AST built outside of an ArenaScope");
+            }
+            return *current_;
+        }
+
+    private:
+        friend class ArenaScope;
+
+        std::pmr::monotonic_buffer_resource resource_;
+        size_t objects_{0};
+
+        static inline thread_local Arena *current_ = nullptr;
+    };
+
+    // makes `arena` the current one on this thread until destroyed
+    class ArenaScope {
+    public:
+        explicit ArenaScope(Arena &arena) : previous_(Arena::current_) {
+            Arena::current_ = &arena;
+        }
+
+        ArenaScope(const ArenaScope &) = delete;
+
+        ArenaScope &operator=(const ArenaScope &) = delete;
+
+        ~ArenaScope() { Arena::current_ = previous_; }
+
+    private:
+        Arena *previous_;
+    };
+}
@@ -2,15 +2,24 @@
 // Created by steven on 12/2/25.
 //
 #pragma once
+#include <cstdint>
 #include <memory>
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <variant>
 #include <vector>
 
+#include "arena.h"
 #include "token.h"
+#include "utils/interner.h"
 #include "Value.h"
 
 
+namespace front {
+    class ThreadPool;
+}
+
 namespace front::ir {
     class CodegenContext;
 }
@@ -26,176 +35,263 @@ namespace front::ast {
         And, Or,
     };
 
+    enum class NodeKind : uint8_t {
+        LiteralInt, LiteralFloat, Identifier, Unary, Binary, Call,
+        EmptyStmt, ExprStmt, AssignStmt, ReturnStmt, IfStmt, BlockStmt,
+        VarDecl, FuncDef, Program,
+    };
+
+    // Nodes carry no vtable: `kind` names the concrete type, and passes
+    // dispatch on it with a switch (see with_kind in walk.h) rather than
+    // virtual calls or dynamic_cast. Each concrete node exposes its tag as
+    // kKind.
     struct Node {
-        virtual ~Node() = default;
+        const NodeKind kind;
+
+    protected:
+        explicit Node(const NodeKind kind) : kind(kind) {
+        }
     };
 
-    struct Expr : Node {
-        virtual Value *codegen(ir::CodegenContext &ctx) = 0;
+    // checked downcast by tag; nullptr when `node` is not a T
+    template<typename T>
+    const T *node_cast(const Node *node) {
+        return node != nullptr && node->kind == T::kKind ? static_cast<const T *>(node) : nullptr;
+    }
 
-        ~Expr() override = default;
+    // Nodes live in an Arena and are released with it, never one by one, so
+    // owning pointers to them only express the tree shape.
+    struct ArenaRelease {
+        void operator()(const Node *) const noexcept {
+        }
+    };
+
+    template<typename T>
+    using NodePtr = std::unique_ptr<T, ArenaRelease>;
+
+    // allocates a node in the current Arena
+    template<typename T>
+    NodePtr<T> make_node() {
+        return NodePtr<T>(Arena::current().create<T>());
+    }
+
+    struct Expr : Node {
+    protected:
+        using Node::Node;
     };
 
     struct LiteralInt : Expr {
+        static constexpr NodeKind kKind = NodeKind::LiteralInt;
+
         int value{};
 
-        Value *codegen(ir::CodegenContext &ctx) override;
+        LiteralInt() : Expr(kKind) {
+        }
     };
 
     struct LiteralFloat : Expr {
+        static constexpr NodeKind kKind = NodeKind::LiteralFloat;
+
         float value{};
 
-        Value *codegen(ir::CodegenContext &ctx) override;
+        LiteralFloat() : Expr(kKind) {
+        }
     };
 
     struct IdentifierExpr : Expr {
-        std::string name;
+        static constexpr NodeKind kKind = NodeKind::Identifier;
+
+        SymbolId name{kNoSymbol};
 
-        Value *codegen(ir::CodegenContext &ctx) override;
+        IdentifierExpr() : Expr(kKind) {
+        }
     };
 
     struct UnaryExpr : Expr {
+        static constexpr NodeKind kKind = NodeKind::Unary;
+
         UnaryOp op;
-        std::unique_ptr<Expr> operand;
+        NodePtr<Expr> operand;
 
-        Value *codegen(ir::CodegenContext &ctx) override;
+        UnaryExpr() : Expr(kKind) {
+        }
     };
 
     struct BinaryExpr : Expr {
+        static constexpr NodeKind kKind = NodeKind::Binary;
+
         BasicOp op;
-        std::unique_ptr<Expr> lhs;
-        std::unique_ptr<Expr> rhs;
+        NodePtr<Expr> lhs;
+        NodePtr<Expr> rhs;
 
-        Value *codegen(ir::CodegenContext &ctx) override;
+        BinaryExpr() : Expr(kKind) {
+        }
     };
 
     struct CallExpr : Expr {
-        std::string callee;
-        std::vector<std::unique_ptr<Expr> > args;
+        static constexpr NodeKind kKind = NodeKind::Call;
+
+        SymbolId callee{kNoSymbol};
+        std::pmr::vector<NodePtr<Expr> > args;
 
-        Value *codegen(ir::CodegenContext &ctx) override;
+        explicit CallExpr(std::pmr::memory_resource *resource) : Expr(kKind), args(resource) {
+        }
     };
 
     struct Stmt : Node {
-        virtual void codegen(ir::CodegenContext &ctx) = 0;
-
-        ~Stmt() override = default;
+    protected:
+        using Node::Node;
     };
 
     struct EmptyStmt : Stmt {
-        void codegen(ir::CodegenContext &ctx) override;
+        static constexpr NodeKind kKind = NodeKind::EmptyStmt;
+
+        EmptyStmt() : Stmt(kKind) {
+        }
     };
 
     struct ExprStmt : Stmt {
-        std::unique_ptr<Expr> expr;
+        static constexpr NodeKind kKind = NodeKind::ExprStmt;
 
-        void codegen(ir::CodegenContext &ctx) override;
+        NodePtr<Expr> expr;
+
+        ExprStmt() : Stmt(kKind) {
+        }
     };
 
     struct AssignStmt : Stmt {
-        std::string target;
-        std::unique_ptr<Expr> expr;
+        static constexpr NodeKind kKind = NodeKind::AssignStmt;
+
+        SymbolId target{kNoSymbol};
+        NodePtr<Expr> expr;
 
-        void codegen(ir::CodegenContext &ctx) override;
+        AssignStmt() : Stmt(kKind) {
+        }
     };
 
     struct ReturnStmt : Stmt {
-        std::unique_ptr<Expr> value;
+        static constexpr NodeKind kKind = NodeKind::ReturnStmt;
+
+        NodePtr<Expr> value;
 
-        void codegen(ir::CodegenContext &ctx) override;
+        ReturnStmt() : Stmt(kKind) {
+        }
     };
 
     struct IfStmt : Stmt {
-        std::unique_ptr<Expr> condition;
-        std::unique_ptr<Stmt> then_branch;
-        std::unique_ptr<Stmt> else_branch;
+        static constexpr NodeKind kKind = NodeKind::IfStmt;
 
-        void codegen(ir::CodegenContext &ctx) override;
+        NodePtr<Expr> condition;
+        NodePtr<Stmt> then_branch;
+        NodePtr<Stmt> else_branch;
+
+        IfStmt() : Stmt(kKind) {
+        }
     };
 
 
     struct Decl : Node {
-        virtual void codegen(ir::CodegenContext &ctx) = 0;
-
-        ~Decl() override = default;
+    protected:
+        using Node::Node;
     };
 
     struct BlockItem {
         enum class Type { Decl, Stmt };
 
         Type type{Type::Stmt};
-        std::unique_ptr<Decl> decl;
-        std::unique_ptr<Stmt> stmt;
+        NodePtr<Decl> decl;
+        NodePtr<Stmt> stmt;
 
-        static BlockItem make_decl(std::unique_ptr<Decl> decl) {
+        static BlockItem make_decl(NodePtr<Decl> decl) {
             return {Type::Decl, std::move(decl), nullptr};
         }
 
-        static BlockItem make_stmt(std::unique_ptr<Stmt> stmt) {
+        static BlockItem make_stmt(NodePtr<Stmt> stmt) {
             return {Type::Stmt, nullptr, std::move(stmt)};
         }
     };
 
     struct BlockStmt : Stmt {
-        std::vector<BlockItem> items;
+        static constexpr NodeKind kKind = NodeKind::BlockStmt;
 
-        void codegen(ir::CodegenContext &ctx) override;
+        std::pmr::vector<BlockItem> items;
+
+        explicit BlockStmt(std::pmr::memory_resource *resource) : Stmt(kKind), items(resource) {
+        }
     };
 
     struct VarInit {
-        std::string name;
-        std::unique_ptr<Expr> value;
+        SymbolId name{kNoSymbol};
+        NodePtr<Expr> value;
     };
 
     struct VarDecl : Decl {
+        static constexpr NodeKind kKind = NodeKind::VarDecl;
+
         bool is_const{false};
         BasicType type{BasicType::Int};
-        std::vector<VarInit> items;
+        std::pmr::vector<VarInit> items;
 
-        void codegen(ir::CodegenContext &ctx) override;
+        explicit VarDecl(std::pmr::memory_resource *resource) : Decl(kKind), items(resource) {
+        }
     };
 
     struct Param {
         BasicType type{BasicType::Int};
-        std::string name;
+        SymbolId name{kNoSymbol};
     };
 
     struct FuncDef : Node {
+        static constexpr NodeKind kKind = NodeKind::FuncDef;
+
         BasicType type{BasicType::Void};
-        std::string name;
-        std::vector<Param> params;
-        std::unique_ptr<BlockStmt> body;
+        SymbolId name{kNoSymbol};
+        std::pmr::vector<Param> params;
+        NodePtr<BlockStmt> body;
 
-        void codegen(ir::CodegenContext &ctx);
+        explicit FuncDef(std::pmr::memory_resource *resource) : Node(kKind), params(resource) {
+        }
     };
 
+    // The root is an ordinary heap object: it keeps alive the arenas its
+    // nodes were built in (more than one after an incremental reparse).
     struct Program : Node {
-        std::vector<std::unique_ptr<Decl> > globals;
-        std::vector<std::unique_ptr<FuncDef> > functions;
+        static constexpr NodeKind kKind = NodeKind::Program;
 
-        void codegen(ir::CodegenContext &ctx) const;
+        std::vector<std::shared_ptr<Arena> > arenas;
+        std::vector<NodePtr<Decl> > globals;
+        std::vector<NodePtr<FuncDef> > functions;
+        // set by fold_constants(); codegen expects global initializers folded
+        bool constants_folded{false};
+
+        Program() : Node(kKind) {
+        }
+
+        // lowers the globals, then the function bodies, spread over `pool`
+        // when one is given; the IR is the same either way
+        void codegen(ir::CodegenContext &ctx, ThreadPool *pool = nullptr) const;
     };
 
-    using ExprPtr = std::unique_ptr<Expr>;
-    using StmtPtr = std::unique_ptr<Stmt>;
-    using DeclPtr = std::unique_ptr<Decl>;
-    using BlockPtr = std::unique_ptr<BlockStmt>;
-    using FuncPtr = std::unique_ptr<FuncDef>;
+    using ExprPtr = NodePtr<Expr>;
+    using StmtPtr = NodePtr<Stmt>;
+    using DeclPtr = NodePtr<Decl>;
+    using BlockPtr = NodePtr<BlockStmt>;
+    using FuncPtr = NodePtr<FuncDef>;
     using ProgramPtr = std::unique_ptr<Program>;
 
     using SemVal = std::variant<
         std::monostate,
 
-        // terminals
-        std::string,
+        // terminals; identifiers arrive interned
+        SymbolId,
         int,
         float,
         BasicType,
         UnaryOp,
 
         BlockItem,
-        std::vector<VarInit>,
-        std::vector<Param>,
+        std::pmr::vector<VarInit>,
+        std::pmr::vector<Param>,
 
         // AST Ptr
         ExprPtr,
@@ -208,5 +304,11 @@ namespace front::ast {
 
     SemVal make_semantic(const Token &token);
 
+    const char *to_string(BasicType type);
+
+    const char *to_string(UnaryOp op);
+
+    const char *to_string(BasicOp op);
+
     void print_ast(const ProgramPtr &program, std::ostream &os);
 }
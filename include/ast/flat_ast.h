@@ -0,0 +1,88 @@
+#pragma once
+#include <bit>
+#include <cstdint>
+#include <ostream>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "ast.h"
+
+
+namespace front::ast {
+    using NodeId = uint32_t;
+
+    inline constexpr NodeId kNoNode = UINT32_MAX;
+
+    enum class FlatKind : uint8_t {
+        // expressions
+        LiteralInt, LiteralFloat, Identifier, Unary, Binary, Call,
+        // statements
+        Empty, ExprStmt, Assign, Return, If, Block,
+        // declarations
+        VarDecl, VarInit, Param, Func,
+    };
+
+    // Structure-of-arrays encoding of a Program. Every per-node array is
+    // indexed by NodeId; a node's children are the contiguous range
+    // children[first_child, first_child + child_count). Nodes are appended
+    // bottom-up, so children always precede their parent, the same order
+    // an LR parse reduces them in.
+    //
+    // The meaning of `op` and `payload` depends on the kind:
+    //   LiteralInt / LiteralFloat  payload holds the value bits
+    //   Identifier / Call / Assign payload is the SymbolId of the name
+    //   VarInit / Param            payload is the SymbolId, op a BasicType (Param)
+    //   Func                       payload is the SymbolId, op the return BasicType;
+    //                              children are the params followed by the body
+    //   Unary / Binary             op is a UnaryOp / BasicOp
+    //   VarDecl                    op is the BasicType, payload 1 when const
+    //   Return / VarInit / If      absent optional children are simply not stored
+    class FlatAst {
+    public:
+        std::vector<FlatKind> kinds;
+        std::vector<uint8_t> ops;
+        std::vector<uint32_t> payloads;
+        std::vector<uint32_t> first_child;
+        std::vector<uint32_t> child_count;
+
+        std::vector<NodeId> children;
+
+        // top-level items in source order within each list
+        std::vector<NodeId> globals;
+        std::vector<NodeId> functions;
+
+        [[nodiscard]] size_t size() const { return kinds.size(); }
+
+        [[nodiscard]] std::span<const NodeId> children_of(const NodeId id) const {
+            return {children.data() + first_child[id], child_count[id]};
+        }
+
+        [[nodiscard]] SymbolId symbol(const NodeId id) const { return payloads[id]; }
+
+        [[nodiscard]] std::string_view name(const NodeId id) const { return symbol_name(payloads[id]); }
+
+        [[nodiscard]] int int_value(const NodeId id) const { return std::bit_cast<int>(payloads[id]); }
+
+        [[nodiscard]] float float_value(const NodeId id) const { return std::bit_cast<float>(payloads[id]); }
+
+        // bytes held by all arrays, for comparisons against the pointer tree
+        [[nodiscard]] size_t footprint() const;
+
+        // Appends a node over `kids` and returns its id. Builders call this
+        // bottom-up, so the children's ids already exist.
+        NodeId add(FlatKind kind, uint8_t op, uint32_t payload, std::span<const NodeId> kids = {});
+    };
+
+    // encodes `program` in one bottom-up walk
+    FlatAst flatten(const Program &program);
+
+    // Rebuilds the pointer tree in a fresh arena, e.g. for Program::codegen,
+    // in one pass over the ids. Throws std::runtime_error on an encoding
+    // whose shapes or kinds do not form a Program; children are assumed to
+    // precede their parents, which flatten() and deserialize() guarantee.
+    ProgramPtr to_program(const FlatAst &flat);
+
+    // same output as print_ast on the tree the encoding was built from
+    void print_ast(const FlatAst &flat, std::ostream &os);
+}
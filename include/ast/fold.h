@@ -0,0 +1,15 @@
+#pragma once
+#include "ast.h"
+
+
+namespace front::ast {
+    // Rewrites every constant UnaryExpr / BinaryExpr subtree of `program`
+    // into a LiteralInt or LiteralFloat, in one bottom-up walk: a parent
+    // folds from its children's literals without revisiting their subtrees.
+    // Folded values follow codegen's typing (int unless a float is involved,
+    // comparisons and logic yield int 0/1); integer division by zero and
+    // float `%` are left for codegen. A global initializer cannot defer to
+    // run time, so there any division or remainder by zero folds to 0.
+    // Runs once per program, later calls return at once.
+    void fold_constants(Program &program);
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include <string>
+#include <string_view>
+
+#include "ast.h"
+
+
+namespace front::ast {
+    // Compact binary form of a Program, for caching the frontend's output
+    // across runs. The blob holds the FlatAst arrays, with names moved into
+    // a string table of their own: SymbolIds are only meaningful within one
+    // process, so loading re-interns the names into the current table.
+    std::string serialize(const Program &program);
+
+    // Loads a blob written by serialize() into a fresh arena. Throws
+    // std::runtime_error on a blob that is truncated, comes from another
+    // format version, or does not describe a well-formed tree. Its names
+    // are interned only once the whole blob has checked out.
+    ProgramPtr deserialize(std::string_view bytes);
+}
@@ -0,0 +1,161 @@
+#pragma once
+#include <concepts>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "ast.h"
+
+
+namespace front::ast {
+    // N's constness applied to T
+    template<typename N, typename T>
+    using like_t = std::conditional_t<std::is_const_v<N>, const T, T>;
+
+    // calls `fn` with `node` downcast to its concrete type
+    template<typename N, typename F> requires std::is_base_of_v<Node, std::remove_const_t<N> >
+    decltype(auto) with_kind(N &node, F &&fn) {
+        switch (node.kind) {
+            case NodeKind::LiteralInt: return fn(static_cast<like_t<N, LiteralInt> &>(node));
+            case NodeKind::LiteralFloat: return fn(static_cast<like_t<N, LiteralFloat> &>(node));
+            case NodeKind::Identifier: return fn(static_cast<like_t<N, IdentifierExpr> &>(node));
+            case NodeKind::Unary: return fn(static_cast<like_t<N, UnaryExpr> &>(node));
+            case NodeKind::Binary: return fn(static_cast<like_t<N, BinaryExpr> &>(node));
+            case NodeKind::Call: return fn(static_cast<like_t<N, CallExpr> &>(node));
+            case NodeKind::EmptyStmt: return fn(static_cast<like_t<N, EmptyStmt> &>(node));
+            case NodeKind::ExprStmt: return fn(static_cast<like_t<N, ExprStmt> &>(node));
+            case NodeKind::AssignStmt: return fn(static_cast<like_t<N, AssignStmt> &>(node));
+            case NodeKind::ReturnStmt: return fn(static_cast<like_t<N, ReturnStmt> &>(node));
+            case NodeKind::IfStmt: return fn(static_cast<like_t<N, IfStmt> &>(node));
+            case NodeKind::BlockStmt: return fn(static_cast<like_t<N, BlockStmt> &>(node));
+            case NodeKind::VarDecl: return fn(static_cast<like_t<N, VarDecl> &>(node));
+            case NodeKind::FuncDef: return fn(static_cast<like_t<N, FuncDef> &>(node));
+            case NodeKind::Program: return fn(static_cast<like_t<N, Program> &>(node));
+        }
+        throw std::logic_error("unknown node kind");
+    }
+
+    // Child slots of a concrete node. Slots have fixed positions, in
+    // evaluation order; optional ones (a return value, an else branch, a
+    // variable's initializer) are null when absent.
+    template<typename T>
+    uint32_t slot_count(const T &node) {
+        using U = std::remove_const_t<T>;
+        if constexpr (std::is_same_v<U, UnaryExpr> || std::is_same_v<U, ExprStmt> || std::is_same_v<U, AssignStmt>
+                      || std::is_same_v<U, ReturnStmt> || std::is_same_v<U, FuncDef>) {
+            return 1;
+        } else if constexpr (std::is_same_v<U, BinaryExpr>) {
+            return 2;
+        } else if constexpr (std::is_same_v<U, IfStmt>) {
+            return 3;
+        } else if constexpr (std::is_same_v<U, CallExpr>) {
+            return static_cast<uint32_t>(node.args.size());
+        } else if constexpr (std::is_same_v<U, BlockStmt> || std::is_same_v<U, VarDecl>) {
+            return static_cast<uint32_t>(node.items.size());
+        } else if constexpr (std::is_same_v<U, Program>) {
+            return static_cast<uint32_t>(node.globals.size() + node.functions.size());
+        } else {
+            return 0;
+        }
+    }
+
+    // the node in slot `i`, or nullptr for an absent optional child
+    template<typename T>
+    like_t<T, Node> *slot(T &node, const uint32_t i) {
+        using U = std::remove_const_t<T>;
+        if constexpr (std::is_same_v<U, UnaryExpr>) {
+            return node.operand.get();
+        } else if constexpr (std::is_same_v<U, BinaryExpr>) {
+            return i == 0 ? node.lhs.get() : node.rhs.get();
+        } else if constexpr (std::is_same_v<U, CallExpr>) {
+            return node.args[i].get();
+        } else if constexpr (std::is_same_v<U, ExprStmt> || std::is_same_v<U, AssignStmt>) {
+            return node.expr.get();
+        } else if constexpr (std::is_same_v<U, ReturnStmt>) {
+            return node.value.get();
+        } else if constexpr (std::is_same_v<U, IfStmt>) {
+            if (i == 0) return node.condition.get();
+            return i == 1 ? node.then_branch.get() : node.else_branch.get();
+        } else if constexpr (std::is_same_v<U, BlockStmt>) {
+            auto &item = node.items[i];
+            if (item.type == BlockItem::Type::Decl) return item.decl.get();
+            return item.stmt.get();
+        } else if constexpr (std::is_same_v<U, VarDecl>) {
+            return node.items[i].value.get();
+        } else if constexpr (std::is_same_v<U, FuncDef>) {
+            return node.body.get();
+        } else if constexpr (std::is_same_v<U, Program>) {
+            if (i < node.globals.size()) return node.globals[i].get();
+            return node.functions[i - node.globals.size()].get();
+        } else {
+            return nullptr;
+        }
+    }
+
+    // Depth-first walk of the tree under `root` on an explicit stack, so
+    // nesting depth costs heap, not call frames. `pass` receives, each
+    // with the node downcast to its concrete type and only if it declares
+    // a matching overload:
+    //   enter(node)              on arrival; returning false skips the children
+    //   before_child(node, i)    before slot i, null or not
+    //   after_child(node, i)     after slot i and everything under it
+    //   leave(node)              once all slots are done
+    template<typename N, typename Pass> requires std::is_base_of_v<Node, std::remove_const_t<N> >
+    void walk(N &root, Pass &pass) {
+        using NodeT = like_t<N, Node>;
+        static constexpr uint32_t kNotEntered = UINT32_MAX;
+        // `next` is the slot being walked; a frame is only ever resumed
+        // once the child it pushed is done
+        struct Frame {
+            NodeT *node;
+            uint32_t next;
+            uint32_t count;
+        };
+
+        std::vector<Frame> stack;
+        stack.reserve(64);
+        stack.push_back({&root, 0, kNotEntered});
+        while (!stack.empty()) {
+            auto &top = stack.back();
+            // one dispatch on the node's kind per step; yields the next
+            // child to descend into, or nullptr once the node is left
+            NodeT *child = with_kind(*top.node, [&](auto &n) -> NodeT *{
+                if (top.count == kNotEntered) {
+                    bool descend = true;
+                    if constexpr (requires { { pass.enter(n) } -> std::same_as<bool>; }) {
+                        descend = pass.enter(n);
+                    } else if constexpr (requires { pass.enter(n); }) {
+                        pass.enter(n);
+                    }
+                    top.count = descend ? slot_count(n) : 0;
+                } else {
+                    if constexpr (requires { pass.after_child(n, top.next); }) {
+                        pass.after_child(n, top.next);
+                    }
+                    ++top.next;
+                }
+                for (; top.next < top.count; ++top.next) {
+                    if constexpr (requires { pass.before_child(n, top.next); }) {
+                        pass.before_child(n, top.next);
+                    }
+                    if (auto *next_child = slot(n, top.next)) {
+                        return next_child;
+                    }
+                    if constexpr (requires { pass.after_child(n, top.next); }) {
+                        pass.after_child(n, top.next);
+                    }
+                }
+                if constexpr (requires { pass.leave(n); }) {
+                    pass.leave(n);
+                }
+                return nullptr;
+            });
+            if (child) {
+                stack.push_back({child, 0, kNotEntered});
+            } else {
+                stack.pop_back();
+            }
+        }
+    }
+}
@@ -1,16 +1,21 @@
 #pragma once
+#include <array>
+#include <cstdint>
+#include <limits>
 #include <ostream>
 #include <unordered_map>
 #include <unordered_set>
-#include <functional>
 #include <span>
 #include <optional>
 
 #include "ast/ast.h"
 #include "symbol.h"
+#include "terminal_set.h"
 
 namespace front::grammar {
-    using ActionFn = std::function<ast::SemVal(std::vector<ast::SemVal> &)>;
+    // semantic actions see the reduced right-hand side as a view over the top
+    // of the parser's value stack
+    using ActionFn = ast::SemVal (*)(std::span<ast::SemVal>);
 
     using TraceInfo = std::optional<std::pair<std::string, std::string> >;
 
@@ -34,6 +39,32 @@ namespace front::grammar {
         }
     };
 
+    // interned terminal id, see Grammar::terminal_symbols_
+    using TerminalId = uint32_t;
+
+    inline constexpr TerminalId kNoTerminal = std::numeric_limits<TerminalId>::max();
+    // `$` is always interned first
+    inline constexpr TerminalId kEndTerminal = 0;
+
+    // FIRST of a symbol sequence, ε kept as a separate flag
+    struct SequenceFirst {
+        TerminalSet first;
+        bool nullable{false};
+    };
+
+    // a nonterminal the parser may synthesize after a syntax error, together
+    // with the value pushed in place of the discarded input
+    struct RecoveryPoint {
+        Symbol nonterminal;
+        ActionFn placeholder{nullptr};
+    };
+
+    // wall time of the analyses run while constructing a Grammar, in ms
+    struct AnalysisTimes {
+        double first_ms{0};
+        double follow_ms{0};
+    };
+
     class Grammar {
     public:
         explicit Grammar(bool ll1 = false);
@@ -64,6 +95,21 @@ namespace front::grammar {
 
         std::unordered_set<Symbol, SymbolHash> first_of_sequence(const std::vector<Symbol> &body) const;
 
+        // FIRST(body[pos..]) of a production, memoized for every suffix
+        const SequenceFirst &first_of_suffix(size_t production, size_t pos) const {
+            return suffix_first_[production][pos];
+        }
+
+        const TerminalSet &follow_of(const Symbol &nonterminal) const {
+            return follow_bits_[nonterminal_ids_.at(nonterminal.name)];
+        }
+
+        // terminal id of a token, or kNoTerminal when the grammar has no
+        // terminal for its type
+        TerminalId terminal_of(const Token &token) const {
+            return token_terminals_[static_cast<size_t>(token.type)];
+        }
+
         bool has_back_tracing(std::ostream &os);
 
         std::vector<Production> productions;
@@ -75,10 +121,33 @@ namespace front::grammar {
         Symbol start_symbol_;
         bool ll1{false};
 
+        // materialized from the bitsets below, for printing and lookups by symbol
         std::unordered_map<Symbol, std::unordered_set<Symbol, SymbolHash>, SymbolHash> first_set_;
         std::unordered_map<Symbol, std::unordered_set<Symbol, SymbolHash>, SymbolHash> follow_set_;
 
+        // interned ids: terminal 0 is always `$`
+        std::vector<Symbol> terminal_symbols_;
+        std::unordered_map<std::string, size_t> terminal_ids_;
+        std::vector<Symbol> nonterminal_symbols_;
+        std::unordered_map<std::string, size_t> nonterminal_ids_;
+
+        // indexed by nonterminal id
+        std::vector<char> nullable_;
+        std::vector<TerminalSet> first_bits_;
+        std::vector<TerminalSet> follow_bits_;
+
         std::unordered_map<Token, Symbol, TokenHash> token_to_terminal_;
+        // token_to_terminal_ indexed by TokenType, filled once symbols are interned
+        std::array<TerminalId, kTokenTypeCount> token_terminals_{};
+
+        // tried in order at each stack depth, innermost first
+        std::vector<RecoveryPoint> recovery_points_;
+
+        AnalysisTimes analysis_times_;
+
+        // top-level item an incremental reparse can reuse or parse on its own;
+        // empty name when the grammar has none
+        Symbol incremental_unit_{Symbol::Type::NonTerminal, ""};
 
     private:
         void add_production(const std::string &name, std::vector<Symbol> body,
@@ -93,8 +162,22 @@ namespace front::grammar {
 
         void left_refactoring();
 
+        void intern_symbols();
+
+        // rebuilds token_terminals_ from token_to_terminal_ and the interned ids
+        void index_token_terminals();
+
+        // FIRST(body[pos..]) from the nonterminal bitsets computed so far
+        SequenceFirst first_of_symbols(const std::vector<Symbol> &body, size_t pos = 0) const;
+
         void compute_first_set();
 
         void compute_follow_set();
+
+        // runs both analyses and records how long each took
+        void analyze();
+
+        // suffix_first_[production][pos] = FIRST(body[pos..])
+        std::vector<std::vector<SequenceFirst> > suffix_first_;
     };
 }
@@ -0,0 +1,101 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "ast/ast.h"
+
+
+namespace front::grammar {
+    // token range [begin, end) of one top-level item of a parsed program,
+    // whether it sits in Program::functions (otherwise Program::globals), how
+    // many globals and functions precede it, and the arena it was parsed into
+    struct ItemSpan {
+        size_t begin{0};
+        size_t end{0};
+        bool function{false};
+        size_t globals_before{0};
+        size_t functions_before{0};
+        const ast::Arena *arena{nullptr};
+    };
+
+    // The top-level items of a parse in source order, as a treap keyed by
+    // index. A node stores its gap after the previous item and its own
+    // length instead of absolute offsets, and each subtree sums widths and
+    // item counts, so absolute spans are recovered on the way down and an
+    // edit rewrites O(log n) nodes: the items after it are never rebased.
+    class ItemSpans {
+    public:
+        ItemSpans() = default;
+
+        // `spans` must be sorted and disjoint
+        explicit ItemSpans(std::span<const ItemSpan> spans);
+
+        [[nodiscard]] size_t size() const { return count(root_); }
+
+        [[nodiscard]] bool empty() const { return root_ == kNil; }
+
+        // item i with absolute offsets and the counts before it
+        [[nodiscard]] ItemSpan at(size_t i) const;
+
+        // index of the first item ending at or after `token`, size() if none
+        [[nodiscard]] size_t first_ending_at_or_after(size_t token) const;
+
+        // index of the first item beginning after `token`, size() if none
+        [[nodiscard]] size_t first_beginning_after(size_t token) const;
+
+        // Replaces items [lo, hi) by `spans`, given in absolute offsets of
+        // the new stream, and moves every later item by `shift` tokens.
+        // Returns the arenas of the removed items, one entry per item.
+        std::vector<const ast::Arena *> replace(size_t lo, size_t hi, std::span<const ItemSpan> spans,
+                                                std::ptrdiff_t shift);
+
+        // all items, in order
+        [[nodiscard]] std::vector<ItemSpan> spans() const;
+
+        // nodes whose aggregates the last replace() recomputed
+        [[nodiscard]] size_t last_touched() const { return touched_; }
+
+    private:
+        static constexpr uint32_t kNil = UINT32_MAX;
+
+        struct Node {
+            uint32_t left{kNil};
+            uint32_t right{kNil};
+            uint32_t priority{0};
+            bool function{false};
+            const ast::Arena *arena{nullptr};
+            // tokens between the previous item's end and this item's begin
+            size_t gap{0};
+            size_t length{0};
+            // subtree aggregates
+            size_t count{1};
+            size_t width{0};
+            size_t functions{0};
+        };
+
+        [[nodiscard]] size_t count(const uint32_t n) const { return n == kNil ? 0 : nodes_[n].count; }
+
+        [[nodiscard]] size_t width(const uint32_t n) const { return n == kNil ? 0 : nodes_[n].width; }
+
+        [[nodiscard]] size_t functions(const uint32_t n) const { return n == kNil ? 0 : nodes_[n].functions; }
+
+        uint32_t make(size_t gap, const ItemSpan &span);
+
+        void update(uint32_t n);
+
+        // first `k` items of `n` and the rest
+        std::pair<uint32_t, uint32_t> split(uint32_t n, size_t k);
+
+        uint32_t merge(uint32_t l, uint32_t r);
+
+        void release(uint32_t n, std::vector<const ast::Arena *> &arenas);
+
+        std::vector<Node> nodes_;
+        std::vector<uint32_t> free_;
+        uint32_t root_{kNil};
+        uint32_t seed_{0x9e3779b9u};
+        size_t touched_{0};
+    };
+}
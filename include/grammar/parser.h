@@ -3,8 +3,17 @@
 //
 
 #pragma once
+#include <concepts>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "item_spans.h"
 #include "symbol.h"
 #include "ast/ast.h"
+#include "token.h"
 
 namespace front::grammar {
     enum ParseAction {
@@ -19,34 +28,159 @@ namespace front::grammar {
     };
 
 
+    struct Diagnostic {
+        Location loc;
+        std::string message;
+    };
+
+
+    // `program` may be a partial tree when the parser recovered from errors;
+    // `success` is only set for an input accepted without any diagnostics
     struct ParseResult {
         ast::ProgramPtr program;
-        std::vector<ParseStep> actions;
         bool success = false;
+        std::vector<Diagnostic> diagnostics;
+    };
+
+    // a parse kept around for incremental reparsing; `items` lists the
+    // top-level items in source order, and `fragment_items` counts the live
+    // items of each arena a reparse added, so an arena is dropped with its
+    // last item
+    struct IncrementalParse {
+        ParseResult result;
+        ItemSpans items;
+        std::unordered_map<const ast::Arena *, size_t> fragment_items;
+    };
+
+    // tokens [begin, old_end) of the previous token stream were replaced by
+    // tokens [begin, new_end) of the new one
+    struct TokenEdit {
+        size_t begin{0};
+        size_t old_end{0};
+        size_t new_end{0};
+    };
+
+    inline const char *action_name(const ParseAction action) {
+        switch (action) {
+            case Move: return "move";
+            case Reduction: return "reduction";
+            case Accept: return "accept";
+            case Error: return "error";
+        }
+        return "error";
+    }
+
+    // A trace sink receives every parse step as it happens. Parsers are
+    // instantiated per sink type, so steps guarded by `Sink::enabled` compile
+    // away entirely for NullTraceSink.
+    template<typename S>
+    concept TraceSink = requires(S &sink, std::string_view name, ParseAction action)
+    {
+        { S::enabled } -> std::convertible_to<bool>;
+        sink.step(name, name, action);
     };
 
+    // sinks that also want the token range and value of every reduction;
+    // parsers only track token positions for these
+    template<typename S>
+    concept ReductionSink = TraceSink<S> && requires(S &sink, size_t n, const ast::SemVal &value)
+    {
+        sink.reduced(n, n, n, value);
+    };
+
+    // Forward-only token input for a parser. `current()` is nullptr past the
+    // end; `position()` counts the tokens consumed so far.
+    template<typename S>
+    concept TokenSource = requires(S &source, const S &const_source)
+    {
+        { source.current() } -> std::same_as<const Token *>;
+        source.advance();
+        { const_source.position() } -> std::convertible_to<size_t>;
+        { const_source.end_location() } -> std::same_as<Location>;
+    };
+
+    // TokenSource over an already lexed token vector
+    class VectorTokenSource {
+    public:
+        explicit VectorTokenSource(const std::vector<Token> &tokens) : tokens_(tokens) {
+        }
+
+        [[nodiscard]] const Token *current() const {
+            return pos_ < tokens_.size() ? &tokens_[pos_] : nullptr;
+        }
+
+        void advance() {
+            if (pos_ < tokens_.size()) ++pos_;
+        }
+
+        [[nodiscard]] size_t position() const { return pos_; }
+
+        [[nodiscard]] Location end_location() const {
+            return tokens_.empty() ? Location{} : tokens_.back().loc;
+        }
+
+    private:
+        const std::vector<Token> &tokens_;
+        size_t pos_{0};
+    };
+
+    struct NullTraceSink {
+        static constexpr bool enabled = false;
+
+        void step(std::string_view, std::string_view, ParseAction) {
+        }
+    };
+
+    // streams steps in the `print_parse_steps` format without buffering them
+    class StreamTraceSink {
+    public:
+        static constexpr bool enabled = true;
+
+        explicit StreamTraceSink(std::ostream &os) : os_(os) {
+        }
+
+        void step(const std::string_view top, const std::string_view lookahead, const ParseAction action) {
+            os_ << ++count_ << '\t' << top << '#' << lookahead << '\t' << action_name(action) << '\n';
+        }
+
+        [[nodiscard]] size_t count() const { return count_; }
+
+    private:
+        std::ostream &os_;
+        size_t count_{0};
+    };
+
+    // collects steps in memory, for callers that inspect the trace afterwards
+    struct VectorTraceSink {
+        static constexpr bool enabled = true;
+
+        std::vector<ParseStep> steps;
+
+        void step(const std::string_view top, const std::string_view lookahead, const ParseAction action) {
+            steps.push_back({
+                Symbol::Terminal(std::string(top)), Symbol::Terminal(std::string(lookahead)), action
+            });
+        }
+    };
+
+    inline std::ostream &print_diagnostics(
+        std::ostream &os,
+        const std::vector<Diagnostic> &diagnostics) {
+        for (const auto &[loc, message]: diagnostics) {
+            os << "Parse Error! at line: " << loc.line << ", col: " << loc.column << '\n';
+            os << message << '\n';
+        }
+
+        return os;
+    }
+
     inline std::ostream &print_parse_steps(
         std::ostream &os,
         const std::vector<ParseStep> &steps) {
         for (size_t i = 0; i < steps.size(); ++i) {
             const auto &[top, lookahead, action] = steps[i];
 
-            os << (i + 1) << '\t' << top << '#' << lookahead << '\t';
-            switch (action) {
-                case Move:
-                    os << "move";
-                    break;
-                case Reduction:
-                    os << "reduction";
-                    break;
-                case Accept:
-                    os << "accept";
-                    break;
-                case Error:
-                    os << "error";
-                    break;
-            }
-            os << '\n';
+            os << (i + 1) << '\t' << top << '#' << lookahead << '\t' << action_name(action) << '\n';
         }
 
         return os;
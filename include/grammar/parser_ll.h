@@ -2,6 +2,10 @@
 // Created by steven on 11/17/25.
 //
 #pragma once
+#include <cstdint>
+#include <iostream>
+#include <string_view>
+
 #include "grammar.h"
 #include "parser.h"
 
@@ -9,6 +13,12 @@
 namespace front::grammar {
     class LL1Parser {
     public:
+        // stack entries: terminal ids as interned by the grammar, nonterminal
+        // ids offset by the number of terminals
+        using SymbolId = uint32_t;
+
+        static constexpr int kNoProduction = -1;
+
         explicit LL1Parser();
 
         explicit LL1Parser(Grammar grammar);
@@ -17,8 +27,17 @@ namespace front::grammar {
 
         std::vector<ParseStep> parse(const std::vector<Token> &tokens) const;
 
+        // returns whether the input was accepted
+        template<TraceSink Sink>
+        bool parse(const std::vector<Token> &tokens, Sink &sink) const;
+
         static std::vector<Token> preprocess_tokens(const std::vector<Token> &tokens);
 
+        // production index chosen for (nonterminal id, terminal id), or kNoProduction
+        [[nodiscard]] int table_entry(const size_t nonterminal, const size_t terminal) const {
+            return table_[nonterminal * n_terminals_ + terminal];
+        }
+
         Grammar grammar_{true};
 
     private:
@@ -26,8 +45,107 @@ namespace front::grammar {
 
         void handle_dangling_else();
 
-        using ActionHash = PairHash<Symbol, Symbol, SymbolHash, SymbolHash>;
+        [[nodiscard]] bool is_terminal(const SymbolId id) const { return id < n_terminals_; }
 
-        std::unordered_map<std::pair<Symbol, Symbol>, Production, ActionHash> parse_table_{};
+        [[nodiscard]] const Symbol &symbol_of(const SymbolId id) const {
+            return is_terminal(id)
+                       ? grammar_.terminal_symbols_[id]
+                       : grammar_.nonterminal_symbols_[id - n_terminals_];
+        }
+
+        size_t n_terminals_{0};
+        SymbolId start_{0};
+
+        // nonterminal × terminal, production index or kNoProduction
+        std::vector<int> table_;
+
+        // right-hand side of production p, reversed and without ε, is
+        // rhs_[rhs_begin_[p], rhs_begin_[p + 1])
+        std::vector<SymbolId> rhs_;
+        std::vector<size_t> rhs_begin_;
     };
+
+
+    template<TraceSink Sink>
+    bool LL1Parser::parse(const std::vector<Token> &tokens, Sink &sink) const {
+        constexpr SymbolId end = 0; // `$`
+
+        std::vector<SymbolId> parse_stack;
+        parse_stack.reserve(64);
+        parse_stack.push_back(end);
+        parse_stack.push_back(start_);
+        size_t curr = 0;
+
+        while (!parse_stack.empty()) {
+            const SymbolId X = parse_stack.back();
+            if (curr >= tokens.size()) {
+                std::cerr << "Parse Error! reached end of input tokens" << std::endl;
+                return false;
+            }
+            const auto &a_token = tokens[curr];
+
+            const TerminalId a = grammar_.terminal_of(a_token);
+            if (a == kNoTerminal) {
+                if constexpr (Sink::enabled) {
+                    sink.step(symbol_of(X).name, a_token.lexeme, Error);
+                }
+                std::cerr << "Parse Error! at line: "
+                        << a_token.loc.line << ", col:" << a_token.loc.column << std::endl;
+                if (a_token.category == TokenCategory::Invalid)
+                    std::cerr << "Unexpected token:" << a_token.lexeme << std::endl;
+                else
+                    std::cerr << "Token not in grammar terminal set: " << a_token << std::endl;
+                return false;
+            }
+
+            if (X == end && a == end) {
+                if constexpr (Sink::enabled) {
+                    sink.step(symbol_of(X).name, symbol_of(a).name, Accept);
+                }
+                return true;
+            }
+
+            if (is_terminal(X)) {
+                if (X == a) {
+                    if constexpr (Sink::enabled) {
+                        sink.step(symbol_of(X).name, symbol_of(a).name, Move);
+                    }
+                    parse_stack.pop_back();
+                    curr++;
+                } else {
+                    if constexpr (Sink::enabled) {
+                        sink.step(symbol_of(X).name, symbol_of(a).name, Error);
+                    }
+                    std::cerr << "Parse Error! at line: "
+                            << a_token.loc.line << ", col:" << a_token.loc.column << std::endl;
+                    std::cerr << "Expected terminal: " << symbol_of(X).name
+                            << ", but got: " << symbol_of(a).name << std::endl;
+                    return false;
+                }
+                continue;
+            }
+
+            const int pid = table_[(X - n_terminals_) * n_terminals_ + a];
+            if (pid == kNoProduction) {
+                if constexpr (Sink::enabled) {
+                    sink.step(symbol_of(X).name, symbol_of(a).name, Error);
+                }
+                std::cerr << "Parse Error! at line: "
+                        << a_token.loc.line << ", col:" << a_token.loc.column << std::endl;
+                std::cerr << "No production found for M[" << symbol_of(X).name << ", "
+                        << symbol_of(a).name << "]" << std::endl;
+                return false;
+            }
+
+            if constexpr (Sink::enabled) {
+                sink.step(symbol_of(X).name, symbol_of(a).name, Reduction);
+            }
+            parse_stack.pop_back();
+            // alpha is stored reversed, so it is pushed as is
+            parse_stack.insert(parse_stack.end(),
+                               rhs_.begin() + static_cast<std::ptrdiff_t>(rhs_begin_[pid]),
+                               rhs_.begin() + static_cast<std::ptrdiff_t>(rhs_begin_[pid + 1]));
+        }
+        return false;
+    }
 }
@@ -0,0 +1,135 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+#include "parser.h"
+#include "token.h"
+// written into the build tree by tools/rdgen.cpp
+#include "grammar/rd_parser.gen.h"
+
+
+namespace front::grammar {
+    // Recursive-descent backend generated from the normalized LL(1) grammar.
+    // It accepts the same language as LL1Parser and emits the same trace, with
+    // the parse table compiled into `switch` statements and the parse stack
+    // replaced by the call stack. Syntax checking only: no AST is built.
+    class RDParser {
+    public:
+        RDParser() {
+            token_ids_.fill(rd::kUnknown);
+            for (const auto &[type, category, terminal]: rd::kTokenTerminals) {
+                token_ids_[static_cast<size_t>(type)] = terminal;
+            }
+        }
+
+        bool parse(const std::vector<Token> &tokens) const {
+            NullTraceSink sink;
+            return parse(tokens, sink);
+        }
+
+        // returns whether the input was accepted
+        template<TraceSink Sink>
+        bool parse(const std::vector<Token> &tokens, Sink &sink) const;
+
+    private:
+        template<TraceSink Sink>
+        class Context;
+
+        // terminal id by TokenType
+        using TokenIds = std::array<uint32_t, kTokenTypeCount>;
+
+        TokenIds token_ids_{};
+    };
+
+
+    // the interface the generated functions are written against
+    template<TraceSink Sink>
+    class RDParser::Context {
+    public:
+        Context(const std::vector<Token> &tokens, const TokenIds &ids,
+                Sink &sink) : tokens_(tokens), ids_(ids), sink_(sink) {
+            lookahead_ = lookup(0);
+        }
+
+        [[nodiscard]] uint32_t peek() const { return lookahead_; }
+
+        void expand(const uint32_t nonterminal) {
+            if constexpr (Sink::enabled) {
+                sink_.step(rd::kNonterminalNames[nonterminal], lookahead_name(), Reduction);
+            }
+        }
+
+        bool match(const uint32_t terminal) {
+            if (lookahead_ != terminal) {
+                if constexpr (Sink::enabled) {
+                    sink_.step(rd::kTerminalNames[terminal], lookahead_name(), Error);
+                }
+                report_location();
+                std::cerr << "Expected terminal: " << rd::kTerminalNames[terminal]
+                        << ", but got: " << lookahead_name() << std::endl;
+                return false;
+            }
+            if constexpr (Sink::enabled) {
+                sink_.step(rd::kTerminalNames[terminal], lookahead_name(), Move);
+            }
+            lookahead_ = lookup(++curr_);
+            return true;
+        }
+
+        bool fail(const uint32_t nonterminal) {
+            if constexpr (Sink::enabled) {
+                sink_.step(rd::kNonterminalNames[nonterminal], lookahead_name(), Error);
+            }
+            report_location();
+            std::cerr << "No production found for M[" << rd::kNonterminalNames[nonterminal] << ", "
+                    << lookahead_name() << "]" << std::endl;
+            return false;
+        }
+
+        bool accept() {
+            if (lookahead_ != rd::kEnd) {
+                return match(rd::kEnd);
+            }
+            if constexpr (Sink::enabled) {
+                sink_.step(rd::kTerminalNames[rd::kEnd], lookahead_name(), Accept);
+            }
+            return true;
+        }
+
+    private:
+        [[nodiscard]] uint32_t lookup(const size_t pos) const {
+            if (pos >= tokens_.size()) return rd::kUnknown;
+            return ids_[static_cast<size_t>(tokens_[pos].type)];
+        }
+
+        [[nodiscard]] std::string_view lookahead_name() const {
+            if (lookahead_ != rd::kUnknown) return rd::kTerminalNames[lookahead_];
+            return curr_ < tokens_.size() ? std::string_view(tokens_[curr_].lexeme) : "EOF";
+        }
+
+        void report_location() const {
+            if (curr_ >= tokens_.size()) {
+                std::cerr << "Parse Error! reached end of input tokens" << std::endl;
+                return;
+            }
+            std::cerr << "Parse Error! at line: "
+                    << tokens_[curr_].loc.line << ", col:" << tokens_[curr_].loc.column << std::endl;
+        }
+
+        const std::vector<Token> &tokens_;
+        const TokenIds &ids_;
+        Sink &sink_;
+        size_t curr_{0};
+        uint32_t lookahead_{rd::kUnknown};
+    };
+
+
+    template<TraceSink Sink>
+    bool RDParser::parse(const std::vector<Token> &tokens, Sink &sink) const {
+        Context<Sink> ctx{tokens, token_ids_, sink};
+        return rd::parse_start(ctx) && ctx.accept();
+    }
+}
@@ -1,7 +1,13 @@
 #pragma once
 #include <algorithm>
+#include <cstdint>
+#include <iostream>
 #include <memory>
+#include <optional>
 #include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
 
 #ifdef USE_MAGIC_ENUM
 #include <magic_enum/magic_enum.hpp>
@@ -18,7 +24,9 @@
 
 namespace front::grammar {
     struct Item {
-        std::shared_ptr<Production> prod;
+        // points into the owning grammar's production list, which is never
+        // resized once a parser has been built from it
+        const Production *prod;
         int dot_pos;
 
         bool operator==(const Item &other) const {
@@ -65,22 +73,22 @@ namespace front::grammar {
 
         ActionType type;
         int target = -1; // state id for Shift, production id for Reduce
-        SLRAction(ActionType type, int target) : type(type), target(target) {
+        constexpr SLRAction(ActionType type, int target) : type(type), target(target) {
         }
 
-        static SLRAction shift(int i) {
+        static constexpr SLRAction shift(int i) {
             return {ActionType::Shift, i};
         }
 
-        static SLRAction reduce(int i) {
+        static constexpr SLRAction reduce(int i) {
             return {ActionType::Reduce, i};
         }
 
-        static SLRAction accept() {
+        static constexpr SLRAction accept() {
             return {ActionType::Accept, -1};
         }
 
-        static SLRAction error() {
+        static constexpr SLRAction error() {
             return {ActionType::Error, -1};
         }
 
@@ -97,9 +105,40 @@ namespace front::grammar {
     };
 
 
+    // what building an SLRParser cost, for benchmarks and regression checks
+    struct SLRBuildStats {
+        double item_sets_ms{0};
+        double tables_ms{0};
+        size_t states{0};
+        size_t action_entries{0};
+        size_t goto_entries{0};
+    };
+
     class SLRParser {
     public:
-        explicit SLRParser(Grammar grammar);
+        // stacks grow geometrically past this, so deep inputs only pay a
+        // logarithmic number of reallocations
+        static constexpr size_t kInitialStackDepth = 64;
+
+        // the LR(0) collection is expanded breadth-first; frontiers of at
+        // least this many states are processed on a thread pool
+        static constexpr size_t kParallelFrontier = 32;
+
+        // `build_threads` caps the workers used to build the item sets:
+        // 0 picks the hardware concurrency, 1 builds serially. The resulting
+        // state numbering is the same for every thread count.
+        explicit SLRParser(Grammar grammar, size_t build_threads = 0);
+
+        // A parser is immutable once built, so one instance can serve any
+        // number of threads at once.
+        SLRParser(const SLRParser &) = delete;
+
+        SLRParser &operator=(const SLRParser &) = delete;
+
+        // process-wide parser for the built-in grammar, built on first use
+        static const SLRParser &shared();
+
+        [[nodiscard]] const SLRBuildStats &build_stats() const { return build_stats_; }
 
 
         void print_item_sets(std::ostream &os) const;
@@ -110,7 +149,47 @@ namespace front::grammar {
 
         void print_goto_table(std::ostream &os) const;
 
-        ParseResult parse(const std::vector<Token> &tokens) const;
+        ParseResult parse(const std::vector<Token> &tokens) const {
+            NullTraceSink sink;
+            return parse(tokens, sink);
+        }
+
+        template<TraceSink Sink>
+        ParseResult parse(const std::vector<Token> &tokens, Sink &sink) const {
+            VectorTokenSource source{tokens};
+            return parse_source(source, sink);
+        }
+
+        // Parses tokens as `source` produces them, e.g. from a
+        // lexer::TokenRing while the lexer is still scanning.
+        template<TokenSource Source, TraceSink Sink>
+        ParseResult parse_source(Source &source, Sink &sink) const;
+
+        template<TokenSource Source>
+        ParseResult parse_source(Source &source) const {
+            NullTraceSink sink;
+            return parse_source(source, sink);
+        }
+
+        // Parses every input concurrently; results are in input order.
+        // `threads` caps the workers, 0 picks the hardware concurrency.
+        std::vector<ParseResult> parse_batch(std::span<const std::vector<Token> > inputs,
+                                             size_t threads = 0) const;
+
+        // full parse that also records the token range of each top-level item
+        IncrementalParse parse_incremental(const std::vector<Token> &tokens) const;
+
+        // Reparses only the top-level items touched by `edit` and splices them
+        // in place between the unchanged subtrees of `previous`, which is
+        // consumed. Item spans are relative to their predecessor, so finding
+        // the touched items and moving the later ones is O(log items); the
+        // later node pointers only move when the edit changes how many
+        // globals or functions there are.
+        // Falls back to a full parse when the previous parse failed, the
+        // grammar has no incremental unit, or the edited region does not parse
+        // on its own.
+        IncrementalParse reparse(IncrementalParse previous, const std::vector<Token> &tokens,
+                                 const TokenEdit &edit) const;
 
     private:
         struct ItemHash {
@@ -130,21 +209,74 @@ namespace front::grammar {
         };
 
 
-        void closure(std::unordered_set<Item, ItemHash> &closure);
+        // GO(I, X) before closure: the sorted kernel items reached on X, and
+        // the target state once the kernel has been looked up or numbered
+        struct Transition {
+            Symbol symbol;
+            std::vector<Item> kernel;
+            int target = -1;
+        };
+
+        void closure(std::unordered_set<Item, ItemHash> &closure) const;
+
+        ItemSetType closure_of(const std::vector<Item> &kernel) const;
 
-        void init_item_set();
+        std::vector<Transition> goto_kernels(const ItemSetType &items) const;
+
+        void init_item_set(size_t threads);
 
         void calc_action_goto_tables();
 
-        static std::vector<Item> make_key(const ItemSetType &items) {
-            std::vector key(items.begin(), items.end());
-            std::ranges::sort(key, std::less{});
-            return key;
+        // Skips input up to the next `;` (consumed), `}` or end of file, then
+        // pops to the innermost state with a GOTO on a recovery nonterminal
+        // that can continue on the new lookahead. `resumed_at` remembers the
+        // previous resume position so an error there cannot loop.
+        // Instantiated in parser_slr.cpp for every TokenSource in the tree.
+        template<TokenSource Source>
+        bool recover(Source &source, size_t &resumed_at,
+                     std::vector<int> &state_stack, std::vector<ast::SemVal> &val_stack) const;
+
+        // grammar name of a token's terminal, for traces only
+        [[nodiscard]] std::string_view terminal_name(const Token &token) const {
+            return grammar_.terminal_symbols_[grammar_.terminal_of(token)].name;
+        }
+
+        [[nodiscard]] const SLRAction &action_at(const int state, const TokenType type) const {
+            return action_rows_[static_cast<size_t>(state) * kTokenTypeCount + static_cast<size_t>(type)];
         }
 
-        std::pair<int, bool> add_state(ItemSetType &&items);
+        [[nodiscard]] int goto_at(const int state, const size_t nonterminal) const {
+            return goto_rows_[static_cast<size_t>(state) * n_nonterminals_ + nonterminal];
+        }
 
-        Grammar grammar_;
+        const Grammar grammar_;
+
+        // per-production reduce data indexed by production id, so the reduce
+        // path never touches the Production objects themselves
+        std::vector<ActionFn> actions_;
+        std::vector<size_t> pop_counts_;
+        // whether the production reduces to the grammar's incremental unit
+        std::vector<char> unit_productions_;
+        // nonterminal id of each production's head
+        std::vector<size_t> heads_;
+        // whether any production has a semantic action; without one a parse
+        // only recognizes, so it needs neither an arena nor token values
+        bool has_actions_{false};
+
+        // ACTION and GOTO flattened to state × token type and state ×
+        // nonterminal rows, so the parse loop indexes with the type the
+        // lexer assigned instead of hashing or mapping it to a terminal;
+        // token types without a terminal and missing GOTO entries are errors
+        // and -1
+        size_t n_nonterminals_{0};
+        std::vector<SLRAction> action_rows_;
+        std::vector<int> goto_rows_;
+
+        // nonterminal ids of grammar_.recovery_points_, and the terminals
+        // panic mode synchronizes on (kNoTerminal when absent)
+        std::vector<size_t> recovery_ids_;
+        TerminalId semicolon_{kNoTerminal};
+        TerminalId right_brace_{kNoTerminal};
 
         struct ItemKeyHash {
             size_t operator()(const std::vector<Item> &items) const {
@@ -157,7 +289,7 @@ namespace front::grammar {
         };
 
         std::vector<ItemSet> item_sets_;
-        // key requires order
+        // states are identified by their sorted kernel items
         std::unordered_map<std::vector<Item>, int, ItemKeyHash> state_id_;
 
         struct GoFuncHash {
@@ -173,5 +305,194 @@ namespace front::grammar {
 
         std::unordered_map<std::pair<int, Symbol>, SLRAction, GoFuncHash> action_table_;
         std::unordered_map<std::pair<int, Symbol>, int, GoFuncHash> goto_table_;
+
+        SLRBuildStats build_stats_;
     };
+
+
+    inline std::string_view trace_lhs_for_token(const Token &tok) {
+        switch (tok.type) {
+            case TokenType::Identifier:
+                return "Ident";
+
+            case TokenType::LiteralInt:
+                return "IntConst";
+
+            case TokenType::LiteralFloat:
+                return "floatConst";
+
+            case TokenType::KwMain:
+                return "Ident";
+
+            default:
+                return tok.lexeme;
+        }
+    }
+
+
+    template<TokenSource Source, TraceSink Sink>
+    ParseResult SLRParser::parse_source(Source &source, Sink &sink) const {
+        // the tree and its names are built in one arena that the program
+        // takes over on accept; declared first so the stacks release into it
+        std::shared_ptr<ast::Arena> arena;
+        std::optional<ast::ArenaScope> arena_scope;
+        if (has_actions_) {
+            arena = std::make_shared<ast::Arena>();
+            arena_scope.emplace(*arena);
+        }
+
+        std::vector<int> state_stack;
+        std::vector<ast::SemVal> val_stack;
+        state_stack.reserve(kInitialStackDepth);
+        val_stack.reserve(kInitialStackDepth);
+        state_stack.push_back(0); // start state
+
+        // token index where each value on the stack starts, kept only for
+        // sinks that want reduction ranges
+        constexpr bool track_positions = ReductionSink<Sink>;
+        [[maybe_unused]] std::vector<size_t> pos_stack;
+        if constexpr (track_positions) {
+            pos_stack.reserve(kInitialStackDepth);
+        }
+
+        ParseResult result;
+        const auto fail = [&](const Location loc, std::string message) {
+            result.diagnostics.push_back({loc, std::move(message)});
+            return std::move(result);
+        };
+
+        // no position yet
+        size_t resumed_at = SIZE_MAX;
+
+        while (!state_stack.empty()) {
+            int s = state_stack.back();
+
+            const Token *current_token = source.current();
+            if (current_token == nullptr) {
+                return fail(source.end_location(), "reached end of input tokens without an end-of-file token");
+            }
+
+            const SLRAction &act = action_at(s, current_token->type);
+
+            if (act.type == SLRAction::ActionType::Error) {
+                if constexpr (Sink::enabled) {
+                    const TerminalId a = grammar_.terminal_of(*current_token);
+                    sink.step("ERROR", a != kNoTerminal
+                                           ? std::string_view(grammar_.terminal_symbols_[a].name)
+                                           : std::string_view(current_token->lexeme), Error);
+                }
+                result.diagnostics.push_back({
+                    current_token->loc, "unexpected symbol: " + current_token->lexeme
+                });
+
+                // panic mode: skip to a synchronizing token and resume after a
+                // placeholder nonterminal; give up only when the input runs out
+                if (!recover(source, resumed_at, state_stack, val_stack)) {
+                    return result;
+                }
+                if constexpr (track_positions) {
+                    // the placeholder stands for everything skipped up to here
+                    pos_stack.resize(val_stack.size() - 1);
+                    pos_stack.push_back(source.position());
+                }
+                continue;
+            }
+
+            switch (act.type) {
+                case SLRAction::ActionType::Shift: {
+                    // Shift
+                    if constexpr (Sink::enabled) {
+                        sink.step(trace_lhs_for_token(*current_token), current_token->lexeme, Move);
+                    }
+                    state_stack.push_back(act.target);
+
+                    val_stack.push_back(has_actions_ ? ast::make_semantic(*current_token) : ast::SemVal{});
+                    if constexpr (track_positions) {
+                        pos_stack.push_back(source.position());
+                    }
+
+                    source.advance();
+                    break;
+                }
+
+                case SLRAction::ActionType::Reduce: {
+                    // Reduce
+                    const auto &prod = grammar_.productions[act.target];
+                    if constexpr (Sink::enabled) {
+                        if (prod.trace.has_value()) {
+                            sink.step(prod.trace->first, prod.trace->second, Reduction);
+                        }
+                    }
+
+                    // pop stack
+                    const size_t pop_count = pop_counts_[act.target];
+                    if (state_stack.size() < pop_count || val_stack.size() < pop_count) {
+                        return fail(current_token->loc, "state stack underflow during reduce");
+                    }
+
+                    // execute semantic action on the top of the value stack in place
+                    const size_t base = val_stack.size() - pop_count;
+                    ast::SemVal new_val{std::monostate{}};
+                    if (const ActionFn action = actions_[act.target]) {
+                        new_val = action(std::span(val_stack).subspan(base));
+                    }
+
+                    state_stack.resize(state_stack.size() - pop_count);
+                    val_stack.erase(val_stack.begin() + static_cast<std::ptrdiff_t>(base), val_stack.end());
+                    if constexpr (track_positions) {
+                        // an ε-reduction starts and ends at the lookahead
+                        const size_t curr = source.position();
+                        const size_t begin = pop_count == 0 ? curr : pos_stack[base];
+                        pos_stack.resize(base);
+                        pos_stack.push_back(begin);
+                        sink.reduced(static_cast<size_t>(act.target), begin, curr, new_val);
+                    }
+
+                    // GOTO
+                    if (state_stack.empty()) {
+                        return fail(current_token->loc, "state stack empty after reduce");
+                    }
+
+                    const int s_prime = state_stack.back();
+                    const int target = goto_at(s_prime, heads_[act.target]);
+
+                    if (target < 0) {
+                        if constexpr (Sink::enabled) {
+                            sink.step(prod.head.name, terminal_name(*current_token), Error);
+                        }
+                        return fail(current_token->loc, "no GOTO entry for state " + std::to_string(s_prime)
+                                                        + " and symbol " + prod.head.name);
+                    }
+
+                    state_stack.push_back(target);
+                    val_stack.push_back(std::move(new_val));
+                    break;
+                }
+
+                case SLRAction::ActionType::Accept: {
+                    if constexpr (Sink::enabled) {
+                        sink.step(grammar_.start_symbol_.name,
+                                  current_token->type == TokenType::EndOfFile ? "EOF" : terminal_name(*current_token),
+                                  Accept);
+                    }
+                    if (!val_stack.empty()) {
+                        if (auto p = std::get_if<ast::ProgramPtr>(&val_stack.back())) {
+                            result.program = std::move(*p);
+                            result.program->arenas.push_back(std::move(arena));
+                        }
+                    }
+                    result.success = result.diagnostics.empty();
+                    return result;
+                }
+                default: {
+                    if constexpr (Sink::enabled) {
+                        sink.step("ERROR", terminal_name(*current_token), Error);
+                    }
+                    return fail(current_token->loc, "invalid action type");
+                }
+            }
+        }
+
+        return result;
+    }
 }
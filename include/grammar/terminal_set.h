@@ -0,0 +1,69 @@
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace front::grammar {
+    // Fixed-universe bitset over interned terminal ids (see Grammar::terminal_symbols_).
+    class TerminalSet {
+    public:
+        TerminalSet() = default;
+
+        explicit TerminalSet(const size_t universe) : words_((universe + 63) / 64, 0) {
+        }
+
+        void insert(const size_t id) {
+            words_[id / 64] |= uint64_t{1} << (id % 64);
+        }
+
+        [[nodiscard]] bool contains(const size_t id) const {
+            return (words_[id / 64] >> (id % 64)) & 1;
+        }
+
+        // this |= other, returns whether any bit was added
+        bool merge(const TerminalSet &other) {
+            bool changed = false;
+            for (size_t i = 0; i < words_.size(); ++i) {
+                const uint64_t merged = words_[i] | other.words_[i];
+                changed |= merged != words_[i];
+                words_[i] = merged;
+            }
+            return changed;
+        }
+
+        [[nodiscard]] bool intersects(const TerminalSet &other) const {
+            for (size_t i = 0; i < words_.size(); ++i) {
+                if (words_[i] & other.words_[i]) return true;
+            }
+            return false;
+        }
+
+        [[nodiscard]] bool empty() const {
+            for (const auto w: words_) {
+                if (w) return false;
+            }
+            return true;
+        }
+
+        [[nodiscard]] size_t size() const {
+            size_t n = 0;
+            for (const auto w: words_) n += std::popcount(w);
+            return n;
+        }
+
+        // calls f(id) for every member in ascending order
+        template<typename F>
+        void for_each(F &&f) const {
+            for (size_t i = 0; i < words_.size(); ++i) {
+                for (uint64_t w = words_[i]; w; w &= w - 1) {
+                    f(i * 64 + static_cast<size_t>(std::countr_zero(w)));
+                }
+            }
+        }
+
+    private:
+        std::vector<uint64_t> words_;
+    };
+}
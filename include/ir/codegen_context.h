@@ -3,6 +3,8 @@
 //
 #pragma once
 
+#include <cstdint>
+#include <deque>
 #include <memory>
 #include <optional>
 #include <string>
@@ -12,6 +14,7 @@
 
 #include "IRbuilder.h"
 #include "ast/ast.h"
+#include "utils/interner.h"
 
 namespace front::ir {
     struct Binding {
@@ -27,10 +30,22 @@ namespace front::ir {
         std::vector<ast::BasicType> param_types;
     };
 
+    // Codegen state is split by lifetime. The module-level context owns the
+    // module, the function declarations and the global bindings. Each
+    // function body is lowered in a context of its own, chained to the
+    // module-level one, which holds its scopes, insert point and block
+    // numbering. Function bodies therefore share nothing mutable but the
+    // module, and can be generated on different threads. Block numbers
+    // still run on across the module: each body starts where the bodies
+    // before it end (see first_block).
     class CodegenContext {
     public:
         explicit CodegenContext(std::unique_ptr<Module> module);
 
+        // a function-body context; lookups fall back to `outer`, which must
+        // not change while this context is in use
+        explicit CodegenContext(CodegenContext &outer);
+
         Module &module();
 
         const Module &module() const;
@@ -45,19 +60,19 @@ namespace front::ir {
 
         void pop_scope();
 
-        void bind(const std::string &name, Binding binding);
+        void bind(SymbolId name, Binding binding);
 
-        Binding *lookup(const std::string &name);
+        Binding *lookup(SymbolId name);
 
-        const Binding *lookup(const std::string &name) const;
+        const Binding *lookup(SymbolId name) const;
 
         Type *to_ir_type(ast::BasicType type) const;
 
         FunctionInfo &declare_function(const ast::FuncDef &def);
 
-        FunctionInfo *find_function(const std::string &name);
+        FunctionInfo *find_function(SymbolId name);
 
-        const FunctionInfo *find_function(const std::string &name) const;
+        const FunctionInfo *find_function(SymbolId name) const;
 
         Value *make_int(int value);
 
@@ -75,14 +90,41 @@ namespace front::ir {
 
         BasicBlock *create_block(std::string_view base_name);
 
+        // the number create_block gives the next block
+        [[nodiscard]] int next_block() const { return block_seq_; }
+
+        void first_block(const int number) { block_seq_ = number; }
+
+        // empty in function-body contexts, which borrow the outer module
         std::unique_ptr<Module> module_ptr;
         std::unique_ptr<IRBuilder> builder_ptr;
         Function *current_function{nullptr};
         std::optional<ast::BasicType> current_return_type{};
 
     private:
-        std::vector<std::unordered_map<std::string, Binding> > scopes_;
-        std::unordered_map<std::string, FunctionInfo> functions_;
+        // All scopes share one table, as in classic compiler symbol tables.
+        // visible_[name] indexes the innermost binding of `name` in
+        // bindings_, and each binding remembers the one it shadows. A scope
+        // owns the bindings pushed since its mark, so popping it undoes just
+        // those, and a lookup is one probe whatever the nesting depth.
+        // visible_ is hashed rather than indexed by SymbolId: ids are
+        // process-wide, and a dense table per function context would cost
+        // O(all interned names) each.
+        struct ScopedBinding {
+            Binding binding;
+            SymbolId name;
+            uint32_t shadowed;
+        };
+
+        static constexpr uint32_t kUnbound = UINT32_MAX;
+
+        Module *module_;
+        CodegenContext *outer_{nullptr};
+        std::unordered_map<SymbolId, uint32_t> visible_;
+        // deque, so Binding pointers handed out stay valid as scopes grow
+        std::deque<ScopedBinding> bindings_;
+        std::vector<size_t> scope_marks_;
+        std::unordered_map<SymbolId, FunctionInfo> functions_;
         int block_seq_{0};
     };
 }
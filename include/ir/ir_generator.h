@@ -2,6 +2,7 @@
 // Created by steven on 12/3/25.
 //
 #pragma once
+#include <cstddef>
 #include <memory>
 
 #include "Module.h"
@@ -14,6 +15,9 @@ namespace front::ir {
             std::unique_ptr<Module> module;
         };
 
-        static Result generate(const ast::ProgramPtr &program);
+        // Folds the program's constant expressions in place, then lowers it,
+        // with function bodies spread over `jobs` threads when that is more
+        // than one. The IR does not depend on `jobs`.
+        static Result generate(const ast::ProgramPtr &program, size_t jobs = 1);
     };
 }
@@ -25,6 +25,14 @@ namespace front::lexer {
 
         std::vector<Token> &tokenize(const std::string &source);
 
+        // replaces the source and rewinds both tokenize() and next(), so the
+        // compiled DFA can be reused
+        void reset(std::string source);
+
+        // Streaming alternative to tokenize(): scans the next token that
+        // tokenize() would keep into `out`. The end-of-file token comes last;
+        // after it, returns false.
+        bool next(Token &out);
 
         void optimize();
 
@@ -35,11 +43,20 @@ namespace front::lexer {
 
     private:
         int row{0}, column{0};
+        // next() state, separate from tokenize()
+        size_t scan_pos_{0};
+        bool emitted_eof_{false};
         std::vector<std::tuple<std::string, TokenType, TokenCategory> > rules;
 
         std::unique_ptr<NFA<Symbol> > init_rules();
 
         void advance(const std::string &lexeme);
+
+        // longest match at `pos`, which is moved past it
+        Token scan(size_t &pos) const;
+
+        // tokens optimize() drops
+        static bool is_discarded(const Token &token);
     };
 
     std::ostream &print_tokens(std::ostream &os, const std::vector<Token> &token);
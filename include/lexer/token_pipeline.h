@@ -0,0 +1,64 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+#include "lexer/lexer.h"
+#include "token.h"
+#include "utils/spsc_queue.h"
+
+
+namespace front::lexer {
+    // Runs a Lexer on its own thread, ahead of the parser: the producer
+    // drains a TokenRing (so the post_process() rewrite is already applied)
+    // into batches handed over through an SpscQueue. Models
+    // grammar::TokenSource on the consuming thread.
+    class TokenPipeline {
+    public:
+        static constexpr size_t kBatchSize = 512;
+        static constexpr size_t kQueueDepth = 16;
+
+        // `lexer` must outlive the pipeline and is used only by its thread
+        explicit TokenPipeline(Lexer &lexer);
+
+        TokenPipeline(const TokenPipeline &) = delete;
+
+        TokenPipeline &operator=(const TokenPipeline &) = delete;
+
+        // stops the producer even if the input was not consumed to the end
+        ~TokenPipeline();
+
+        // nullptr once the end-of-file token has been consumed
+        [[nodiscard]] const Token *current() const {
+            return offset_ < batch_.size() ? &batch_[offset_] : nullptr;
+        }
+
+        // rethrows, on this thread, whatever the lexer threw on its own
+        void advance();
+
+        [[nodiscard]] size_t position() const { return position_; }
+
+        [[nodiscard]] Location end_location() const { return last_loc_; }
+
+    private:
+        void produce(Lexer &lexer);
+
+        // blocks until the next batch arrives; leaves batch_ empty at the end
+        void next_batch();
+
+        SpscQueue<std::vector<Token>, kQueueDepth> queue_;
+        // set by the producer after its last push, by the consumer to stop it
+        std::atomic<bool> produced_all_{false};
+        std::atomic<bool> stop_{false};
+        std::exception_ptr error_;
+
+        std::vector<Token> batch_;
+        size_t offset_{0};
+        size_t position_{0};
+        Location last_loc_{};
+
+        std::thread producer_;
+    };
+}
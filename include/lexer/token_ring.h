@@ -0,0 +1,52 @@
+#pragma once
+#include <array>
+#include <cstddef>
+
+#include "lexer/lexer.h"
+#include "token.h"
+
+
+namespace front::lexer {
+    // Pulls tokens from a Lexer on demand into a fixed-size ring and applies
+    // the function-definition rewrite of post_process() on the way, so a
+    // parser can consume the source while it is still being scanned and no
+    // token vector is ever built. Models grammar::TokenSource.
+    class TokenRing {
+    public:
+        // the current token plus the two post_process() looks ahead at
+        static constexpr size_t kLookahead = 2;
+        static constexpr size_t kCapacity = 4;
+        static_assert(kCapacity > kLookahead && (kCapacity & (kCapacity - 1)) == 0);
+
+        explicit TokenRing(Lexer &lexer);
+
+        // nullptr once the end-of-file token has been consumed
+        [[nodiscard]] const Token *current() const {
+            return size_ == 0 ? nullptr : &slots_[head_];
+        }
+
+        void advance();
+
+        // index of the current token in the equivalent post_process() output
+        [[nodiscard]] size_t position() const { return position_; }
+
+        [[nodiscard]] Location end_location() const { return last_loc_; }
+
+    private:
+        [[nodiscard]] Token &slot(const size_t k) { return slots_[(head_ + k) & (kCapacity - 1)]; }
+
+        void fill();
+
+        // brace tracking and the rewrite, once per token as it becomes current
+        void settle();
+
+        Lexer &lexer_;
+        std::array<Token, kCapacity> slots_{};
+        size_t head_{0};
+        size_t size_{0};
+        size_t position_{0};
+        int brace_depth_{0};
+        bool exhausted_{false};
+        Location last_loc_{};
+    };
+}
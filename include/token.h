@@ -2,6 +2,7 @@
 #include <string>
 #include <ostream>
 
+#include "utils/interner.h"
 #include "utils/util.h"
 #ifdef USE_MAGIC_ENUM
 #include <magic_enum/magic_enum.hpp>
@@ -37,12 +38,16 @@ namespace front {
         KwFloatFunc,
     };
 
+    inline constexpr std::size_t kTokenTypeCount = static_cast<std::size_t>(TokenType::KwFloatFunc) + 1;
+
 
     struct Token {
         TokenType type{TokenType::Invalid};
         TokenCategory category{TokenCategory::Invalid};
         Location loc{};
         std::string lexeme{};
+        // interned lexeme of identifiers (and main), set by the lexer
+        SymbolId symbol{kNoSymbol};
 
         Token() = default;
 
@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace front {
+    // Dense id of an interned identifier; equal names get equal ids, so
+    // symbol tables compare and hash integers instead of strings.
+    using SymbolId = uint32_t;
+
+    inline constexpr SymbolId kNoSymbol = UINT32_MAX;
+
+    // Append-only identifier table shared by the lexer, the AST and codegen.
+    // Lexers on different threads intern concurrently (parse_batch, the
+    // token pipeline), so lookups take a shared lock and only first
+    // sightings of a name take the exclusive one.
+    //
+    // Tokens, trees and IR carry bare SymbolIds, so one process-wide table
+    // (global()) saves threading an interner through every pass. The price:
+    // it only grows, holding every distinct name any compilation in the
+    // process has seen, and each intern() and symbol_name() takes the shared
+    // lock. A single compile (cmm) never notices; a long-lived host that
+    // compiles many unrelated inputs calls reset() between them.
+    class Interner {
+    public:
+        Interner() = default;
+
+        Interner(const Interner &) = delete;
+
+        Interner &operator=(const Interner &) = delete;
+
+        SymbolId intern(std::string_view name);
+
+        // the text of `id`; stays valid as long as the interner
+        [[nodiscard]] std::string_view name(SymbolId id) const;
+
+        [[nodiscard]] size_t size() const;
+
+        // forgets every name; ids handed out before are invalid afterwards,
+        // so no token, tree or module built from them may still be in use
+        void reset();
+
+        // the process-wide table identifiers are interned into
+        static Interner &global();
+
+    private:
+        mutable std::shared_mutex mutex_;
+        // deque keeps each string in place as more are added
+        std::deque<std::string> strings_;
+        std::vector<std::string_view> names_;
+        std::unordered_map<std::string_view, SymbolId> ids_;
+    };
+
+    inline std::string_view symbol_name(const SymbolId id) {
+        return Interner::global().name(id);
+    }
+}
@@ -0,0 +1,17 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace front {
+    using Sha256Digest = std::array<uint8_t, 32>;
+
+    // SHA-256 (FIPS 180-4) of `bytes`. Stable across runs and builds, and
+    // strong enough that equal digests stand in for equal contents in keys
+    // that outlive the process.
+    Sha256Digest sha256(std::string_view bytes);
+
+    // lowercase hex of a digest
+    std::string to_hex(const Sha256Digest &digest);
+}
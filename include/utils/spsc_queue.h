@@ -0,0 +1,49 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace front {
+    // Bounded lock-free queue for exactly one producer thread and one
+    // consumer thread. Each side only writes its own index, so a push or pop
+    // is a couple of atomic loads and one release store.
+    template<typename T, size_t Capacity>
+    class SpscQueue {
+        static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+    public:
+        SpscQueue() = default;
+
+        SpscQueue(const SpscQueue &) = delete;
+
+        SpscQueue &operator=(const SpscQueue &) = delete;
+
+        // producer side; leaves `value` untouched when the queue is full
+        bool try_push(T &value) {
+            const size_t tail = tail_.load(std::memory_order_relaxed);
+            if (tail - head_.load(std::memory_order_acquire) == Capacity) return false;
+            slots_[tail & (Capacity - 1)] = std::move(value);
+            tail_.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        // consumer side
+        bool try_pop(T &out) {
+            const size_t head = head_.load(std::memory_order_relaxed);
+            if (head == tail_.load(std::memory_order_acquire)) return false;
+            out = std::move(slots_[head & (Capacity - 1)]);
+            head_.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+    private:
+        // the two indices live on separate cache lines so the threads do not
+        // invalidate each other on every operation
+        static constexpr size_t kCacheLine = 64;
+
+        alignas(kCacheLine) std::atomic<size_t> head_{0};
+        alignas(kCacheLine) std::atomic<size_t> tail_{0};
+        alignas(kCacheLine) std::array<T, Capacity> slots_{};
+    };
+}
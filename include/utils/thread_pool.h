@@ -0,0 +1,106 @@
+#pragma once
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace front {
+    // Fixed-size pool of worker threads draining a shared FIFO of tasks.
+    // Workers are joined on destruction after the queue has been drained.
+    class ThreadPool {
+    public:
+        explicit ThreadPool(size_t threads = default_threads()) {
+            threads = std::max<size_t>(threads, 1);
+            workers_.reserve(threads);
+            for (size_t i = 0; i < threads; ++i) {
+                workers_.emplace_back([this] { work(); });
+            }
+        }
+
+        ThreadPool(const ThreadPool &) = delete;
+
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        ~ThreadPool() {
+            {
+                std::lock_guard lock(mutex_);
+                stopping_ = true;
+            }
+            cv_.notify_all();
+            for (auto &worker: workers_) {
+                worker.join();
+            }
+        }
+
+        static size_t default_threads() {
+            return std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        [[nodiscard]] size_t size() const { return workers_.size(); }
+
+        template<typename F>
+        auto submit(F &&f) -> std::future<std::invoke_result_t<F> > {
+            using R = std::invoke_result_t<F>;
+            auto task = std::make_shared<std::packaged_task<R()> >(std::forward<F>(f));
+            auto future = task->get_future();
+            {
+                std::lock_guard lock(mutex_);
+                tasks_.emplace([task] { (*task)(); });
+            }
+            cv_.notify_one();
+            return future;
+        }
+
+        // Runs f(i) for every i in [0, n), split into one contiguous chunk per
+        // worker, and blocks until all of them finished. The first exception
+        // thrown by any chunk is rethrown here.
+        template<typename F>
+        void parallel_for(const size_t n, F &&f) {
+            const size_t chunks = std::min(n, size());
+            if (chunks <= 1) {
+                for (size_t i = 0; i < n; ++i) f(i);
+                return;
+            }
+
+            std::vector<std::future<void> > pending;
+            pending.reserve(chunks);
+            for (size_t c = 0; c < chunks; ++c) {
+                const size_t begin = n * c / chunks;
+                const size_t end = n * (c + 1) / chunks;
+                pending.push_back(submit([&f, begin, end] {
+                    for (size_t i = begin; i < end; ++i) f(i);
+                }));
+            }
+            for (auto &p: pending) p.wait();
+            for (auto &p: pending) p.get();
+        }
+
+    private:
+        void work() {
+            while (true) {
+                std::function<void()> task;
+                {
+                    std::unique_lock lock(mutex_);
+                    cv_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+                    if (tasks_.empty()) return;
+                    task = std::move(tasks_.front());
+                    tasks_.pop();
+                }
+                task();
+            }
+        }
+
+        std::vector<std::thread> workers_;
+        std::queue<std::function<void()> > tasks_;
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        bool stopping_{false};
+    };
+}
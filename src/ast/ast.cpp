@@ -2,8 +2,14 @@
 // Created by steven on 12/3/25.
 //
 #include "ast/ast.h"
+#include "ast/walk.h"
 
 namespace front::ast {
+    // tokens built by hand rather than lexed carry no symbol yet
+    static SymbolId symbol_of(const Token &token) {
+        return token.symbol != kNoSymbol ? token.symbol : Interner::global().intern(token.lexeme);
+    }
+
     SemVal make_semantic(const Token &token) {
         using enum TokenType;
         switch (token.type) {
@@ -18,14 +24,14 @@ namespace front::ast {
             case LiteralFloat:
                 return SemVal{std::stof(token.lexeme)};
             case Identifier:
-                return SemVal{token.lexeme};
+                return SemVal{symbol_of(token)};
             case KwIntFunc:
                 return SemVal{BasicType::Int};
             case KwFloatFunc:
                 return SemVal{BasicType::Float};
             case KwMain:
                 // treat main like an identifier so grammar rules expecting Ident work
-                return SemVal{token.lexeme};
+                return SemVal{symbol_of(token)};
             default:
                 return SemVal{std::monostate{}};
         }
@@ -72,174 +78,203 @@ namespace front::ast {
         return "?";
     }
 
-    void print_expr(const Expr *expr, std::ostream &os, int depth);
+    namespace {
+        // Indented tree dump on the explicit-stack walker: entering a node
+        // prints its line at depth_ and indents its children one level; a
+        // labelled slot (Cond, Then, Decl, ...) adds a level of its own.
+        class AstPrinter {
+        public:
+            explicit AstPrinter(std::ostream &os) : os(os) {
+            }
 
-    void print_stmt(const Stmt *stmt, std::ostream &os, int depth);
+            void enter(const LiteralInt &lit) {
+                line() << "LiteralInt " << lit.value << "\n";
+                ++depth_;
+            }
 
-    void print_decl(const Decl *decl, std::ostream &os, int depth);
+            void enter(const LiteralFloat &lit) {
+                line() << "LiteralFloat " << lit.value << "\n";
+                ++depth_;
+            }
 
-    void print_var_init(const VarInit &init, std::ostream &os, int depth) {
-        indent(os, depth);
-        os << init.name;
-        if (init.value) {
-            os << " =\n";
-            print_expr(init.value.get(), os, depth + 1);
-        } else {
-            os << " <uninitialized>\n";
-        }
-    }
+            void enter(const IdentifierExpr &id) {
+                line() << "Identifier " << symbol_name(id.name) << "\n";
+                ++depth_;
+            }
 
-    void print_block(const BlockStmt *block, std::ostream &os, int depth) {
-        indent(os, depth);
-        os << "Block\n";
-        if (!block) {
-            indent(os, depth + 1);
-            os << "<null block>\n";
-            return;
-        }
-        for (const auto &item: block->items) {
-            indent(os, depth + 1);
-            if (item.type == BlockItem::Type::Decl) {
-                os << "Decl\n";
-                print_decl(item.decl.get(), os, depth + 2);
-            } else {
-                os << "Stmt\n";
-                print_stmt(item.stmt.get(), os, depth + 2);
+            void enter(const UnaryExpr &unary) {
+                line() << "Unary " << to_string(unary.op) << "\n";
+                ++depth_;
             }
-        }
-    }
 
-    void print_expr(const Expr *expr, std::ostream &os, int depth) {
-        indent(os, depth);
-        if (!expr) {
-            os << "<null expr>\n";
-            return;
-        }
-        if (const auto *lit = dynamic_cast<const LiteralInt *>(expr)) {
-            os << "LiteralInt " << lit->value << "\n";
-        } else if (const auto *lit = dynamic_cast<const LiteralFloat *>(expr)) {
-            os << "LiteralFloat " << lit->value << "\n";
-        } else if (const auto *id = dynamic_cast<const IdentifierExpr *>(expr)) {
-            os << "Identifier " << id->name << "\n";
-        } else if (const auto *unary = dynamic_cast<const UnaryExpr *>(expr)) {
-            os << "Unary " << to_string(unary->op) << "\n";
-            print_expr(unary->operand.get(), os, depth + 1);
-        } else if (const auto *binary = dynamic_cast<const BinaryExpr *>(expr)) {
-            os << "Binary " << to_string(binary->op) << "\n";
-            print_expr(binary->lhs.get(), os, depth + 1);
-            print_expr(binary->rhs.get(), os, depth + 1);
-        } else if (const auto *call = dynamic_cast<const CallExpr *>(expr)) {
-            os << "Call " << call->callee << "\n";
-            if (call->args.empty()) {
-                indent(os, depth + 1);
-                os << "<no args>\n";
-            } else {
-                for (const auto &arg: call->args) {
-                    print_expr(arg.get(), os, depth + 1);
+            void enter(const BinaryExpr &binary) {
+                line() << "Binary " << to_string(binary.op) << "\n";
+                ++depth_;
+            }
+
+            void enter(const CallExpr &call) {
+                line() << "Call " << symbol_name(call.callee) << "\n";
+                ++depth_;
+                if (call.args.empty()) {
+                    line() << "<no args>\n";
                 }
             }
-        } else {
-            os << "<unknown expr>\n";
-        }
-    }
 
-    void print_stmt(const Stmt *stmt, std::ostream &os, int depth) {
-        if (const auto *block = dynamic_cast<const BlockStmt *>(stmt)) {
-            print_block(block, os, depth);
-            return;
-        }
-        indent(os, depth);
-        if (!stmt) {
-            os << "<null stmt>\n";
-            return;
-        }
-        if (dynamic_cast<const EmptyStmt *>(stmt)) {
-            os << "EmptyStmt\n";
-        } else if (const auto *expr_stmt = dynamic_cast<const ExprStmt *>(stmt)) {
-            os << "ExprStmt\n";
-            print_expr(expr_stmt->expr.get(), os, depth + 1);
-        } else if (const auto *assign = dynamic_cast<const AssignStmt *>(stmt)) {
-            os << "Assign " << assign->target << "\n";
-            print_expr(assign->expr.get(), os, depth + 1);
-        } else if (const auto *ret = dynamic_cast<const ReturnStmt *>(stmt)) {
-            os << "Return\n";
-            if (ret->value) {
-                print_expr(ret->value.get(), os, depth + 1);
-            } else {
-                indent(os, depth + 1);
-                os << "<void>\n";
-            }
-        } else if (const auto *ifs = dynamic_cast<const IfStmt *>(stmt)) {
-            os << "If\n";
-            indent(os, depth + 1);
-            os << "Cond\n";
-            print_expr(ifs->condition.get(), os, depth + 2);
-            indent(os, depth + 1);
-            os << "Then\n";
-            print_stmt(ifs->then_branch.get(), os, depth + 2);
-            if (ifs->else_branch) {
-                indent(os, depth + 1);
-                os << "Else\n";
-                print_stmt(ifs->else_branch.get(), os, depth + 2);
-            }
-        } else {
-            os << "<unknown stmt>\n";
-        }
-    }
+            void enter(const EmptyStmt &) {
+                line() << "EmptyStmt\n";
+                ++depth_;
+            }
 
-    void print_decl(const Decl *decl, std::ostream &os, int depth) {
-        indent(os, depth);
-        if (!decl) {
-            os << "<null decl>\n";
-            return;
-        }
-        if (const auto *var = dynamic_cast<const VarDecl *>(decl)) {
-            os << (var->is_const ? "ConstDecl " : "VarDecl ")
-                    << to_string(var->type) << "\n";
-            for (const auto &item: var->items) {
-                print_var_init(item, os, depth + 1);
-            }
-        } else {
-            os << "<unknown decl>\n";
-        }
-    }
+            void enter(const ExprStmt &) {
+                line() << "ExprStmt\n";
+                ++depth_;
+            }
 
-    void print_params(const std::vector<Param> &params, std::ostream &os, int depth) {
-        if (params.empty()) {
-            indent(os, depth);
-            os << "<none>\n";
-            return;
-        }
-        for (const auto &p: params) {
-            indent(os, depth);
-            os << to_string(p.type) << " " << p.name << "\n";
-        }
-    }
+            void enter(const AssignStmt &assign) {
+                line() << "Assign " << symbol_name(assign.target) << "\n";
+                ++depth_;
+            }
 
-    void print_func(const FuncDef &func, std::ostream &os, int depth) {
-        indent(os, depth);
-        os << "Func " << to_string(func.type) << " " << func.name << "\n";
-        indent(os, depth + 1);
-        os << "Params\n";
-        print_params(func.params, os, depth + 2);
-        indent(os, depth + 1);
-        os << "Body\n";
-        print_block(func.body.get(), os, depth + 2);
-    }
+            void enter(const ReturnStmt &ret) {
+                line() << "Return\n";
+                ++depth_;
+                if (!ret.value) {
+                    line() << "<void>\n";
+                }
+            }
 
+            void enter(const IfStmt &) {
+                line() << "If\n";
+                ++depth_;
+            }
+
+            void before_child(const IfStmt &ifs, const uint32_t i) {
+                if (i == 0) {
+                    line() << "Cond\n";
+                    ++depth_;
+                    if (!ifs.condition) line() << "<null expr>\n";
+                } else if (i == 1) {
+                    line() << "Then\n";
+                    ++depth_;
+                    if (!ifs.then_branch) line() << "<null stmt>\n";
+                } else if (ifs.else_branch) {
+                    line() << "Else\n";
+                    ++depth_;
+                }
+            }
+
+            void after_child(const IfStmt &ifs, const uint32_t i) {
+                if (i < 2 || ifs.else_branch) {
+                    --depth_;
+                }
+            }
+
+            void enter(const BlockStmt &) {
+                line() << "Block\n";
+                ++depth_;
+            }
+
+            void before_child(const BlockStmt &block, const uint32_t i) {
+                const auto &item = block.items[i];
+                if (item.type == BlockItem::Type::Decl) {
+                    line() << "Decl\n";
+                    ++depth_;
+                    if (!item.decl) line() << "<null decl>\n";
+                } else {
+                    line() << "Stmt\n";
+                    ++depth_;
+                    if (!item.stmt) line() << "<null stmt>\n";
+                }
+            }
+
+            void enter(const VarDecl &var) {
+                line() << (var.is_const ? "ConstDecl " : "VarDecl ") << to_string(var.type) << "\n";
+                ++depth_;
+            }
+
+            void before_child(const VarDecl &var, const uint32_t i) {
+                const auto &init = var.items[i];
+                line() << symbol_name(init.name) << (init.value ? " =\n" : " <uninitialized>\n");
+                ++depth_;
+            }
+
+            void enter(const FuncDef &func) {
+                line() << "Func " << to_string(func.type) << " " << symbol_name(func.name) << "\n";
+                ++depth_;
+                line() << "Params\n";
+                ++depth_;
+                if (func.params.empty()) {
+                    line() << "<none>\n";
+                }
+                for (const auto &p: func.params) {
+                    line() << to_string(p.type) << " " << symbol_name(p.name) << "\n";
+                }
+                --depth_;
+            }
+
+            void before_child(const FuncDef &func, uint32_t) {
+                line() << "Body\n";
+                ++depth_;
+                if (!func.body) {
+                    line() << "Block\n";
+                    indent(os, depth_ + 1);
+                    os << "<null block>\n";
+                }
+            }
+
+            void enter(const Program &) {
+                line() << "Program\n";
+                ++depth_;
+            }
+
+            void before_child(const Program &program, const uint32_t i) {
+                if (i < program.globals.size()) {
+                    line() << "GlobalDecl\n";
+                    ++depth_;
+                    if (!program.globals[i]) line() << "<null decl>\n";
+                } else {
+                    line() << "Function\n";
+                    ++depth_;
+                }
+            }
+
+            // a slot that must hold an expression
+            template<typename T>
+            void before_child(const T &node, const uint32_t i) {
+                if (!slot(node, i)) {
+                    line() << "<null expr>\n";
+                }
+            }
+
+            void before_child(const ReturnStmt &, uint32_t) {
+            }
+
+            // labelled slots close their extra level
+            template<typename T> requires std::is_same_v<T, BlockStmt> || std::is_same_v<T, VarDecl>
+                                          || std::is_same_v<T, FuncDef> || std::is_same_v<T, Program>
+            void after_child(const T &, uint32_t) {
+                --depth_;
+            }
+
+            template<typename T>
+            void leave(const T &) {
+                --depth_;
+            }
+
+        private:
+            std::ostream &os;
+            int depth_{0};
+
+            std::ostream &line() {
+                indent(os, depth_);
+                return os;
+            }
+        };
+    }
 
     void print_ast(const Program &program, std::ostream &os) {
-        os << "Program\n";
-        for (const auto &decl: program.globals) {
-            indent(os, 1);
-            os << "GlobalDecl\n";
-            print_decl(decl.get(), os, 2);
-        }
-        for (const auto &func: program.functions) {
-            indent(os, 1);
-            os << "Function\n";
-            print_func(*func, os, 2);
-        }
+        AstPrinter printer(os);
+        walk(program, printer);
     }
 
     void print_ast(const ProgramPtr &program, std::ostream &os) {
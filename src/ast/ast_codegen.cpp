@@ -2,10 +2,13 @@
 // AST-driven LLVM-like IR generation.
 //
 #include "ast/ast.h"
+#include "ast/walk.h"
 #include "ir/codegen_context.h"
+#include "utils/thread_pool.h"
 
 #include <optional>
 #include <stdexcept>
+#include <unordered_set>
 #include <utility>
 
 #include "BasicBlock.h"
@@ -19,128 +22,26 @@
 namespace front::ir {
     using namespace ast;
 
-    struct ScopeGuard {
-        CodegenContext &ctx;
-        bool active{true};
-
-        explicit ScopeGuard(CodegenContext &ctx) : ctx(ctx) {
-            ctx.push_scope();
-        }
-
-        ~ScopeGuard() {
-            if (active) {
-                ctx.pop_scope();
-            }
-        }
-
-        void release() { active = false; }
-    };
-
     bool has_terminator(BasicBlock *bb) {
         return bb && bb->get_terminator() != nullptr;
     }
 
-    std::optional<int> eval_int_constant(const Expr *expr) {
-        if (const auto *lit = dynamic_cast<const LiteralInt *>(expr)) {
-            return lit->value;
-        }
-        if (const auto *unary = dynamic_cast<const UnaryExpr *>(expr)) {
-            auto inner = eval_int_constant(unary->operand.get());
-            if (!inner) {
-                return std::nullopt;
-            }
-            switch (unary->op) {
-                case UnaryOp::Positive:
-                    return *inner;
-                case UnaryOp::Negative:
-                    return -*inner;
-                case UnaryOp::LogicalNot:
-                    return *inner == 0 ? 1 : 0;
-            }
-        }
-        if (const auto *binary = dynamic_cast<const BinaryExpr *>(expr)) {
-            auto lhs = eval_int_constant(binary->lhs.get());
-            auto rhs = eval_int_constant(binary->rhs.get());
-            if (!lhs || !rhs) {
-                return std::nullopt;
-            }
-            switch (binary->op) {
-                case BasicOp::Add: return *lhs + *rhs;
-                case BasicOp::Sub: return *lhs - *rhs;
-                case BasicOp::Mul: return *lhs * *rhs;
-                case BasicOp::Div: return *rhs == 0 ? 0 : *lhs / *rhs;
-                case BasicOp::Mod: return *rhs == 0 ? 0 : *lhs % *rhs;
-                case BasicOp::Lt: return *lhs < *rhs;
-                case BasicOp::Gt: return *lhs > *rhs;
-                case BasicOp::Le: return *lhs <= *rhs;
-                case BasicOp::Ge: return *lhs >= *rhs;
-                case BasicOp::Eq: return *lhs == *rhs;
-                case BasicOp::Neq: return *lhs != *rhs;
-                case BasicOp::And: return (*lhs != 0) && (*rhs != 0);
-                case BasicOp::Or: return (*lhs != 0) || (*rhs != 0);
-            }
-        }
-        return std::nullopt;
-    }
-
-    std::optional<float> eval_float_constant(const Expr *expr) {
-        if (const auto *lit = dynamic_cast<const LiteralFloat *>(expr)) {
-            return lit->value;
-        }
-        if (const auto *lit_int = dynamic_cast<const LiteralInt *>(expr)) {
-            return static_cast<float>(lit_int->value);
-        }
-        if (const auto *unary = dynamic_cast<const UnaryExpr *>(expr)) {
-            auto inner = eval_float_constant(unary->operand.get());
-            if (!inner) {
-                return std::nullopt;
-            }
-            switch (unary->op) {
-                case UnaryOp::Positive:
-                    return *inner;
-                case UnaryOp::Negative:
-                    return -*inner;
-                case UnaryOp::LogicalNot:
-                    return *inner == 0.0f ? 1.0f : 0.0f;
-            }
-        }
-        if (const auto *binary = dynamic_cast<const BinaryExpr *>(expr)) {
-            auto lhs = eval_float_constant(binary->lhs.get());
-            auto rhs = eval_float_constant(binary->rhs.get());
-            if (!lhs || !rhs) {
-                return std::nullopt;
-            }
-            switch (binary->op) {
-                case BasicOp::Add: return *lhs + *rhs;
-                case BasicOp::Sub: return *lhs - *rhs;
-                case BasicOp::Mul: return *lhs * *rhs;
-                case BasicOp::Div: return *rhs == 0.0f ? 0.0f : *lhs / *rhs;
-                case BasicOp::Mod: return std::nullopt;
-                case BasicOp::Lt: return *lhs < *rhs ? 1.0f : 0.0f;
-                case BasicOp::Gt: return *lhs > *rhs ? 1.0f : 0.0f;
-                case BasicOp::Le: return *lhs <= *rhs ? 1.0f : 0.0f;
-                case BasicOp::Ge: return *lhs >= *rhs ? 1.0f : 0.0f;
-                case BasicOp::Eq: return *lhs == *rhs ? 1.0f : 0.0f;
-                case BasicOp::Neq: return *lhs != *rhs ? 1.0f : 0.0f;
-                case BasicOp::And: return (*lhs != 0.0f) && (*rhs != 0.0f) ? 1.0f : 0.0f;
-                case BasicOp::Or: return (*lhs != 0.0f) || (*rhs != 0.0f) ? 1.0f : 0.0f;
-            }
-        }
-        return std::nullopt;
+    CodegenContext::CodegenContext(std::unique_ptr<Module> module)
+        : module_ptr(std::move(module)), module_(module_ptr.get()) {
+        push_scope();
     }
 
-
-    CodegenContext::CodegenContext(std::unique_ptr<Module> module)
-        : module_ptr(std::move(module)) {
+    CodegenContext::CodegenContext(CodegenContext &outer)
+        : module_(outer.module_), outer_(&outer) {
         push_scope();
     }
 
     Module &CodegenContext::module() {
-        return *module_ptr;
+        return *module_;
     }
 
     const Module &CodegenContext::module() const {
-        return *module_ptr;
+        return *module_;
     }
 
     IRBuilder &CodegenContext::builder() const {
@@ -158,63 +59,78 @@ namespace front::ir {
         if (builder_ptr) {
             builder_ptr->set_insert_point(block);
         } else {
-            builder_ptr = std::make_unique<IRBuilder>(block, module_ptr.get());
+            builder_ptr = std::make_unique<IRBuilder>(block, module_);
         }
     }
 
     void CodegenContext::push_scope() {
-        scopes_.emplace_back();
+        scope_marks_.push_back(bindings_.size());
     }
 
     void CodegenContext::pop_scope() {
-        if (scopes_.empty()) {
+        if (scope_marks_.empty()) {
             throw std::runtime_error("Attempted to pop an empty scope stack");
         }
-        scopes_.pop_back();
+        // undo the scope's bindings newest first, uncovering what they shadowed
+        const size_t mark = scope_marks_.back();
+        scope_marks_.pop_back();
+        while (bindings_.size() > mark) {
+            const auto &top = bindings_.back();
+            if (top.shadowed == kUnbound) {
+                visible_.erase(top.name);
+            } else {
+                visible_[top.name] = top.shadowed;
+            }
+            bindings_.pop_back();
+        }
     }
 
-    void CodegenContext::bind(const std::string &name, Binding binding) {
-        if (scopes_.empty()) {
-            throw std::runtime_error("No active scope to bind variable " + name);
+    void CodegenContext::bind(SymbolId name, Binding binding) {
+        if (scope_marks_.empty()) {
+            throw std::runtime_error("No active scope to bind variable " + std::string(symbol_name(name)));
+        }
+        auto [it, fresh] = visible_.try_emplace(name, kUnbound);
+        const uint32_t current = it->second;
+        if (!fresh && current >= scope_marks_.back()) {
+            // redeclared in the same scope
+            bindings_[current].binding = binding;
+            return;
         }
-        scopes_.back()[name] = binding;
+        it->second = static_cast<uint32_t>(bindings_.size());
+        bindings_.push_back({binding, name, current});
     }
 
-    Binding *CodegenContext::lookup(const std::string &name) {
-        for (auto it = scopes_.rbegin(); it != scopes_.rend(); ++it) {
-            auto found = it->find(name);
-            if (found != it->end()) {
-                return &found->second;
-            }
+    Binding *CodegenContext::lookup(SymbolId name) {
+        const auto it = visible_.find(name);
+        if (it == visible_.end()) {
+            return outer_ ? outer_->lookup(name) : nullptr;
         }
-        return nullptr;
+        return &bindings_[it->second].binding;
     }
 
-    const Binding *CodegenContext::lookup(const std::string &name) const {
-        for (auto it = scopes_.rbegin(); it != scopes_.rend(); ++it) {
-            auto found = it->find(name);
-            if (found != it->end()) {
-                return &found->second;
-            }
+    const Binding *CodegenContext::lookup(SymbolId name) const {
+        const auto it = visible_.find(name);
+        if (it == visible_.end()) {
+            return outer_ ? std::as_const(*outer_).lookup(name) : nullptr;
         }
-        return nullptr;
+        return &bindings_[it->second].binding;
     }
 
     Type *CodegenContext::to_ir_type(BasicType type) const {
         switch (type) {
             case BasicType::Int:
-                return module_ptr->get_int32_type();
+                return module_->get_int32_type();
             case BasicType::Void:
-                return module_ptr->get_void_type();
+                return module_->get_void_type();
             case BasicType::Float:
-                return module_ptr->get_float_type();
+                return module_->get_float_type();
         }
         throw std::runtime_error("Unsupported basic type");
     }
 
     FunctionInfo &CodegenContext::declare_function(const FuncDef &def) {
-        if (const auto existing = functions_.find(def.name); existing != functions_.end()) {
-            return existing->second;
+        if (auto *existing = find_function(def.name)) {
+            return *existing;
         }
 
         FunctionInfo info{};
@@ -229,44 +145,54 @@ namespace front::ir {
         }
 
         const auto func_type = FunctionType::get(to_ir_type(def.type), param_types);
-        info.function = Function::create(func_type, def.name, module_ptr.get());
+        info.function = Function::create(func_type, std::string(symbol_name(def.name)), module_);
         const auto [it, inserted] = functions_.emplace(def.name, std::move(info));
         if (!inserted) {
-            throw std::runtime_error("Failed to insert function: " + def.name);
+            throw std::runtime_error("Failed to insert function: " + std::string(symbol_name(def.name)));
         }
         return it->second;
     }
 
-    FunctionInfo *CodegenContext::find_function(const std::string &name) {
+    FunctionInfo *CodegenContext::find_function(SymbolId name) {
         if (const auto it = functions_.find(name); it != functions_.end()) {
             return &it->second;
         }
-        return nullptr;
+        return outer_ ? outer_->find_function(name) : nullptr;
     }
 
-    const FunctionInfo *CodegenContext::find_function(const std::string &name) const {
+    const FunctionInfo *CodegenContext::find_function(SymbolId name) const {
         if (auto it = functions_.find(name); it != functions_.end()) {
             return &it->second;
         }
-        return nullptr;
+        return outer_ ? std::as_const(*outer_).find_function(name) : nullptr;
     }
 
     Value *CodegenContext::make_int(int value) {
-        return ConstantInt::get(value, module_ptr.get());
+        return ConstantInt::get(value, module_);
     }
 
     Value *CodegenContext::make_float(float value) {
-        return ConstantFloat::get(value, module_ptr.get());
+        return ConstantFloat::get(value, module_);
     }
 
     Value *CodegenContext::make_bool(bool value) const {
-        return ConstantInt::get(value, module_ptr.get());
+        return ConstantInt::get(value, module_);
     }
 
     Value *CodegenContext::as_bool(Value *value) {
         if (value->get_type()->is_int1_type()) {
             return value;
         }
+        // conversions of constants fold here rather than emit instructions;
+        // the kind tag picks them out without RTTI
+        switch (value->get_value_kind()) {
+            case ValueKind::ConstantInt:
+                return make_bool(static_cast<ConstantInt *>(value)->get_value() != 0);
+            case ValueKind::ConstantFloat:
+                return make_bool(static_cast<ConstantFloat *>(value)->get_value() != 0.0f);
+            default:
+                break;
+        }
         if (value->get_type()->is_int32_type()) {
             return builder().create_icmp_ne(value, make_int(0));
         }
@@ -280,11 +206,19 @@ namespace front::ir {
         if (value->get_type()->is_int32_type()) {
             return value;
         }
+        switch (value->get_value_kind()) {
+            case ValueKind::ConstantInt:
+                return make_int(static_cast<ConstantInt *>(value)->get_value());
+            case ValueKind::ConstantFloat:
+                return make_int(static_cast<int>(static_cast<ConstantFloat *>(value)->get_value()));
+            default:
+                break;
+        }
         if (value->get_type()->is_int1_type()) {
-            return builder().create_zext(value, module_ptr->get_int32_type());
+            return builder().create_zext(value, module_->get_int32_type());
         }
         if (value->get_type()->is_float_type()) {
-            return builder().create_fptosi(value, module_ptr->get_int32_type());
+            return builder().create_fptosi(value, module_->get_int32_type());
         }
         throw std::runtime_error("Cannot convert value to int32");
     }
@@ -293,12 +227,15 @@ namespace front::ir {
         if (value->get_type()->is_float_type()) {
             return value;
         }
+        if (value->get_value_kind() == ValueKind::ConstantInt) {
+            return make_float(static_cast<float>(static_cast<ConstantInt *>(value)->get_value()));
+        }
         if (value->get_type()->is_int32_type()) {
-            return builder().create_sitofp(value, module_ptr->get_float_type());
+            return builder().create_sitofp(value, module_->get_float_type());
         }
         if (value->get_type()->is_int1_type()) {
-            auto *widen = builder().create_zext(value, module_ptr->get_int32_type());
-            return builder().create_sitofp(widen, module_ptr->get_float_type());
+            auto *widen = builder().create_zext(value, module_->get_int32_type());
+            return builder().create_sitofp(widen, module_->get_float_type());
         }
         throw std::runtime_error("Cannot convert value to float");
     }
@@ -325,54 +262,46 @@ namespace front::ir {
         std::string name(base_name);
         name += ".";
         name += std::to_string(block_seq_++);
-        return BasicBlock::create(module_ptr.get(), name, current_function);
+        return BasicBlock::create(module_, name, current_function);
     }
 }
 
-namespace front::ast {
-    using namespace ir;
-
-    Value *LiteralInt::codegen(CodegenContext &ctx) {
-        return ctx.make_int(value);
-    }
+namespace front::ir {
+    // Lowers the AST to IR in one explicit-stack walk (see ast/walk.h), so
+    // nesting depth never grows the call stack. Expressions leave their
+    // value on values_; a node whose control flow spans its children keeps
+    // its blocks on a side stack until it is left.
+    class CodegenPass {
+    public:
+        explicit CodegenPass(CodegenContext &ctx) : ctx(ctx) {
+        }
 
-    Value *LiteralFloat::codegen(CodegenContext &ctx) {
-        return ctx.make_float(value);
-    }
+        void leave(const LiteralInt &lit) {
+            values_.push_back(ctx.make_int(lit.value));
+        }
 
-    Value *IdentifierExpr::codegen(CodegenContext &ctx) {
-        auto *binding = ctx.lookup(name);
-        if (!binding) {
-            throw std::runtime_error("Undefined identifier: " + name);
+        void leave(const LiteralFloat &lit) {
+            values_.push_back(ctx.make_float(lit.value));
         }
-        return ctx.builder().create_load(binding->address);
-    }
 
-    Value *UnaryExpr::codegen(CodegenContext &ctx) {
-        auto *operand_val = operand->codegen(ctx);
-        const bool is_float = operand_val->get_type()->is_float_type();
-        switch (op) {
-            case UnaryOp::Positive:
-                return is_float ? ctx.as_float(operand_val) : ctx.as_int(operand_val);
-            case UnaryOp::Negative: {
-                if (is_float) {
-                    auto *zero = ctx.make_float(0.0f);
-                    return ctx.builder().create_fsub(zero, ctx.as_float(operand_val));
-                }
-                auto *zero = ctx.make_int(0);
-                return ctx.builder().create_isub(zero, ctx.as_int(operand_val));
-            }
-            case UnaryOp::LogicalNot: {
-                auto *cond = ctx.as_bool(operand_val);
-                return ctx.builder().create_icmp_eq(cond, ctx.make_bool(false));
+        void leave(const IdentifierExpr &id) {
+            auto *binding = ctx.lookup(id.name);
+            if (!binding) {
+                throw std::runtime_error("Undefined identifier: " + std::string(symbol_name(id.name)));
             }
+            values_.push_back(ctx.builder().create_load(binding->address));
         }
-        throw std::runtime_error("Unhandled unary op");
-    }
 
-    Value *BinaryExpr::codegen(CodegenContext &ctx) {
-        if (op == BasicOp::And || op == BasicOp::Or) {
-            auto *lhs_cond = ctx.as_bool(lhs->codegen(ctx));
+        void leave(const UnaryExpr &unary) {
+            values_.push_back(unary_op(unary.op, pop()));
+        }
+
+        void after_child(const BinaryExpr &binary, const uint32_t i) {
+            const auto op = binary.op;
+            if (i != 0 || (op != BasicOp::And && op != BasicOp::Or)) {
+                return;
+            }
+            auto *lhs_cond = ctx.as_bool(pop());
             auto *origin_block = ctx.builder().get_insert_block();
             auto *rhs_block = ctx.create_block(op == BasicOp::And ? "and.rhs" : "or.rhs");
             auto *merge_block = ctx.create_block(op == BasicOp::And ? "and.merge" : "or.merge");
@@ -384,273 +313,402 @@ namespace front::ast {
             }
 
             ctx.set_insert_point(rhs_block);
-            auto *rhs_cond = ctx.as_bool(rhs->codegen(ctx));
-            ctx.builder().create_br(merge_block);
-            auto *rhs_end = ctx.builder().get_insert_block();
-
-            ctx.set_insert_point(merge_block);
-            auto *phi = PhiInst::create_phi(ctx.module().get_int1_type(), merge_block);
-            merge_block->add_instr_begin(phi);
-            if (op == BasicOp::And) {
-                phi->add_phi_pair_operand(rhs_cond, rhs_end);
-                phi->add_phi_pair_operand(ctx.make_bool(false), origin_block);
-            } else {
-                phi->add_phi_pair_operand(ctx.make_bool(true), origin_block);
-                phi->add_phi_pair_operand(rhs_cond, rhs_end);
+            short_circuits_.push_back({origin_block, merge_block});
+        }
+
+        void leave(const BinaryExpr &binary) {
+            const auto op = binary.op;
+            if (op == BasicOp::And || op == BasicOp::Or) {
+                const auto [origin_block, merge_block] = short_circuits_.back();
+                short_circuits_.pop_back();
+                auto *rhs_cond = ctx.as_bool(pop());
+                ctx.builder().create_br(merge_block);
+                auto *rhs_end = ctx.builder().get_insert_block();
+
+                ctx.set_insert_point(merge_block);
+                auto *phi = PhiInst::create_phi(ctx.module().get_int1_type(), merge_block);
+                merge_block->add_instr_begin(phi);
+                if (op == BasicOp::And) {
+                    phi->add_phi_pair_operand(rhs_cond, rhs_end);
+                    phi->add_phi_pair_operand(ctx.make_bool(false), origin_block);
+                } else {
+                    phi->add_phi_pair_operand(ctx.make_bool(true), origin_block);
+                    phi->add_phi_pair_operand(rhs_cond, rhs_end);
+                }
+                values_.push_back(phi);
+                return;
             }
-            return phi;
+            auto *rhs_val = pop();
+            auto *lhs_val = pop();
+            values_.push_back(binary_op(op, lhs_val, rhs_val));
         }
 
-        auto *lhs_val = lhs->codegen(ctx);
-        auto *rhs_val = rhs->codegen(ctx);
-        const bool use_float = lhs_val->get_type()->is_float_type() || rhs_val->get_type()->is_float_type();
-        if (use_float) {
-            auto *lhs_f = ctx.as_float(lhs_val);
-            auto *rhs_f = ctx.as_float(rhs_val);
-            switch (op) {
-                case BasicOp::Add:
-                    return ctx.builder().create_fadd(lhs_f, rhs_f);
-                case BasicOp::Sub:
-                    return ctx.builder().create_fsub(lhs_f, rhs_f);
-                case BasicOp::Mul:
-                    return ctx.builder().create_fmul(lhs_f, rhs_f);
-                case BasicOp::Div:
-                    return ctx.builder().create_fdiv(lhs_f, rhs_f);
-                case BasicOp::Mod:
-                    throw std::runtime_error("Modulo is not supported for float");
-                case BasicOp::Lt:
-                    return ctx.builder().create_icmp_lt(lhs_f, rhs_f);
-                case BasicOp::Gt:
-                    return ctx.builder().create_icmp_gt(lhs_f, rhs_f);
-                case BasicOp::Le:
-                    return ctx.builder().create_icmp_le(lhs_f, rhs_f);
-                case BasicOp::Ge:
-                    return ctx.builder().create_icmp_ge(lhs_f, rhs_f);
-                case BasicOp::Eq:
-                    return ctx.builder().create_icmp_eq(lhs_f, rhs_f);
-                case BasicOp::Neq:
-                    return ctx.builder().create_icmp_ne(lhs_f, rhs_f);
-                case BasicOp::And:
-                case BasicOp::Or:
-                    break;
+        void enter(const CallExpr &call) {
+            auto *info = ctx.find_function(call.callee);
+            if (!info) {
+                throw std::runtime_error("Unknown function: " + std::string(symbol_name(call.callee)));
             }
+            if (info->param_types.size() != call.args.size()) {
+                throw std::runtime_error("Argument count mismatch for " + std::string(symbol_name(call.callee)));
+            }
+            calls_.push_back(info);
         }
-        switch (op) {
-            case BasicOp::Add:
-                return ctx.builder().create_iadd(ctx.as_int(lhs_val), ctx.as_int(rhs_val));
-            case BasicOp::Sub:
-                return ctx.builder().create_isub(ctx.as_int(lhs_val), ctx.as_int(rhs_val));
-            case BasicOp::Mul:
-                return ctx.builder().create_imul(ctx.as_int(lhs_val), ctx.as_int(rhs_val));
-            case BasicOp::Div:
-                return ctx.builder().create_isdiv(ctx.as_int(lhs_val), ctx.as_int(rhs_val));
-            case BasicOp::Mod:
-                return ctx.builder().create_irem(ctx.as_int(lhs_val), ctx.as_int(rhs_val));
-            case BasicOp::Lt:
-                return ctx.builder().create_icmp_lt(ctx.as_int(lhs_val), ctx.as_int(rhs_val));
-            case BasicOp::Gt:
-                return ctx.builder().create_icmp_gt(ctx.as_int(lhs_val), ctx.as_int(rhs_val));
-            case BasicOp::Le:
-                return ctx.builder().create_icmp_le(ctx.as_int(lhs_val), ctx.as_int(rhs_val));
-            case BasicOp::Ge:
-                return ctx.builder().create_icmp_ge(ctx.as_int(lhs_val), ctx.as_int(rhs_val));
-            case BasicOp::Eq:
-                return ctx.builder().create_icmp_eq(ctx.as_int(lhs_val), ctx.as_int(rhs_val));
-            case BasicOp::Neq:
-                return ctx.builder().create_icmp_ne(ctx.as_int(lhs_val), ctx.as_int(rhs_val));
-            case BasicOp::And:
-            case BasicOp::Or:
-                break;
-        }
-        throw std::runtime_error("Unhandled binary operation");
-    }
 
-    Value *CallExpr::codegen(CodegenContext &ctx) {
-        auto *info = ctx.find_function(callee);
-        if (!info) {
-            throw std::runtime_error("Unknown function: " + callee);
-        }
-        if (info->param_types.size() != args.size()) {
-            throw std::runtime_error("Argument count mismatch for " + callee);
+        void after_child(const CallExpr &, const uint32_t i) {
+            values_.back() = ctx.cast(values_.back(), calls_.back()->param_types[i]);
         }
 
-        std::vector<Value *> arg_values;
-        arg_values.reserve(args.size());
-        for (std::size_t i = 0; i < args.size(); ++i) {
-            auto *val = args[i]->codegen(ctx);
-            arg_values.push_back(ctx.cast(val, info->param_types[i]));
+        void leave(const CallExpr &call) {
+            auto *info = calls_.back();
+            calls_.pop_back();
+            std::vector<Value *> arg_values(values_.end() - static_cast<std::ptrdiff_t>(call.args.size()), values_.end());
+            values_.resize(values_.size() - call.args.size());
+            values_.push_back(ctx.builder().create_call(info->function, arg_values));
         }
-        return ctx.builder().create_call(info->function, arg_values);
-    }
 
-    void EmptyStmt::codegen(CodegenContext &) {
-    }
-
-    void ExprStmt::codegen(CodegenContext &ctx) {
-        if (expr) {
-            expr->codegen(ctx);
+        void leave(const ExprStmt &stmt) {
+            if (stmt.expr) {
+                values_.pop_back();
+            }
         }
-    }
 
-    void AssignStmt::codegen(CodegenContext &ctx) {
-        auto *binding = ctx.lookup(target);
-        if (!binding) {
-            throw std::runtime_error("Assignment to undefined variable: " + target);
-        }
-        if (binding->is_const) {
-            throw std::runtime_error("Assignment to const variable: " + target);
+        void enter(const AssignStmt &assign) {
+            const auto *binding = ctx.lookup(assign.target);
+            if (!binding) {
+                throw std::runtime_error("Assignment to undefined variable: " + std::string(symbol_name(assign.target)));
+            }
+            if (binding->is_const) {
+                throw std::runtime_error("Assignment to const variable: " + std::string(symbol_name(assign.target)));
+            }
         }
-        auto *val = expr->codegen(ctx);
-        ctx.builder().create_store(ctx.cast(val, binding->type), binding->address);
-    }
 
-    void ReturnStmt::codegen(CodegenContext &ctx) {
-        if (!ctx.current_return_type) {
-            throw std::runtime_error("Return used outside of a function");
+        void leave(const AssignStmt &assign) {
+            const auto *binding = ctx.lookup(assign.target);
+            ctx.builder().create_store(ctx.cast(pop(), binding->type), binding->address);
         }
-        if (*ctx.current_return_type == BasicType::Void) {
-            ctx.builder().create_void_ret();
-            return;
+
+        // a void function's return value is never evaluated
+        bool enter(const ReturnStmt &) {
+            if (!ctx.current_return_type) {
+                throw std::runtime_error("Return used outside of a function");
+            }
+            return *ctx.current_return_type != BasicType::Void;
         }
-        if (!value) {
-            if (*ctx.current_return_type == BasicType::Float) {
-                ctx.builder().create_ret(ctx.make_float(0.0f));
-            } else {
-                ctx.builder().create_ret(ctx.make_int(0));
+
+        void leave(const ReturnStmt &ret) {
+            if (*ctx.current_return_type == BasicType::Void) {
+                ctx.builder().create_void_ret();
+                return;
             }
-            return;
+            if (!ret.value) {
+                if (*ctx.current_return_type == BasicType::Float) {
+                    ctx.builder().create_ret(ctx.make_float(0.0f));
+                } else {
+                    ctx.builder().create_ret(ctx.make_int(0));
+                }
+                return;
+            }
+            auto *val = ctx.cast(pop(), *ctx.current_return_type);
+            ctx.builder().create_ret(val);
         }
-        auto *val = ctx.cast(value->codegen(ctx), *ctx.current_return_type);
-        ctx.builder().create_ret(val);
-    }
 
-    void IfStmt::codegen(CodegenContext &ctx) {
-        auto *cond_val = ctx.as_bool(condition->codegen(ctx));
-        auto *then_bb = ctx.create_block("if.then");
-        auto *merge_bb = ctx.create_block("if.end");
-        BasicBlock *else_bb = else_branch ? ctx.create_block("if.else") : merge_bb;
+        void before_child(const IfStmt &ifs, const uint32_t i) {
+            if (i == 2 && ifs.else_branch) {
+                ctx.set_insert_point(branches_.back().else_bb);
+            }
+        }
 
-        ctx.builder().create_cond_br(cond_val, then_bb, else_bb);
+        void after_child(const IfStmt &ifs, const uint32_t i) {
+            if (i == 0) {
+                auto *cond_val = ctx.as_bool(pop());
+                auto *then_bb = ctx.create_block("if.then");
+                auto *merge_bb = ctx.create_block("if.end");
+                BasicBlock *else_bb = ifs.else_branch ? ctx.create_block("if.else") : merge_bb;
 
-        ctx.set_insert_point(then_bb);
-        then_branch->codegen(ctx);
-        if (!has_terminator(then_bb)) {
-            ctx.builder().create_br(merge_bb);
+                ctx.builder().create_cond_br(cond_val, then_bb, else_bb);
+                ctx.set_insert_point(then_bb);
+                branches_.push_back({then_bb, else_bb, merge_bb});
+                return;
+            }
+            const auto &branch = branches_.back();
+            if (i == 1 && !has_terminator(branch.then_bb)) {
+                ctx.builder().create_br(branch.merge_bb);
+            } else if (i == 2 && ifs.else_branch && !has_terminator(branch.else_bb)) {
+                ctx.builder().create_br(branch.merge_bb);
+            }
         }
 
-        if (else_branch) {
-            ctx.set_insert_point(else_bb);
-            else_branch->codegen(ctx);
-            if (!has_terminator(else_bb)) {
-                ctx.builder().create_br(merge_bb);
-            }
+        void leave(const IfStmt &) {
+            ctx.set_insert_point(branches_.back().merge_bb);
+            branches_.pop_back();
         }
 
-        ctx.set_insert_point(merge_bb);
-    }
+        void enter(const BlockStmt &) {
+            ctx.push_scope();
+        }
 
-    void BlockStmt::codegen(CodegenContext &ctx) {
-        ScopeGuard scope(ctx);
-        for (auto &item: items) {
-            if (item.type == BlockItem::Type::Decl && item.decl) {
-                item.decl->codegen(ctx);
-            } else if (item.type == BlockItem::Type::Stmt && item.stmt) {
-                item.stmt->codegen(ctx);
-            }
+        void leave(const BlockStmt &) {
+            ctx.pop_scope();
         }
-    }
 
-    void VarDecl::codegen(CodegenContext &ctx) {
-        const auto ir_type = ctx.to_ir_type(type);
-        if (ctx.current_function == nullptr) {
-            for (auto &init: items) {
+        // globals are done here whole; a local's slot is bound before its
+        // initializer is walked and stored to after
+        bool enter(const VarDecl &decl) {
+            if (ctx.current_function != nullptr) {
+                return true;
+            }
+            const auto type = decl.type;
+            const auto ir_type = ctx.to_ir_type(type);
+            for (const auto &init: decl.items) {
                 Constant *initializer = nullptr;
                 if (init.value) {
+                    // fold_constants() has reduced constant initializers to literals
+                    const auto *int_lit = node_cast<LiteralInt>(init.value.get());
+                    const auto *float_lit = node_cast<LiteralFloat>(init.value.get());
+                    if (!int_lit && !float_lit) {
+                        throw std::runtime_error("Global initializers must be constant: " + std::string(symbol_name(init.name)));
+                    }
                     if (type == BasicType::Float) {
-                        const auto folded = eval_float_constant(init.value.get());
-                        if (!folded) {
-                            throw std::runtime_error("Global initializers must be constant: " + init.name);
-                        }
-                        initializer = ConstantFloat::get(*folded, &ctx.module());
+                        const float value = int_lit ? static_cast<float>(int_lit->value) : float_lit->value;
+                        initializer = ConstantFloat::get(value, &ctx.module());
                     } else {
-                        const auto folded = eval_int_constant(init.value.get());
-                        if (!folded) {
-                            throw std::runtime_error("Global initializers must be constant: " + init.name);
-                        }
-                        initializer = ConstantInt::get(*folded, &ctx.module());
+                        const int value = int_lit ? int_lit->value : static_cast<int>(float_lit->value);
+                        initializer = ConstantInt::get(value, &ctx.module());
                     }
                 } else {
                     initializer = ConstantZero::get(ir_type, &ctx.module());
                 }
-                auto *global = GlobalVariable::create(init.name, &ctx.module(), ir_type, is_const, initializer);
-                ctx.bind(init.name, Binding{global, type, is_const, true});
+                auto *global = GlobalVariable::create(std::string(symbol_name(init.name)), &ctx.module(), ir_type, decl.is_const, initializer);
+                ctx.bind(init.name, Binding{global, type, decl.is_const, true});
             }
-            return;
+            return false;
         }
 
-        for (auto &init: items) {
-            auto *alloca = ctx.builder().create_alloca(ir_type);
-            ctx.bind(init.name, Binding{alloca, type, is_const, false});
+        void before_child(const VarDecl &decl, const uint32_t i) {
+            auto *alloca = ctx.builder().create_alloca(ctx.to_ir_type(decl.type));
+            ctx.bind(decl.items[i].name, Binding{alloca, decl.type, decl.is_const, false});
+        }
+
+        void after_child(const VarDecl &decl, const uint32_t i) {
+            const auto &init = decl.items[i];
             if (init.value) {
-                auto *val = ctx.cast(init.value->codegen(ctx), type);
-                ctx.builder().create_store(val, alloca);
+                auto *val = ctx.cast(pop(), decl.type);
+                ctx.builder().create_store(val, ctx.lookup(init.name)->address);
             }
         }
-    }
 
-    void FuncDef::codegen(CodegenContext &ctx) {
-        const auto &info = ctx.declare_function(*this);
-        auto *func = info.function;
+        void enter(const FuncDef &def) {
+            const auto &info = ctx.declare_function(def);
+            auto *func = info.function;
 
-        const auto previous_function = ctx.current_function;
-        const auto previous_return = ctx.current_return_type;
-        ctx.current_function = func;
-        ctx.current_return_type = type;
+            previous_function_ = ctx.current_function;
+            previous_return_ = ctx.current_return_type;
+            ctx.current_function = func;
+            ctx.current_return_type = def.type;
 
-        ScopeGuard scope(ctx);
+            ctx.push_scope();
 
-        auto *entry = BasicBlock::create(&ctx.module(), "entry", func);
-        ctx.set_insert_point(entry);
+            auto *entry = BasicBlock::create(&ctx.module(), "entry", func);
+            ctx.set_insert_point(entry);
 
-        auto arg_it = func->arg_begin();
-        for (const auto &param: params) {
-            if (arg_it == func->arg_end()) {
-                throw std::runtime_error("Parameter count mismatch for " + name);
+            auto arg_it = func->arg_begin();
+            for (const auto &param: def.params) {
+                if (arg_it == func->arg_end()) {
+                    throw std::runtime_error("Parameter count mismatch for " + std::string(symbol_name(def.name)));
+                }
+                auto *alloca = ctx.builder().create_alloca(ctx.to_ir_type(param.type));
+                ctx.bind(param.name, Binding{alloca, param.type, false, false});
+                ctx.builder().create_store(*arg_it, alloca);
+                ++arg_it;
             }
-            auto *alloca = ctx.builder().create_alloca(ctx.to_ir_type(param.type));
-            ctx.bind(param.name, Binding{alloca, param.type, false, false});
-            ctx.builder().create_store(*arg_it, alloca);
-            ++arg_it;
         }
 
-        if (body) {
-            body->codegen(ctx);
+        void leave(const FuncDef &def) {
+            auto *tail_block = ctx.builder().get_insert_block();
+            if (tail_block && !has_terminator(tail_block)) {
+                if (def.type == BasicType::Void) {
+                    ctx.builder().create_void_ret();
+                } else if (def.type == BasicType::Float) {
+                    ctx.builder().create_ret(ctx.make_float(0.0f));
+                } else {
+                    ctx.builder().create_ret(ctx.make_int(0));
+                }
+            }
+
+            ctx.pop_scope();
+            ctx.current_function = previous_function_;
+            ctx.current_return_type = previous_return_;
         }
 
-        auto *tail_block = ctx.builder().get_insert_block();
-        if (tail_block && !has_terminator(tail_block)) {
-            if (type == BasicType::Void) {
-                ctx.builder().create_void_ret();
-            } else if (type == BasicType::Float) {
-                ctx.builder().create_ret(ctx.make_float(0.0f));
-            } else {
-                ctx.builder().create_ret(ctx.make_int(0));
+    private:
+        struct Branch {
+            BasicBlock *then_bb;
+            BasicBlock *else_bb;
+            BasicBlock *merge_bb;
+        };
+
+        struct ShortCircuit {
+            BasicBlock *origin_block;
+            BasicBlock *merge_block;
+        };
+
+        CodegenContext &ctx;
+        std::vector<Value *> values_;
+        std::vector<FunctionInfo *> calls_;
+        std::vector<Branch> branches_;
+        std::vector<ShortCircuit> short_circuits_;
+        Function *previous_function_{nullptr};
+        std::optional<BasicType> previous_return_;
+
+        Value *pop() {
+            auto *value = values_.back();
+            values_.pop_back();
+            return value;
+        }
+
+        Value *unary_op(const UnaryOp op, Value *operand_val) {
+            const bool is_float = operand_val->get_type()->is_float_type();
+            switch (op) {
+                case UnaryOp::Positive:
+                    return is_float ? ctx.as_float(operand_val) : ctx.as_int(operand_val);
+                case UnaryOp::Negative: {
+                    if (is_float) {
+                        auto *zero = ctx.make_float(0.0f);
+                        return ctx.builder().create_fsub(zero, ctx.as_float(operand_val));
+                    }
+                    auto *zero = ctx.make_int(0);
+                    return ctx.builder().create_isub(zero, ctx.as_int(operand_val));
+                }
+                case UnaryOp::LogicalNot: {
+                    auto *cond = ctx.as_bool(operand_val);
+                    return ctx.builder().create_icmp_eq(cond, ctx.make_bool(false));
+                }
+            }
+            throw std::runtime_error("Unhandled unary op");
+        }
+
+        Value *binary_op(const BasicOp op, Value *lhs_val, Value *rhs_val) {
+            const bool use_float = lhs_val->get_type()->is_float_type() || rhs_val->get_type()->is_float_type();
+            if (use_float) {
+                auto *lhs_f = ctx.as_float(lhs_val);
+                auto *rhs_f = ctx.as_float(rhs_val);
+                switch (op) {
+                    case BasicOp::Add:
+                        return ctx.builder().create_fadd(lhs_f, rhs_f);
+                    case BasicOp::Sub:
+                        return ctx.builder().create_fsub(lhs_f, rhs_f);
+                    case BasicOp::Mul:
+                        return ctx.builder().create_fmul(lhs_f, rhs_f);
+                    case BasicOp::Div:
+                        return ctx.builder().create_fdiv(lhs_f, rhs_f);
+                    case BasicOp::Mod:
+                        throw std::runtime_error("Modulo is not supported for float");
+                    case BasicOp::Lt:
+                        return ctx.builder().create_icmp_lt(lhs_f, rhs_f);
+                    case BasicOp::Gt:
+                        return ctx.builder().create_icmp_gt(lhs_f, rhs_f);
+                    case BasicOp::Le:
+                        return ctx.builder().create_icmp_le(lhs_f, rhs_f);
+                    case BasicOp::Ge:
+                        return ctx.builder().create_icmp_ge(lhs_f, rhs_f);
+                    case BasicOp::Eq:
+                        return ctx.builder().create_icmp_eq(lhs_f, rhs_f);
+                    case BasicOp::Neq:
+                        return ctx.builder().create_icmp_ne(lhs_f, rhs_f);
+                    case BasicOp::And:
+                    case BasicOp::Or:
+                        break;
+                }
+            }
+            switch (op) {
+                case BasicOp::Add:
+                    return ctx.builder().create_iadd(ctx.as_int(lhs_val), ctx.as_int(rhs_val));
+                case BasicOp::Sub:
+                    return ctx.builder().create_isub(ctx.as_int(lhs_val), ctx.as_int(rhs_val));
+                case BasicOp::Mul:
+                    return ctx.builder().create_imul(ctx.as_int(lhs_val), ctx.as_int(rhs_val));
+                case BasicOp::Div:
+                    return ctx.builder().create_isdiv(ctx.as_int(lhs_val), ctx.as_int(rhs_val));
+                case BasicOp::Mod:
+                    return ctx.builder().create_irem(ctx.as_int(lhs_val), ctx.as_int(rhs_val));
+                case BasicOp::Lt:
+                    return ctx.builder().create_icmp_lt(ctx.as_int(lhs_val), ctx.as_int(rhs_val));
+                case BasicOp::Gt:
+                    return ctx.builder().create_icmp_gt(ctx.as_int(lhs_val), ctx.as_int(rhs_val));
+                case BasicOp::Le:
+                    return ctx.builder().create_icmp_le(ctx.as_int(lhs_val), ctx.as_int(rhs_val));
+                case BasicOp::Ge:
+                    return ctx.builder().create_icmp_ge(ctx.as_int(lhs_val), ctx.as_int(rhs_val));
+                case BasicOp::Eq:
+                    return ctx.builder().create_icmp_eq(ctx.as_int(lhs_val), ctx.as_int(rhs_val));
+                case BasicOp::Neq:
+                    return ctx.builder().create_icmp_ne(ctx.as_int(lhs_val), ctx.as_int(rhs_val));
+                case BasicOp::And:
+                case BasicOp::Or:
+                    break;
             }
+            throw std::runtime_error("Unhandled binary operation");
         }
+    };
 
-        ctx.current_function = previous_function;
-        ctx.current_return_type = previous_return;
-    }
+    // blocks CodegenPass creates for a body: two per && and ||, two per if
+    // and one more for its else, whatever the operands fold to
+    struct BlockCounter {
+        int blocks{0};
 
-    void Program::codegen(CodegenContext &ctx) const {
-        for (auto &decl: globals) {
-            decl->codegen(ctx);
+        void enter(const BinaryExpr &binary) {
+            if (binary.op == BasicOp::And || binary.op == BasicOp::Or) blocks += 2;
         }
-        for (const auto &fn: functions) {
-            ctx.declare_function(*fn);
+
+        void enter(const IfStmt &ifs) {
+            blocks += ifs.else_branch ? 3 : 2;
         }
-        for (auto &fn: functions) {
-            fn->codegen(ctx);
+    };
+}
+
+namespace front::ast {
+    void Program::codegen(ir::CodegenContext &ctx, ThreadPool *pool) const {
+        ir::CodegenPass codegen(ctx);
+        for (const auto &decl: globals) {
+            walk(*decl, codegen);
+        }
+        // every body may call every function, so all are declared first;
+        // the module lists them in this order whichever body finishes first
+        std::unordered_set<const ir::FunctionInfo *> declared;
+        bool redefined = false;
+        for (const auto &fn: functions) {
+            redefined |= !declared.insert(&ctx.declare_function(*fn)).second;
+        }
+
+        // a body writes only its own function, so bodies are independent;
+        // two definitions of one name share a function and stay in order
+        const auto lower = [&](const size_t i, const int first_block) {
+            ir::CodegenContext body{ctx};
+            body.first_block(first_block);
+            ir::CodegenPass pass(body);
+            walk(*functions[i], pass);
+            return body.next_block();
+        };
+        if (pool != nullptr && !redefined) {
+            // number blocks as the sequential path would: each body starts
+            // after the blocks of the bodies declared before it
+            std::vector<int> first_blocks(functions.size());
+            int next = ctx.next_block();
+            for (size_t i = 0; i < functions.size(); ++i) {
+                first_blocks[i] = next;
+                ir::BlockCounter counter;
+                walk(*functions[i], counter);
+                next += counter.blocks;
+            }
+            // the module's locks are only taken while bodies run concurrently
+            ctx.module().set_concurrent(true);
+            pool->parallel_for(functions.size(), [&](const size_t i) { lower(i, first_blocks[i]); });
+            ctx.module().set_concurrent(false);
+            ctx.first_block(next);
+        } else {
+            for (size_t i = 0; i < functions.size(); ++i) {
+                ctx.first_block(lower(i, ctx.next_block()));
+            }
         }
     }
 }
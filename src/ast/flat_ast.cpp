@@ -0,0 +1,529 @@
+#include "ast/flat_ast.h"
+#include "ast/walk.h"
+
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace front::ast {
+    size_t FlatAst::footprint() const {
+        return kinds.capacity() * sizeof(FlatKind) + ops.capacity() * sizeof(uint8_t)
+               + payloads.capacity() * sizeof(uint32_t) + first_child.capacity() * sizeof(uint32_t)
+               + child_count.capacity() * sizeof(uint32_t) + children.capacity() * sizeof(NodeId)
+               + (globals.capacity() + functions.capacity()) * sizeof(NodeId);
+    }
+
+    NodeId FlatAst::add(const FlatKind kind, const uint8_t op, const uint32_t payload,
+                        const std::span<const NodeId> kids) {
+        if (kinds.size() >= kNoNode) {
+            throw std::length_error("flat AST exceeds 32-bit node ids");
+        }
+        const auto id = static_cast<NodeId>(kinds.size());
+        kinds.push_back(kind);
+        ops.push_back(op);
+        payloads.push_back(payload);
+        first_child.push_back(static_cast<uint32_t>(children.size()));
+        child_count.push_back(static_cast<uint32_t>(kids.size()));
+        children.insert(children.end(), kids.begin(), kids.end());
+        return id;
+    }
+
+    namespace {
+        template<typename E>
+        uint8_t op_of(const E e) { return static_cast<uint8_t>(e); }
+
+        // Runs on the explicit-stack walker; every node leaves its id on
+        // ids_ and its parent collects them, keeping the bottom-up id order.
+        class Flattener {
+        public:
+            explicit Flattener(FlatAst &flat) : flat(flat) {
+            }
+
+            [[nodiscard]] NodeId result() {
+                return pop();
+            }
+
+            void leave(const LiteralInt &lit) {
+                ids_.push_back(flat.add(FlatKind::LiteralInt, 0, std::bit_cast<uint32_t>(lit.value)));
+            }
+
+            void leave(const LiteralFloat &lit) {
+                ids_.push_back(flat.add(FlatKind::LiteralFloat, 0, std::bit_cast<uint32_t>(lit.value)));
+            }
+
+            void leave(const IdentifierExpr &id) {
+                ids_.push_back(flat.add(FlatKind::Identifier, 0, id.name));
+            }
+
+            void leave(const UnaryExpr &unary) {
+                const NodeId operand = pop();
+                ids_.push_back(flat.add(FlatKind::Unary, op_of(unary.op), 0, {&operand, 1}));
+            }
+
+            void leave(const BinaryExpr &binary) {
+                const NodeId rhs = pop();
+                const NodeId kids[] = {pop(), rhs};
+                ids_.push_back(flat.add(FlatKind::Binary, op_of(binary.op), 0, kids));
+            }
+
+            void leave(const CallExpr &call) {
+                replace_top(call.args.size(), flat.add(FlatKind::Call, 0, call.callee, top(call.args.size())));
+            }
+
+            void leave(const EmptyStmt &) {
+                ids_.push_back(flat.add(FlatKind::Empty, 0, 0));
+            }
+
+            void leave(const ExprStmt &) {
+                const NodeId value = pop();
+                ids_.push_back(flat.add(FlatKind::ExprStmt, 0, 0, {&value, 1}));
+            }
+
+            void leave(const AssignStmt &assign) {
+                const NodeId value = pop();
+                ids_.push_back(flat.add(FlatKind::Assign, 0, assign.target, {&value, 1}));
+            }
+
+            void leave(const ReturnStmt &ret) {
+                if (!ret.value) {
+                    ids_.push_back(flat.add(FlatKind::Return, 0, 0));
+                    return;
+                }
+                const NodeId value = pop();
+                ids_.push_back(flat.add(FlatKind::Return, 0, 0, {&value, 1}));
+            }
+
+            void leave(const IfStmt &ifs) {
+                const size_t count = ifs.else_branch ? 3 : 2;
+                replace_top(count, flat.add(FlatKind::If, 0, 0, top(count)));
+            }
+
+            void leave(const BlockStmt &block) {
+                replace_top(block.items.size(), flat.add(FlatKind::Block, 0, 0, top(block.items.size())));
+            }
+
+            // each initializer becomes a VarInit as soon as its value is done
+            void after_child(const VarDecl &var, const uint32_t i) {
+                const auto &init = var.items[i];
+                if (init.value) {
+                    const NodeId value = pop();
+                    ids_.push_back(flat.add(FlatKind::VarInit, 0, init.name, {&value, 1}));
+                } else {
+                    ids_.push_back(flat.add(FlatKind::VarInit, 0, init.name));
+                }
+            }
+
+            void leave(const VarDecl &var) {
+                replace_top(var.items.size(), flat.add(FlatKind::VarDecl, op_of(var.type), var.is_const ? 1 : 0, top(var.items.size())));
+            }
+
+            void enter(const FuncDef &f) {
+                for (const auto &param: f.params) {
+                    ids_.push_back(flat.add(FlatKind::Param, op_of(param.type), param.name));
+                }
+            }
+
+            void leave(const FuncDef &f) {
+                if (!f.body) {
+                    ids_.push_back(flat.add(FlatKind::Block, 0, 0));
+                }
+                replace_top(f.params.size() + 1, flat.add(FlatKind::Func, op_of(f.type), f.name, top(f.params.size() + 1)));
+            }
+
+        private:
+            FlatAst &flat;
+            std::vector<NodeId> ids_;
+
+            NodeId pop() {
+                const NodeId id = ids_.back();
+                ids_.pop_back();
+                return id;
+            }
+
+            // the last `count` ids, the children of the node being added
+            [[nodiscard]] std::span<const NodeId> top(const size_t count) const {
+                return {ids_.data() + ids_.size() - count, count};
+            }
+
+            // pops `count` children and pushes their parent `id`
+            void replace_top(const size_t count, const NodeId id) {
+                ids_.resize(ids_.size() - count);
+                ids_.push_back(id);
+            }
+        };
+
+        // Rebuilds the pointer tree in id order. Children precede their
+        // parents, so every node finds its children already built and the
+        // rebuild needs no recursion. The encoding may come from outside the
+        // process (ast/serialize.h), so shapes, operators and child kinds
+        // are checked on the way.
+        class Unflattener {
+        public:
+            explicit Unflattener(const FlatAst &flat) : flat(flat), built_(flat.size(), nullptr) {
+                for (NodeId id = 0; id < flat.size(); ++id) {
+                    built_[id] = build(id);
+                }
+            }
+
+            // moves the node `id` out; each node has exactly one parent
+            template<typename T>
+            NodePtr<T> take(const NodeId id) {
+                Node *node = id < built_.size() ? std::exchange(built_[id], nullptr) : nullptr;
+                if (node == nullptr || !holds<T>(node->kind)) {
+                    throw std::runtime_error("malformed flat AST: misplaced node");
+                }
+                return NodePtr<T>(static_cast<T *>(node));
+            }
+
+        private:
+            const FlatAst &flat;
+            std::vector<Node *> built_;
+
+            template<typename T>
+            static bool holds(const NodeKind kind) {
+                if constexpr (std::is_same_v<T, Expr>) {
+                    return kind <= NodeKind::Call;
+                } else if constexpr (std::is_same_v<T, Stmt>) {
+                    return kind >= NodeKind::EmptyStmt && kind <= NodeKind::BlockStmt;
+                } else if constexpr (std::is_same_v<T, Decl>) {
+                    return kind == NodeKind::VarDecl;
+                } else {
+                    return kind == T::kKind;
+                }
+            }
+
+            std::span<const NodeId> kids(const NodeId id, const size_t min, const size_t max) const {
+                const auto kids = flat.children_of(id);
+                if (kids.size() < min || kids.size() > max) {
+                    throw std::runtime_error("malformed flat AST: wrong child count");
+                }
+                return kids;
+            }
+
+            [[nodiscard]] uint8_t op(const NodeId id, const auto last) const {
+                if (flat.ops[id] > static_cast<uint8_t>(last)) {
+                    throw std::runtime_error("malformed flat AST: operator out of range");
+                }
+                return flat.ops[id];
+            }
+
+            // VarInit and Param are read by their parent straight from the
+            // encoding and build no node of their own
+            Node *build(const NodeId id) {
+                switch (flat.kinds[id]) {
+                    case FlatKind::LiteralInt: {
+                        kids(id, 0, 0);
+                        auto *node = Arena::current().create<LiteralInt>();
+                        node->value = flat.int_value(id);
+                        return node;
+                    }
+                    case FlatKind::LiteralFloat: {
+                        kids(id, 0, 0);
+                        auto *node = Arena::current().create<LiteralFloat>();
+                        node->value = flat.float_value(id);
+                        return node;
+                    }
+                    case FlatKind::Identifier: {
+                        kids(id, 0, 0);
+                        auto *node = Arena::current().create<IdentifierExpr>();
+                        node->name = flat.symbol(id);
+                        return node;
+                    }
+                    case FlatKind::Unary: {
+                        const auto operand = kids(id, 1, 1);
+                        auto *node = Arena::current().create<UnaryExpr>();
+                        node->op = static_cast<UnaryOp>(op(id, UnaryOp::LogicalNot));
+                        node->operand = take<Expr>(operand[0]);
+                        return node;
+                    }
+                    case FlatKind::Binary: {
+                        const auto operands = kids(id, 2, 2);
+                        auto *node = Arena::current().create<BinaryExpr>();
+                        node->op = static_cast<BasicOp>(op(id, BasicOp::Or));
+                        node->lhs = take<Expr>(operands[0]);
+                        node->rhs = take<Expr>(operands[1]);
+                        return node;
+                    }
+                    case FlatKind::Call: {
+                        const auto args = flat.children_of(id);
+                        auto *node = Arena::current().create<CallExpr>();
+                        node->callee = flat.symbol(id);
+                        node->args.reserve(args.size());
+                        for (const NodeId arg: args) {
+                            node->args.push_back(take<Expr>(arg));
+                        }
+                        return node;
+                    }
+                    case FlatKind::Empty:
+                        kids(id, 0, 0);
+                        return Arena::current().create<EmptyStmt>();
+                    case FlatKind::ExprStmt: {
+                        const auto value = kids(id, 1, 1);
+                        auto *node = Arena::current().create<ExprStmt>();
+                        node->expr = take<Expr>(value[0]);
+                        return node;
+                    }
+                    case FlatKind::Assign: {
+                        const auto value = kids(id, 1, 1);
+                        auto *node = Arena::current().create<AssignStmt>();
+                        node->target = flat.symbol(id);
+                        node->expr = take<Expr>(value[0]);
+                        return node;
+                    }
+                    case FlatKind::Return: {
+                        const auto value = kids(id, 0, 1);
+                        auto *node = Arena::current().create<ReturnStmt>();
+                        if (!value.empty()) node->value = take<Expr>(value[0]);
+                        return node;
+                    }
+                    case FlatKind::If: {
+                        const auto parts = kids(id, 2, 3);
+                        auto *node = Arena::current().create<IfStmt>();
+                        node->condition = take<Expr>(parts[0]);
+                        node->then_branch = take<Stmt>(parts[1]);
+                        if (parts.size() > 2) node->else_branch = take<Stmt>(parts[2]);
+                        return node;
+                    }
+                    case FlatKind::Block: {
+                        const auto items = flat.children_of(id);
+                        auto *node = Arena::current().create<BlockStmt>();
+                        node->items.reserve(items.size());
+                        for (const NodeId item: items) {
+                            node->items.push_back(flat.kinds[item] == FlatKind::VarDecl
+                                                      ? BlockItem::make_decl(take<Decl>(item))
+                                                      : BlockItem::make_stmt(take<Stmt>(item)));
+                        }
+                        return node;
+                    }
+                    case FlatKind::VarDecl: {
+                        const auto inits = flat.children_of(id);
+                        auto *node = Arena::current().create<VarDecl>();
+                        node->type = static_cast<BasicType>(op(id, BasicType::Float));
+                        node->is_const = flat.payloads[id] != 0;
+                        node->items.reserve(inits.size());
+                        for (const NodeId init: inits) {
+                            if (flat.kinds[init] != FlatKind::VarInit) {
+                                throw std::runtime_error("malformed flat AST: misplaced node");
+                            }
+                            const auto value = kids(init, 0, 1);
+                            node->items.push_back({flat.symbol(init), value.empty() ? nullptr : take<Expr>(value[0])});
+                        }
+                        return node;
+                    }
+                    case FlatKind::VarInit:
+                    case FlatKind::Param:
+                        return nullptr;
+                    case FlatKind::Func: {
+                        const auto parts = kids(id, 1, kNoNode);
+                        auto *node = Arena::current().create<FuncDef>();
+                        node->type = static_cast<BasicType>(op(id, BasicType::Float));
+                        node->name = flat.symbol(id);
+                        node->params.reserve(parts.size() - 1);
+                        for (const NodeId param: parts.first(parts.size() - 1)) {
+                            if (flat.kinds[param] != FlatKind::Param) {
+                                throw std::runtime_error("malformed flat AST: misplaced node");
+                            }
+                            node->params.push_back({static_cast<BasicType>(op(param, BasicType::Float)), flat.symbol(param)});
+                        }
+                        node->body = take<BlockStmt>(parts.back());
+                        return node;
+                    }
+                }
+                throw std::runtime_error("malformed flat AST: unknown node kind");
+            }
+        };
+
+        struct FlatPrinter {
+            const FlatAst &flat;
+            std::ostream &os;
+
+            void indent(const int depth) const {
+                for (int i = 0; i < depth; ++i) os << "  ";
+            }
+
+            void expr(const NodeId id, const int depth) const {
+                indent(depth);
+                const auto kids = flat.children_of(id);
+                switch (flat.kinds[id]) {
+                    case FlatKind::LiteralInt:
+                        os << "LiteralInt " << flat.int_value(id) << "\n";
+                        return;
+                    case FlatKind::LiteralFloat:
+                        os << "LiteralFloat " << flat.float_value(id) << "\n";
+                        return;
+                    case FlatKind::Identifier:
+                        os << "Identifier " << flat.name(id) << "\n";
+                        return;
+                    case FlatKind::Unary:
+                        os << "Unary " << to_string(static_cast<UnaryOp>(flat.ops[id])) << "\n";
+                        expr(kids[0], depth + 1);
+                        return;
+                    case FlatKind::Binary:
+                        os << "Binary " << to_string(static_cast<BasicOp>(flat.ops[id])) << "\n";
+                        expr(kids[0], depth + 1);
+                        expr(kids[1], depth + 1);
+                        return;
+                    case FlatKind::Call:
+                        os << "Call " << flat.name(id) << "\n";
+                        if (kids.empty()) {
+                            indent(depth + 1);
+                            os << "<no args>\n";
+                        }
+                        for (const NodeId arg: kids) {
+                            expr(arg, depth + 1);
+                        }
+                        return;
+                    default:
+                        os << "<unknown expr>\n";
+                }
+            }
+
+            void block(const NodeId id, const int depth) const {
+                indent(depth);
+                os << "Block\n";
+                for (const NodeId item: flat.children_of(id)) {
+                    indent(depth + 1);
+                    if (flat.kinds[item] == FlatKind::VarDecl) {
+                        os << "Decl\n";
+                        decl(item, depth + 2);
+                    } else {
+                        os << "Stmt\n";
+                        stmt(item, depth + 2);
+                    }
+                }
+            }
+
+            void stmt(const NodeId id, const int depth) const {
+                if (flat.kinds[id] == FlatKind::Block) {
+                    block(id, depth);
+                    return;
+                }
+                indent(depth);
+                const auto kids = flat.children_of(id);
+                switch (flat.kinds[id]) {
+                    case FlatKind::Empty:
+                        os << "EmptyStmt\n";
+                        return;
+                    case FlatKind::ExprStmt:
+                        os << "ExprStmt\n";
+                        expr(kids[0], depth + 1);
+                        return;
+                    case FlatKind::Assign:
+                        os << "Assign " << flat.name(id) << "\n";
+                        expr(kids[0], depth + 1);
+                        return;
+                    case FlatKind::Return:
+                        os << "Return\n";
+                        if (kids.empty()) {
+                            indent(depth + 1);
+                            os << "<void>\n";
+                        } else {
+                            expr(kids[0], depth + 1);
+                        }
+                        return;
+                    case FlatKind::If:
+                        os << "If\n";
+                        indent(depth + 1);
+                        os << "Cond\n";
+                        expr(kids[0], depth + 2);
+                        indent(depth + 1);
+                        os << "Then\n";
+                        stmt(kids[1], depth + 2);
+                        if (kids.size() > 2) {
+                            indent(depth + 1);
+                            os << "Else\n";
+                            stmt(kids[2], depth + 2);
+                        }
+                        return;
+                    default:
+                        os << "<unknown stmt>\n";
+                }
+            }
+
+            void decl(const NodeId id, const int depth) const {
+                indent(depth);
+                os << (flat.payloads[id] != 0 ? "ConstDecl " : "VarDecl ")
+                        << to_string(static_cast<BasicType>(flat.ops[id])) << "\n";
+                for (const NodeId init: flat.children_of(id)) {
+                    indent(depth + 1);
+                    os << flat.name(init);
+                    if (const auto value = flat.children_of(init); !value.empty()) {
+                        os << " =\n";
+                        expr(value[0], depth + 2);
+                    } else {
+                        os << " <uninitialized>\n";
+                    }
+                }
+            }
+
+            void func(const NodeId id, const int depth) const {
+                indent(depth);
+                os << "Func " << to_string(static_cast<BasicType>(flat.ops[id])) << " " << flat.name(id) << "\n";
+                indent(depth + 1);
+                os << "Params\n";
+                const auto kids = flat.children_of(id);
+                if (kids.size() == 1) {
+                    indent(depth + 2);
+                    os << "<none>\n";
+                }
+                for (const NodeId param: kids.first(kids.size() - 1)) {
+                    indent(depth + 2);
+                    os << to_string(static_cast<BasicType>(flat.ops[param])) << " " << flat.name(param) << "\n";
+                }
+                indent(depth + 1);
+                os << "Body\n";
+                block(kids.back(), depth + 2);
+            }
+        };
+    }
+
+    FlatAst flatten(const Program &program) {
+        FlatAst flat;
+        Flattener flattener{flat};
+        flat.globals.reserve(program.globals.size());
+        for (const auto &decl: program.globals) {
+            walk(*decl, flattener);
+            flat.globals.push_back(flattener.result());
+        }
+        flat.functions.reserve(program.functions.size());
+        for (const auto &func: program.functions) {
+            walk(*func, flattener);
+            flat.functions.push_back(flattener.result());
+        }
+        return flat;
+    }
+
+    ProgramPtr to_program(const FlatAst &flat) {
+        auto arena = std::make_shared<Arena>();
+        ArenaScope scope{*arena};
+        Unflattener unflattener{flat};
+
+        auto program = std::make_unique<Program>();
+        program->arenas.push_back(std::move(arena));
+        program->globals.reserve(flat.globals.size());
+        for (const NodeId id: flat.globals) {
+            program->globals.push_back(unflattener.take<Decl>(id));
+        }
+        program->functions.reserve(flat.functions.size());
+        for (const NodeId id: flat.functions) {
+            program->functions.push_back(unflattener.take<FuncDef>(id));
+        }
+        return program;
+    }
+
+    void print_ast(const FlatAst &flat, std::ostream &os) {
+        const FlatPrinter printer{flat, os};
+        os << "Program\n";
+        for (const NodeId id: flat.globals) {
+            printer.indent(1);
+            os << "GlobalDecl\n";
+            printer.decl(id, 2);
+        }
+        for (const NodeId id: flat.functions) {
+            printer.indent(1);
+            os << "Function\n";
+            printer.func(id, 2);
+        }
+    }
+}
@@ -0,0 +1,234 @@
+//
+// Bottom-up constant folding of the AST.
+//
+#include "ast/fold.h"
+#include "ast/walk.h"
+
+#include <climits>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <variant>
+#include <vector>
+
+namespace front::ast {
+    namespace {
+        using Constant = std::variant<int, float>;
+
+        bool truthy(const Constant &value) {
+            return std::visit([](const auto v) { return v != 0; }, value);
+        }
+
+        float as_float(const Constant &value) {
+            return std::visit([](const auto v) { return static_cast<float>(v); }, value);
+        }
+
+        // two's complement wraparound, as the emitted i32 arithmetic does
+        int wrap(const int64_t value) {
+            return static_cast<int>(static_cast<uint32_t>(value));
+        }
+
+        // `global`: the operands belong to a global initializer, which has
+        // no run time to defer to and divides by zero to 0
+        std::optional<Constant> fold_int(const BasicOp op, const int lhs, const int rhs, const bool global) {
+            switch (op) {
+                case BasicOp::Add: return wrap(int64_t{lhs} + rhs);
+                case BasicOp::Sub: return wrap(int64_t{lhs} - rhs);
+                case BasicOp::Mul: return wrap(int64_t{lhs} * rhs);
+                case BasicOp::Div:
+                case BasicOp::Mod:
+                    // traps at run time; keep it there
+                    if (rhs == 0 || (lhs == INT_MIN && rhs == -1)) {
+                        if (!global) {
+                            return std::nullopt;
+                        }
+                        return rhs == 0 || op == BasicOp::Mod ? 0 : INT_MIN;
+                    }
+                    return op == BasicOp::Div ? lhs / rhs : lhs % rhs;
+                case BasicOp::Lt: return int{lhs < rhs};
+                case BasicOp::Gt: return int{lhs > rhs};
+                case BasicOp::Le: return int{lhs <= rhs};
+                case BasicOp::Ge: return int{lhs >= rhs};
+                case BasicOp::Eq: return int{lhs == rhs};
+                case BasicOp::Neq: return int{lhs != rhs};
+                case BasicOp::And:
+                case BasicOp::Or:
+                    break;
+            }
+            return std::nullopt;
+        }
+
+        std::optional<Constant> fold_float(const BasicOp op, const float lhs, const float rhs, const bool global) {
+            switch (op) {
+                case BasicOp::Add: return lhs + rhs;
+                case BasicOp::Sub: return lhs - rhs;
+                case BasicOp::Mul: return lhs * rhs;
+                case BasicOp::Div: return global && rhs == 0.0f ? 0.0f : lhs / rhs;
+                case BasicOp::Lt: return int{lhs < rhs};
+                case BasicOp::Gt: return int{lhs > rhs};
+                case BasicOp::Le: return int{lhs <= rhs};
+                case BasicOp::Ge: return int{lhs >= rhs};
+                case BasicOp::Eq: return int{lhs == rhs};
+                case BasicOp::Neq: return int{lhs != rhs};
+                // codegen rejects float `%`
+                case BasicOp::Mod:
+                case BasicOp::And:
+                case BasicOp::Or:
+                    break;
+            }
+            return std::nullopt;
+        }
+
+        // Runs on the explicit-stack walker. Each expression leaves its
+        // value on values_ (nullopt when not constant); its parent takes the
+        // values back in reverse slot order and swaps constant subtrees for
+        // literals, so every node is evaluated exactly once and parents only
+        // ever see literals.
+        class ConstantFolder {
+        public:
+            void enter(const FuncDef &) {
+                ++functions_;
+            }
+
+            void leave(const FuncDef &) {
+                --functions_;
+            }
+
+            void leave(const LiteralInt &lit) {
+                values_.emplace_back(lit.value);
+            }
+
+            void leave(const LiteralFloat &lit) {
+                values_.emplace_back(lit.value);
+            }
+
+            void leave(const IdentifierExpr &) {
+                values_.emplace_back();
+            }
+
+            void leave(CallExpr &call) {
+                for (auto it = call.args.rbegin(); it != call.args.rend(); ++it) {
+                    take(*it);
+                }
+                values_.emplace_back();
+            }
+
+            void leave(UnaryExpr &unary) {
+                values_.push_back(fold_unary(unary.op, take(unary.operand)));
+            }
+
+            void leave(BinaryExpr &binary) {
+                const auto rhs = take(binary.rhs);
+                const auto lhs = take(binary.lhs);
+                values_.push_back(fold_binary(binary.op, lhs, rhs, functions_ == 0));
+            }
+
+            void leave(ExprStmt &stmt) {
+                take(stmt.expr);
+            }
+
+            void leave(AssignStmt &assign) {
+                take(assign.expr);
+            }
+
+            void leave(ReturnStmt &ret) {
+                take(ret.value);
+            }
+
+            void leave(IfStmt &ifs) {
+                take(ifs.condition);
+            }
+
+            void leave(VarDecl &decl) {
+                for (auto it = decl.items.rbegin(); it != decl.items.rend(); ++it) {
+                    take(it->value);
+                }
+            }
+
+        private:
+            std::vector<std::optional<Constant> > values_;
+            // expressions outside any function are global initializers
+            int functions_{0};
+
+            // pops the value of the expression in `slot`, if there is one
+            std::optional<Constant> take(ExprPtr &slot) {
+                if (!slot) {
+                    return std::nullopt;
+                }
+                auto value = values_.back();
+                values_.pop_back();
+                if (value && slot->kind != NodeKind::LiteralInt && slot->kind != NodeKind::LiteralFloat) {
+                    slot = literal(*value);
+                }
+                return value;
+            }
+
+            static std::optional<Constant> fold_unary(const UnaryOp op, const std::optional<Constant> &operand) {
+                if (!operand) {
+                    return std::nullopt;
+                }
+                switch (op) {
+                    case UnaryOp::Positive:
+                        return operand;
+                    case UnaryOp::Negative:
+                        // codegen subtracts from zero, which keeps -0.0f positive
+                        if (const auto *f = std::get_if<float>(&*operand)) {
+                            return 0.0f - *f;
+                        }
+                        return wrap(-int64_t{std::get<int>(*operand)});
+                    case UnaryOp::LogicalNot:
+                        return int{!truthy(*operand)};
+                }
+                return std::nullopt;
+            }
+
+            static std::optional<Constant> fold_binary(const BasicOp op, const std::optional<Constant> &lhs,
+                                                       const std::optional<Constant> &rhs, const bool global) {
+                if (op == BasicOp::And || op == BasicOp::Or) {
+                    // a deciding left operand means the right one never runs
+                    const bool decides_on = op == BasicOp::Or;
+                    if (lhs && truthy(*lhs) == decides_on) {
+                        return int{decides_on};
+                    }
+                    if (lhs && rhs) {
+                        return int{truthy(*rhs)};
+                    }
+                    return std::nullopt;
+                }
+                if (!lhs || !rhs) {
+                    return std::nullopt;
+                }
+                if (std::holds_alternative<float>(*lhs) || std::holds_alternative<float>(*rhs)) {
+                    return fold_float(op, as_float(*lhs), as_float(*rhs), global);
+                }
+                return fold_int(op, std::get<int>(*lhs), std::get<int>(*rhs), global);
+            }
+
+            static ExprPtr literal(const Constant &value) {
+                if (const auto *f = std::get_if<float>(&value)) {
+                    auto lit = make_node<LiteralFloat>();
+                    lit->value = *f;
+                    return lit;
+                }
+                auto lit = make_node<LiteralInt>();
+                lit->value = std::get<int>(value);
+                return lit;
+            }
+        };
+    }
+
+    void fold_constants(Program &program) {
+        if (program.constants_folded) {
+            return;
+        }
+        // replacement literals join the program's own nodes
+        if (program.arenas.empty()) {
+            program.arenas.push_back(std::make_shared<Arena>());
+        }
+        ArenaScope scope{*program.arenas.front()};
+
+        ConstantFolder folder;
+        walk(program, folder);
+        program.constants_folded = true;
+    }
+}
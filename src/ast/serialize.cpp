@@ -0,0 +1,296 @@
+//
+// Binary (de)serialization of the AST through its flat encoding.
+//
+// Layout, fixed-width integers in host byte order (the blob is a local
+// cache, not an interchange format):
+//   header     magic "CMMA", version, then the counts of symbols, nodes,
+//              child links, globals and functions (u32 each)
+//   symbols    per name: varint length, then the bytes
+//   nodes      kinds (u8 each), ops (u8 each), then varint payloads and
+//              varint child counts
+//   links      per node, each child as its varint distance back from the
+//              node; then the globals and functions as varint node ids
+// Symbol payloads index the blob's symbol table instead of the interner.
+// Most payloads, counts and distances are small, so the varints keep a
+// node to a handful of bytes.
+//
+#include "ast/serialize.h"
+#include "ast/flat_ast.h"
+#include "ast/walk.h"
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace front::ast {
+    namespace {
+        constexpr std::string_view kMagic = "CMMA";
+        // bump whenever the layout or the meaning of FlatAst fields changes
+        constexpr uint32_t kVersion = 1;
+
+        bool names_symbol(const FlatKind kind) {
+            switch (kind) {
+                case FlatKind::Identifier:
+                case FlatKind::Call:
+                case FlatKind::Assign:
+                case FlatKind::VarInit:
+                case FlatKind::Param:
+                case FlatKind::Func:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        class Writer {
+        public:
+            template<typename T>
+            void put(const T value) {
+                bytes_.append(reinterpret_cast<const char *>(&value), sizeof(T));
+            }
+
+            template<typename T>
+            void put(const std::vector<T> &values) {
+                bytes_.append(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(T));
+            }
+
+            // LEB128: seven bits per byte, low bits first
+            void varint(uint32_t value) {
+                while (value >= 0x80) {
+                    bytes_.push_back(static_cast<char>(value | 0x80));
+                    value >>= 7;
+                }
+                bytes_.push_back(static_cast<char>(value));
+            }
+
+            void text(const std::string_view text) {
+                varint(static_cast<uint32_t>(text.size()));
+                raw(text);
+            }
+
+            void raw(const std::string_view bytes) {
+                bytes_.append(bytes);
+            }
+
+            std::string take() { return std::move(bytes_); }
+
+        private:
+            std::string bytes_;
+        };
+
+        class Reader {
+        public:
+            explicit Reader(const std::string_view bytes) : rest_(bytes) {
+            }
+
+            template<typename T>
+            T get() {
+                T value;
+                std::memcpy(&value, need(sizeof(T)), sizeof(T));
+                return value;
+            }
+
+            template<typename T>
+            void get(std::vector<T> &values, const uint32_t count) {
+                // checked before resizing, so a corrupt count cannot allocate
+                const char *data = need(size_t{count} * sizeof(T));
+                values.resize(count);
+                std::memcpy(values.data(), data, size_t{count} * sizeof(T));
+            }
+
+            uint32_t varint() {
+                uint32_t value = 0;
+                for (int shift = 0; shift < 35; shift += 7) {
+                    const auto byte = static_cast<uint8_t>(*need(1));
+                    value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+                    if ((byte & 0x80) == 0) {
+                        return value;
+                    }
+                }
+                throw std::runtime_error("AST blob is malformed");
+            }
+
+            // `count` varints, each at least a byte long
+            void varints(std::vector<uint32_t> &values, const uint32_t count) {
+                if (count > rest_.size()) {
+                    throw std::runtime_error("AST blob is truncated");
+                }
+                values.resize(count);
+                for (auto &value: values) {
+                    value = varint();
+                }
+            }
+
+            std::string_view text() {
+                return raw(varint());
+            }
+
+            std::string_view raw(const size_t size) {
+                return {need(size), size};
+            }
+
+            [[nodiscard]] bool done() const { return rest_.empty(); }
+
+        private:
+            std::string_view rest_;
+
+            const char *need(const size_t size) {
+                if (size > rest_.size()) {
+                    throw std::runtime_error("AST blob is truncated");
+                }
+                const char *data = rest_.data();
+                rest_.remove_prefix(size);
+                return data;
+            }
+        };
+
+        template<typename T>
+        void put_varints(Writer &out, const std::vector<T> &values) {
+            for (const auto value: values) {
+                out.varint(value);
+            }
+        }
+
+        [[noreturn]] void malformed() {
+            throw std::runtime_error("AST blob is malformed");
+        }
+
+        // swaps the blob's symbol numbers in a loaded tree for interned ids
+        struct Reinterner {
+            const std::vector<SymbolId> &symbols;
+
+            void enter(IdentifierExpr &node) const { node.name = symbols[node.name]; }
+            void enter(CallExpr &node) const { node.callee = symbols[node.callee]; }
+            void enter(AssignStmt &node) const { node.target = symbols[node.target]; }
+
+            void enter(VarDecl &node) const {
+                for (auto &item: node.items) item.name = symbols[item.name];
+            }
+
+            void enter(FuncDef &node) const {
+                node.name = symbols[node.name];
+                for (auto &param: node.params) param.name = symbols[param.name];
+            }
+        };
+    }
+
+    std::string serialize(const Program &program) {
+        auto flat = flatten(program);
+
+        // number names in order of first use
+        std::unordered_map<SymbolId, uint32_t> local;
+        std::vector<SymbolId> symbols;
+        for (NodeId id = 0; id < flat.size(); ++id) {
+            if (!names_symbol(flat.kinds[id])) {
+                continue;
+            }
+            const auto [it, added] = local.try_emplace(flat.payloads[id], static_cast<uint32_t>(symbols.size()));
+            if (added) {
+                symbols.push_back(flat.payloads[id]);
+            }
+            flat.payloads[id] = it->second;
+        }
+
+        Writer out;
+        out.raw(kMagic);
+        out.put(kVersion);
+        out.put(static_cast<uint32_t>(symbols.size()));
+        out.put(static_cast<uint32_t>(flat.size()));
+        out.put(static_cast<uint32_t>(flat.children.size()));
+        out.put(static_cast<uint32_t>(flat.globals.size()));
+        out.put(static_cast<uint32_t>(flat.functions.size()));
+        for (const SymbolId symbol: symbols) {
+            out.text(symbol_name(symbol));
+        }
+        out.put(flat.kinds);
+        out.put(flat.ops);
+        put_varints(out, flat.payloads);
+        put_varints(out, flat.child_count);
+        for (NodeId id = 0; id < flat.size(); ++id) {
+            for (const NodeId child: flat.children_of(id)) {
+                out.varint(id - child);
+            }
+        }
+        put_varints(out, flat.globals);
+        put_varints(out, flat.functions);
+        return out.take();
+    }
+
+    ProgramPtr deserialize(const std::string_view bytes) {
+        Reader in{bytes};
+        if (in.raw(kMagic.size()) != kMagic) {
+            throw std::runtime_error("not an AST blob");
+        }
+        if (in.get<uint32_t>() != kVersion) {
+            throw std::runtime_error("AST blob has another format version");
+        }
+        const auto symbol_count = in.get<uint32_t>();
+        const auto node_count = in.get<uint32_t>();
+        const auto link_count = in.get<uint32_t>();
+        const auto global_count = in.get<uint32_t>();
+        const auto function_count = in.get<uint32_t>();
+
+        // interned only once the whole blob has been checked, so a damaged
+        // one leaves nothing behind in the process-wide table
+        std::vector<std::string_view> names;
+        for (uint32_t i = 0; i < symbol_count; ++i) {
+            names.push_back(in.text());
+        }
+
+        FlatAst flat;
+        in.get(flat.kinds, node_count);
+        in.get(flat.ops, node_count);
+        in.varints(flat.payloads, node_count);
+        in.varints(flat.child_count, node_count);
+
+        // a child is stored as its distance back from the parent, so
+        // children precede their parents by construction, the order
+        // to_program relies on
+        flat.first_child.resize(node_count);
+        if (link_count > bytes.size()) {
+            malformed();
+        }
+        flat.children.reserve(link_count);
+        for (NodeId id = 0; id < node_count; ++id) {
+            if (flat.kinds[id] > FlatKind::Func) {
+                malformed();
+            }
+            if (names_symbol(flat.kinds[id]) && flat.payloads[id] >= names.size()) {
+                malformed();
+            }
+            flat.first_child[id] = static_cast<uint32_t>(flat.children.size());
+            if (flat.child_count[id] > link_count - flat.children.size()) {
+                malformed();
+            }
+            for (uint32_t i = 0; i < flat.child_count[id]; ++i) {
+                const uint32_t distance = in.varint();
+                if (distance == 0 || distance > id) {
+                    malformed();
+                }
+                flat.children.push_back(id - distance);
+            }
+        }
+        if (flat.children.size() != link_count) {
+            malformed();
+        }
+        in.varints(flat.globals, global_count);
+        in.varints(flat.functions, function_count);
+        if (!in.done()) {
+            malformed();
+        }
+        // the tree is built with the blob's symbol numbers, which also
+        // checks its shape, and renamed afterwards
+        auto program = to_program(flat);
+        std::vector<SymbolId> symbols;
+        symbols.reserve(names.size());
+        for (const auto name: names) {
+            symbols.push_back(Interner::global().intern(name));
+        }
+        Reinterner reinterner{symbols};
+        walk(*program, reinterner);
+        return program;
+    }
+}
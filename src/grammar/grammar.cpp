@@ -1,6 +1,7 @@
 #include "grammar/grammar.h"
 
 #include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <ranges>
 #include <utility>
@@ -10,8 +11,7 @@ namespace front::grammar {
     Grammar::Grammar(const bool ll1) : ll1(ll1) {
         init_rules(ll1);
         if (ll1) normalize_ll1();
-        compute_first_set();
-        compute_follow_set();
+        analyze();
     }
 
     Grammar::Grammar(const std::string &start,
@@ -21,11 +21,22 @@ namespace front::grammar {
         }
         if (ll1) normalize_ll1();
 
+        analyze();
+    }
+
+
+    void Grammar::analyze() {
+        using clock = std::chrono::steady_clock;
+        using ms = std::chrono::duration<double, std::milli>;
+
+        const auto start = clock::now();
         compute_first_set();
+        const auto first_done = clock::now();
         compute_follow_set();
+        analysis_times_.first_ms = ms(first_done - start).count();
+        analysis_times_.follow_ms = ms(clock::now() - first_done).count();
     }
 
-
     void Grammar::print_first_set(std::ostream &os) const {
         for (const auto &[sym, firsts]: first_set_) {
             os << "FIRST(" << sym.name << ") = { ";
@@ -63,48 +74,18 @@ namespace front::grammar {
 
     std::unordered_set<Symbol, SymbolHash>
     Grammar::first_of_sequence(const std::vector<Symbol> &body) const {
-        std::unordered_set<Symbol, SymbolHash> result;
-
         // empty sequence => FIRST = { ε }
         if (body.empty()) {
             std::cerr << "Error: first_of_sequence called with empty body, returning { ε }\n";
             throw std::runtime_error("first_of_sequence called with empty body");
         }
 
-        bool all_nullable = true;
-        for (const auto &Y: body) {
-            // explicit ε in the body: it only contributes nullability
-            if (Y.is_epsilon()) {
-                continue;
-            }
-
-            auto itF = first_set_.find(Y);
-            if (itF == first_set_.end()) {
-                // no FIRST information for Y, treat as non-nullable
-                all_nullable = false;
-                break;
-            }
-
-            bool has_epsilon = false;
-            for (const auto &s: itF->second) {
-                if (s.is_epsilon()) {
-                    has_epsilon = true;
-                } else {
-                    result.insert(s);
-                }
-            }
-
-            // stop when Y cannot derive ε
-            if (!has_epsilon) {
-                all_nullable = false;
-                break;
-            }
-        }
-
-        if (all_nullable) {
+        const auto [first, nullable] = first_of_symbols(body);
+        std::unordered_set<Symbol, SymbolHash> result;
+        first.for_each([&](const size_t t) { result.insert(terminal_symbols_[t]); });
+        if (nullable) {
             result.insert(Symbol::Epsilon());
         }
-
         return result;
     }
 
@@ -529,108 +510,233 @@ namespace front::grammar {
     }
 
 
-    void Grammar::compute_first_set() {
-        // 1. for terminals, FIRST(a) = {a}
-        for (const auto &terminal: terminals_) {
-            auto t = T(terminal);
-            first_set_[t].insert(t);
+    void Grammar::intern_symbols() {
+        terminal_symbols_.clear();
+        terminal_ids_.clear();
+        nonterminal_symbols_.clear();
+        nonterminal_ids_.clear();
+
+        const auto intern_terminal = [&](const Symbol &sym) {
+            if (terminal_ids_.try_emplace(sym.name, terminal_symbols_.size()).second) {
+                terminal_symbols_.push_back(sym);
+            }
+        };
+        const auto intern_non_terminal = [&](const Symbol &sym) {
+            if (nonterminal_ids_.try_emplace(sym.name, nonterminal_symbols_.size()).second) {
+                nonterminal_symbols_.push_back(sym);
+            }
+        };
+
+        // productions order, so ids do not depend on set iteration order
+        intern_terminal(Symbol::End());
+        intern_non_terminal(start_symbol_);
+        for (const auto &prod: productions) {
+            intern_non_terminal(prod.head);
+            for (const auto &sym: prod.body) {
+                if (sym.is_terminal()) {
+                    intern_terminal(sym);
+                } else if (sym.is_non_terminal()) {
+                    intern_non_terminal(sym);
+                }
+            }
         }
+        index_token_terminals();
+    }
 
-        bool changed = true;
-        while (changed) {
-            changed = false;
+    void Grammar::index_token_terminals() {
+        // every token type maps to one category, so the type alone picks the terminal
+        token_terminals_.fill(kNoTerminal);
+        for (const auto &[token, sym]: token_to_terminal_) {
+            if (const auto it = terminal_ids_.find(sym.name); it != terminal_ids_.end()) {
+                token_terminals_[static_cast<size_t>(token.type)] = static_cast<TerminalId>(it->second);
+            }
+        }
+    }
 
-            // For each non-terminal A
-            for (const auto &nt: non_terminals) {
-                auto k = NT(nt);
+    SequenceFirst Grammar::first_of_symbols(const std::vector<Symbol> &body, const size_t pos) const {
+        SequenceFirst result{TerminalSet(terminal_symbols_.size()), true};
+        for (size_t i = pos; i < body.size(); ++i) {
+            const auto &Y = body[i];
+            // explicit ε in the body: it only contributes nullability
+            if (Y.is_epsilon()) continue;
 
-                // For each production A → body
-                for (const auto &i: production_map[nt]) {
-                    const auto &body = productions[i].body;
+            if (Y.is_terminal()) {
+                // terminals outside the grammar have no id and match nothing
+                if (const auto it = terminal_ids_.find(Y.name); it != terminal_ids_.end()) {
+                    result.first.insert(it->second);
+                }
+                result.nullable = false;
+                break;
+            }
 
-                    // Case: A → ε
-                    if (body.size() == 1 && body[0].is_epsilon()) {
-                        if (!first_set_[k].contains(Symbol::Epsilon())) {
-                            first_set_[k].insert(Symbol::Epsilon());
-                            changed = true;
-                        }
-                        continue;
-                    }
+            const auto it = nonterminal_ids_.find(Y.name);
+            if (it == nonterminal_ids_.end()) {
+                // no FIRST information for Y, treat as non-nullable
+                result.nullable = false;
+                break;
+            }
+            result.first.merge(first_bits_[it->second]);
 
-                    bool all_nullable = true;
-                    // A → Y1 Y2 ... Yk
-                    for (const auto &Yi: body) {
-                        if (Yi.is_epsilon()) break;
-                        const auto &first_Yi = first_set_[Yi];
-
-                        // Add FIRST(Yi) \ {ε} to FIRST(A)
-                        for (const auto &sym: first_Yi) {
-                            if (sym.is_epsilon()) continue;
-                            auto [it, inserted] = first_set_[k].insert(sym);
-                            changed |= inserted;
-                        }
+            // stop when Y cannot derive ε
+            if (!nullable_[it->second]) {
+                result.nullable = false;
+                break;
+            }
+        }
+        return result;
+    }
 
-                        // If Yi is not nullable, stop
-                        if (!first_Yi.contains(Symbol::Epsilon())) {
-                            all_nullable = false;
-                            break;
-                        }
-                    }
+    void Grammar::compute_first_set() {
+        intern_symbols();
+        const size_t n_nt = nonterminal_symbols_.size();
+        const size_t n_t = terminal_symbols_.size();
+
+        // 1. nullable: a production fires once every symbol of its body is
+        // nullable, counted down as nonterminals become nullable
+        nullable_.assign(n_nt, false);
+        std::vector<size_t> pending(productions.size(), 0);
+        std::vector<std::vector<size_t> > used_in(n_nt);
+        std::vector<size_t> worklist;
+        for (size_t pid = 0; pid < productions.size(); ++pid) {
+            bool has_terminal = false;
+            for (const auto &sym: productions[pid].body) {
+                if (sym.is_terminal()) {
+                    has_terminal = true;
+                } else if (sym.is_non_terminal()) {
+                    ++pending[pid];
+                    used_in[nonterminal_ids_.at(sym.name)].push_back(pid);
+                }
+            }
+            if (has_terminal) {
+                pending[pid] = -1u; // can never become nullable
+            } else if (pending[pid] == 0) {
+                worklist.push_back(pid);
+            }
+        }
+        while (!worklist.empty()) {
+            const size_t pid = worklist.back();
+            worklist.pop_back();
+            const size_t head = nonterminal_ids_.at(productions[pid].head.name);
+            if (nullable_[head]) continue;
+            nullable_[head] = true;
+            for (const auto user: used_in[head]) {
+                if (pending[user] != -1u && --pending[user] == 0) {
+                    worklist.push_back(user);
+                }
+            }
+        }
 
-                    // If all Yi can derive ε, then add ε to FIRST(A)
-                    if (all_nullable) {
-                        auto [it, inserted] = first_set_[k].insert(Symbol::Epsilon());
-                        changed |= inserted;
-                    }
+        // 2. FIRST: seed each head with the terminals it starts with directly,
+        // and record FIRST(A) ⊇ FIRST(Y) as an edge Y -> A
+        first_bits_.assign(n_nt, TerminalSet(n_t));
+        std::vector<std::vector<size_t> > dependents(n_nt);
+        for (const auto &prod: productions) {
+            const size_t A = nonterminal_ids_.at(prod.head.name);
+            for (const auto &Y: prod.body) {
+                if (Y.is_epsilon()) continue;
+                if (Y.is_terminal()) {
+                    first_bits_[A].insert(terminal_ids_.at(Y.name));
+                    break;
+                }
+                const size_t y = nonterminal_ids_.at(Y.name);
+                if (y != A) dependents[y].push_back(A);
+                if (!nullable_[y]) break;
+            }
+        }
+
+        std::vector<char> queued(n_nt, true);
+        std::vector<size_t> queue(n_nt);
+        for (size_t i = 0; i < n_nt; ++i) queue[i] = i;
+        while (!queue.empty()) {
+            const size_t y = queue.back();
+            queue.pop_back();
+            queued[y] = false;
+            for (const auto A: dependents[y]) {
+                if (first_bits_[A].merge(first_bits_[y]) && !queued[A]) {
+                    queued[A] = true;
+                    queue.push_back(A);
                 }
             }
         }
+
+        // 3. materialize, terminals included as FIRST(a) = {a}
+        first_set_.clear();
+        for (size_t t = 1; t < n_t; ++t) {
+            first_set_[terminal_symbols_[t]].insert(terminal_symbols_[t]);
+        }
+        for (size_t A = 0; A < n_nt; ++A) {
+            auto &firsts = first_set_[nonterminal_symbols_[A]];
+            first_bits_[A].for_each([&](const size_t t) { firsts.insert(terminal_symbols_[t]); });
+            if (nullable_[A]) firsts.insert(Symbol::Epsilon());
+        }
     }
 
 
     void Grammar::compute_follow_set() {
-        follow_set_[start_symbol_].insert(Symbol::End());
-        bool changed = true;
-        while (changed) {
-            changed = false;
-            for (const auto &prod: productions) {
-                const auto &N = prod.head;
-                const auto &body = prod.body;
-                size_t n = body.size();
-                for (size_t i = 0; i < body.size(); i++) {
-                    const auto &B = body[i];
-                    if (B.is_terminal() || B.is_epsilon()) continue;
-
-                    bool all_nullable = true;
-                    // beta in body[i+1...n]
-                    for (size_t j = i + 1; j < n; j++) {
-                        const auto &Y = body[j];
-                        if (Y.is_epsilon()) continue;
-                        const auto &firstY = first_set_[Y];
-
-                        // follow(B) += FIRST(Y) \ {ε}
-                        for (const auto &sym: firstY) {
-                            if (sym.is_epsilon()) continue;
-                            auto [it, inserted] = follow_set_[B].insert(sym);
-                            changed |= inserted;
-                        }
+        const size_t n_nt = nonterminal_symbols_.size();
+        const size_t n_t = terminal_symbols_.size();
+
+        // FIRST of every production suffix, reused below and by the parsers
+        suffix_first_.assign(productions.size(), {});
+        for (size_t pid = 0; pid < productions.size(); ++pid) {
+            const auto &body = productions[pid].body;
+            auto &suffixes = suffix_first_[pid];
+            suffixes.resize(body.size() + 1, SequenceFirst{TerminalSet(n_t), true});
+            for (size_t i = body.size(); i-- > 0;) {
+                const auto &Y = body[i];
+                auto &suffix = suffixes[i];
+                if (Y.is_epsilon()) {
+                    suffix = suffixes[i + 1];
+                } else if (Y.is_terminal()) {
+                    suffix.first.insert(terminal_ids_.at(Y.name));
+                    suffix.nullable = false;
+                } else if (const size_t y = nonterminal_ids_.at(Y.name); nullable_[y]) {
+                    suffix = suffixes[i + 1];
+                    suffix.first.merge(first_bits_[y]);
+                } else {
+                    suffix.first = first_bits_[y];
+                    suffix.nullable = false;
+                }
+            }
+        }
 
-                        // if FIRST(Y) does not contain ε, stop
-                        if (!firstY.contains(Symbol::Epsilon())) {
-                            all_nullable = false;
-                            break;
-                        }
-                    }
-                    // if beta is nullable, follow(B) += follow(A)
-                    if (all_nullable) {
-                        const auto &followA = follow_set_[N];
-                        for (const auto &sym: followA) {
-                            auto [it, inserted] = follow_set_[B].insert(sym);
-                            changed |= inserted;
-                        }
-                    }
+        // FOLLOW(B) ⊇ FIRST(β) for A -> α B β, and FOLLOW(A) as an edge A -> B
+        // when β is nullable
+        follow_bits_.assign(n_nt, TerminalSet(n_t));
+        follow_bits_[nonterminal_ids_.at(start_symbol_.name)].insert(terminal_ids_.at(Symbol::End().name));
+        std::vector<std::vector<size_t> > dependents(n_nt);
+        for (size_t pid = 0; pid < productions.size(); ++pid) {
+            const auto &prod = productions[pid];
+            const size_t A = nonterminal_ids_.at(prod.head.name);
+            for (size_t i = 0; i < prod.body.size(); ++i) {
+                const auto &B = prod.body[i];
+                if (!B.is_non_terminal()) continue;
+                const size_t b = nonterminal_ids_.at(B.name);
+                const auto &[first_beta, beta_nullable] = suffix_first_[pid][i + 1];
+                follow_bits_[b].merge(first_beta);
+                if (beta_nullable && b != A) dependents[A].push_back(b);
+            }
+        }
+
+        std::vector<char> queued(n_nt, true);
+        std::vector<size_t> queue(n_nt);
+        for (size_t i = 0; i < n_nt; ++i) queue[i] = i;
+        while (!queue.empty()) {
+            const size_t A = queue.back();
+            queue.pop_back();
+            queued[A] = false;
+            for (const auto B: dependents[A]) {
+                if (follow_bits_[B].merge(follow_bits_[A]) && !queued[B]) {
+                    queued[B] = true;
+                    queue.push_back(B);
                 }
             }
         }
+
+        follow_set_.clear();
+        for (size_t A = 0; A < n_nt; ++A) {
+            auto &follows = follow_set_[nonterminal_symbols_[A]];
+            follow_bits_[A].for_each([&](const size_t t) { follows.insert(terminal_symbols_[t]); });
+        }
     }
 }
@@ -12,7 +12,7 @@ namespace front::grammar {
                        build_single_forward, {{"Program", "EOF"}});
 
         // compUnit -> ( decl | funcDef)*
-        add_production("CompUnit", {Epsilon()}, [](std::vector<SemVal> &) -> SemVal {
+        add_production("CompUnit", {Epsilon()}, [](std::span<SemVal>) -> SemVal {
             return ProgramPtr(std::make_unique<Program>());
         });
         add_production("CompUnit", {NT("CompUnitList")}, build_single_forward);
@@ -147,7 +147,7 @@ namespace front::grammar {
 
         // primaryExp -> '(' exp ')'
         add_production("PrimaryExp", {T("("), NT("Exp"), T(")")},
-                       [](std::vector<SemVal> &rhs) { return std::move(rhs[1]); },
+                       [](std::span<SemVal> rhs) { return std::move(rhs[1]); },
                        {{"primaryExp", ")"}});
 
         add_production("PrimaryExp", {NT("LVal")},
@@ -178,7 +178,7 @@ namespace front::grammar {
 
         // FuncRParamsOpt
         add_production("FuncRParamsOpt", {Epsilon()},
-                       [](std::vector<SemVal> &) { return SemVal{}; });
+                       [](std::span<SemVal>) { return SemVal{}; });
         add_production("FuncRParamsOpt", {NT("FuncRParams")}, build_single_forward);
 
         // unaryOp -> '+' | '-' | '!';
@@ -264,6 +264,15 @@ namespace front::grammar {
         // floatConst -> [0-9]+'.'[0-9]+
         add_production("FloatConst", {T("LiteralFloat")}, build_single_forward);
 
+        // error recovery: a broken statement becomes an empty one, a broken
+        // top-level item is dropped from the program
+        recovery_points_ = {
+            {NT("BlockItem"), build_block_item_error},
+            {NT("CompUnitItem"), [](std::span<SemVal>) -> SemVal { return std::monostate{}; }},
+        };
+
+        incremental_unit_ = NT("CompUnitItem");
+
         init_token_map();
     }
 
@@ -314,5 +323,7 @@ namespace front::grammar {
         // Func Decl
         token_to_terminal_[{TokenType::KwIntFunc, TokenCategory::FuncDef}] = T("func_int");
         token_to_terminal_[{TokenType::KwFloatFunc, TokenCategory::FuncDef}] = T("func_float");
+
+        index_token_terminals();
     }
 }
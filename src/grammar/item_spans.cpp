@@ -0,0 +1,192 @@
+#include "grammar/item_spans.h"
+
+
+namespace front::grammar {
+    ItemSpans::ItemSpans(const std::span<const ItemSpan> spans) {
+        nodes_.reserve(spans.size());
+        size_t end = 0;
+        for (const auto &span: spans) {
+            root_ = merge(root_, make(span.begin - end, span));
+            end = span.end;
+        }
+        touched_ = 0;
+    }
+
+    ItemSpan ItemSpans::at(size_t i) const {
+        // `end` is the absolute end of the items left of the current subtree
+        size_t end = 0, functions_before = 0, index = i;
+        uint32_t n = root_;
+        while (true) {
+            const auto &node = nodes_[n];
+            const size_t left = count(node.left);
+            if (i < left) {
+                n = node.left;
+                continue;
+            }
+            end += width(node.left);
+            functions_before += functions(node.left);
+            if (i == left) {
+                const size_t begin = end + node.gap;
+                return {begin, begin + node.length, node.function,
+                        index - functions_before, functions_before, node.arena};
+            }
+            end += node.gap + node.length;
+            functions_before += node.function;
+            i -= left + 1;
+            n = node.right;
+        }
+    }
+
+    size_t ItemSpans::first_ending_at_or_after(const size_t token) const {
+        size_t end = 0, index = 0, found = size();
+        for (uint32_t n = root_; n != kNil;) {
+            const auto &node = nodes_[n];
+            const size_t node_end = end + width(node.left) + node.gap + node.length;
+            if (node_end >= token) {
+                found = index + count(node.left);
+                n = node.left;
+            } else {
+                end = node_end;
+                index += count(node.left) + 1;
+                n = node.right;
+            }
+        }
+        return found;
+    }
+
+    size_t ItemSpans::first_beginning_after(const size_t token) const {
+        size_t end = 0, index = 0, found = size();
+        for (uint32_t n = root_; n != kNil;) {
+            const auto &node = nodes_[n];
+            const size_t node_begin = end + width(node.left) + node.gap;
+            if (node_begin > token) {
+                found = index + count(node.left);
+                n = node.left;
+            } else {
+                end = node_begin + node.length;
+                index += count(node.left) + 1;
+                n = node.right;
+            }
+        }
+        return found;
+    }
+
+    std::vector<const ast::Arena *> ItemSpans::replace(const size_t lo, const size_t hi,
+                                                       const std::span<const ItemSpan> spans,
+                                                       const std::ptrdiff_t shift) {
+        touched_ = 0;
+        const auto [before, rest] = split(root_, lo);
+        const auto [removed, after] = split(rest, hi - lo);
+
+        // width(before) is where item lo - 1 ends, in the old and new stream
+        const size_t before_end = width(before);
+        const size_t old_end = before_end + width(removed);
+        std::vector<const ast::Arena *> arenas;
+        arenas.reserve(count(removed));
+        release(removed, arenas);
+
+        uint32_t inserted = kNil;
+        size_t end = before_end;
+        for (const auto &span: spans) {
+            inserted = merge(inserted, make(span.begin - end, span));
+            end = span.end;
+        }
+
+        // only the first later item measures its gap from the edited region
+        auto [next, tail] = split(after, 1);
+        if (next != kNil) {
+            const auto old_begin = static_cast<std::ptrdiff_t>(old_end + nodes_[next].gap);
+            nodes_[next].gap = static_cast<size_t>(old_begin + shift) - end;
+            update(next);
+        }
+        root_ = merge(merge(before, inserted), merge(next, tail));
+        return arenas;
+    }
+
+    std::vector<ItemSpan> ItemSpans::spans() const {
+        std::vector<ItemSpan> out;
+        out.reserve(size());
+        size_t end = 0, functions_before = 0;
+        // in-order walk with an explicit stack
+        std::vector<uint32_t> stack;
+        for (uint32_t n = root_; n != kNil || !stack.empty();) {
+            for (; n != kNil; n = nodes_[n].left) stack.push_back(n);
+            n = stack.back();
+            stack.pop_back();
+            const auto &node = nodes_[n];
+            const size_t begin = end + node.gap;
+            end = begin + node.length;
+            out.push_back({begin, end, node.function, out.size() - functions_before, functions_before, node.arena});
+            functions_before += node.function;
+            n = node.right;
+        }
+        return out;
+    }
+
+    uint32_t ItemSpans::make(const size_t gap, const ItemSpan &span) {
+        // xorshift keeps the shape deterministic run to run
+        seed_ ^= seed_ << 13;
+        seed_ ^= seed_ >> 17;
+        seed_ ^= seed_ << 5;
+        Node node;
+        node.priority = seed_;
+        node.function = span.function;
+        node.arena = span.arena;
+        node.gap = gap;
+        node.length = span.end - span.begin;
+        uint32_t n;
+        if (!free_.empty()) {
+            n = free_.back();
+            free_.pop_back();
+            nodes_[n] = node;
+        } else {
+            n = static_cast<uint32_t>(nodes_.size());
+            nodes_.push_back(node);
+        }
+        update(n);
+        return n;
+    }
+
+    void ItemSpans::update(const uint32_t n) {
+        auto &node = nodes_[n];
+        node.count = count(node.left) + 1 + count(node.right);
+        node.width = width(node.left) + node.gap + node.length + width(node.right);
+        node.functions = functions(node.left) + node.function + functions(node.right);
+        ++touched_;
+    }
+
+    std::pair<uint32_t, uint32_t> ItemSpans::split(const uint32_t n, const size_t k) {
+        if (n == kNil) return {kNil, kNil};
+        if (k <= count(nodes_[n].left)) {
+            const auto [l, r] = split(nodes_[n].left, k);
+            nodes_[n].left = r;
+            update(n);
+            return {l, n};
+        }
+        const auto [l, r] = split(nodes_[n].right, k - count(nodes_[n].left) - 1);
+        nodes_[n].right = l;
+        update(n);
+        return {n, r};
+    }
+
+    uint32_t ItemSpans::merge(const uint32_t l, const uint32_t r) {
+        if (l == kNil) return r;
+        if (r == kNil) return l;
+        if (nodes_[l].priority > nodes_[r].priority) {
+            nodes_[l].right = merge(nodes_[l].right, r);
+            update(l);
+            return l;
+        }
+        nodes_[r].left = merge(l, nodes_[r].left);
+        update(r);
+        return r;
+    }
+
+    void ItemSpans::release(const uint32_t n, std::vector<const ast::Arena *> &arenas) {
+        if (n == kNil) return;
+        release(nodes_[n].left, arenas);
+        arenas.push_back(nodes_[n].arena);
+        release(nodes_[n].right, arenas);
+        free_.push_back(n);
+    }
+}
@@ -4,9 +4,9 @@
 
 #include "grammar/parser_ll.h"
 
+#include <algorithm>
 #include <iostream>
 #include <ranges>
-#include <stack>
 
 #include "grammar/parser.h"
 
@@ -24,80 +24,25 @@ namespace front::grammar {
     }
 
     void LL1Parser::print_parse_table() {
-        std::cout << "LL(1) Parse Table Computed with " << parse_table_.size() << " Entries." << std::endl;
-        for (const auto &[k,v]: parse_table_) {
-            std::cout << "M[" << k.first.name << ", " << k.second.name << "] = " << v << std::endl;
+        const size_t entries = static_cast<size_t>(std::ranges::count_if(
+            table_, [](const int pid) { return pid != kNoProduction; }));
+        std::cout << "LL(1) Parse Table Computed with " << entries << " Entries." << std::endl;
+        for (size_t i = 0; i < table_.size(); ++i) {
+            if (table_[i] == kNoProduction) continue;
+            const auto &A = grammar_.nonterminal_symbols_[i / n_terminals_];
+            const auto &a = grammar_.terminal_symbols_[i % n_terminals_];
+            std::cout << "M[" << A.name << ", " << a.name << "] = " << grammar_.productions[table_[i]] << std::endl;
         }
     }
 
 
     std::vector<ParseStep> LL1Parser::parse(const std::vector<Token> &tokens) const {
-        const auto &token_map = grammar_.token_to_terminal_;
-        std::stack<Symbol> parse_stack;
-        parse_stack.push(End());
-        parse_stack.push(grammar_.start_symbol_);
-        size_t curr = 0;
-
-        std::vector<ParseStep> result;
-        result.reserve(tokens.size() * 2);
-
-        while (!parse_stack.empty()) {
-            const auto &X = parse_stack.top();
-            const auto &a_token = tokens[curr];
-
-            if (!token_map.contains(a_token)) {
-                result.emplace_back(X, Symbol::Terminal(a_token.lexeme), Error);
-                std::cerr << "Parse Error! at line: "
-                        << a_token.loc.line << ", col:" << a_token.loc.column << std::endl;
-                if (a_token.category == TokenCategory::Invalid)
-                    std::cerr << "Unexpected token:" << a_token.lexeme << std::endl;
-                else
-                    std::cerr << "Token not in grammar terminal set: " << a_token << std::endl;
-                return result;
-            }
-            const auto &a = token_map.at(a_token);
-
-            if (X.is_end() && a.is_end()) {
-                result.emplace_back(X, a, Accept);
-                parse_stack.pop();
-                break;
-            }
-
-            if (X.is_terminal()) {
-                if (X == a) {
-                    result.emplace_back(X, a, Move);
-                    parse_stack.pop();
-                    curr++;
-                } else {
-                    result.emplace_back(X, a, Error);
-                    std::cerr << "Parse Error! at line: "
-                            << a_token.loc.line << ", col:" << a_token.loc.column << std::endl;
-                    std::cerr << "Expected terminal: " << X.name << ", but got: " << a.name << std::endl;
-                    return result;
-                }
-            } else if (X.is_non_terminal()) {
-                if (parse_table_.contains({X, a})) {
-                    const auto &prod = parse_table_.at({X, a});
-                    result.emplace_back(X, a, Reduction);
-                    parse_stack.pop();
-                    // push alpha in reverse order
-                    for (const auto &it: std::ranges::reverse_view(prod.body)) {
-                        if (it.is_epsilon()) continue;
-                        parse_stack.push(it);
-                    }
-                } else {
-                    result.emplace_back(X, a, Error);
-                    std::cerr << "Parse Error! at line: "
-                            << a_token.loc.line << ", col:" << a_token.loc.column << std::endl;
-                    std::cerr << "No production found for M[" << X.name << ", " << a.name << "]" << std::endl;
-                    return result;
-                }
-            } else if (X.is_epsilon()) {
-                parse_stack.pop();
-            }
+        VectorTraceSink trace;
+        trace.steps.reserve(tokens.size() * 2);
+        if (parse(tokens, trace)) {
+            std::cout << "Parse Successful!" << std::endl;
         }
-        std::cout << "Parse Successful!" << std::endl;
-        return result;
+        return std::move(trace.steps);
     }
 
     std::vector<Token> LL1Parser::preprocess_tokens(const std::vector<Token> &tokens) {
@@ -127,27 +72,43 @@ namespace front::grammar {
 
 
     void LL1Parser::compute_action_table() {
+        const auto &productions = grammar_.productions;
+        n_terminals_ = grammar_.terminal_symbols_.size();
+        const auto id_of = [&](const Symbol &sym) -> SymbolId {
+            if (sym.is_terminal()) return static_cast<SymbolId>(grammar_.terminal_ids_.at(sym.name));
+            return static_cast<SymbolId>(n_terminals_ + grammar_.nonterminal_ids_.at(sym.name));
+        };
+        start_ = id_of(grammar_.start_symbol_);
+
+        // reversed right-hand sides, ready to be pushed onto the parse stack
+        rhs_.clear();
+        rhs_begin_.assign(1, 0);
+        for (const auto &prod: productions) {
+            for (const auto &sym: std::ranges::reverse_view(prod.body)) {
+                if (sym.is_epsilon()) continue;
+                rhs_.push_back(id_of(sym));
+            }
+            rhs_begin_.push_back(rhs_.size());
+        }
+
         // For each production A -> alpha
         // a in FIRST(alpha) and a is not EPS, M[A, a] = A -> alpha
         // EPS in FIRST(alpha), for b in FOLLOW(A), M[A, b] = A -> alpha
         // else error
-        for (const auto &prod: grammar_.productions) {
-            const auto &A = prod.head;
-            const auto &alpha = prod.body;
-            const auto &first_alpha = grammar_.first_of_sequence(alpha);
-
+        table_.assign(grammar_.nonterminal_symbols_.size() * n_terminals_, kNoProduction);
+        for (size_t pid = 0; pid < productions.size(); ++pid) {
+            const size_t row = grammar_.nonterminal_ids_.at(productions[pid].head.name) * n_terminals_;
+            const auto &[first_alpha, nullable] = grammar_.first_of_suffix(pid, 0);
 
             // For each terminal a in FIRST(alpha) \ {EPS}
-            for (const auto &a: first_alpha) {
-                if (a.is_epsilon()) continue;
-                parse_table_[{A, a}] = prod;
-            }
-
-            if (first_alpha.contains(Symbol::Epsilon())) {
-                const auto &follow_A = grammar_.follow_set_.at(A);
-                for (const auto &b: follow_A) {
-                    parse_table_[{A, b}] = prod;
-                }
+            first_alpha.for_each([&](const size_t a) {
+                table_[row + a] = static_cast<int>(pid);
+            });
+
+            if (nullable) {
+                grammar_.follow_of(productions[pid].head).for_each([&](const size_t b) {
+                    table_[row + b] = static_cast<int>(pid);
+                });
             }
         }
     }
@@ -1,22 +1,93 @@
 #include "grammar/parser_slr.h"
 
 #include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <iterator>
 #include <iostream>
+#include <numeric>
+#include <optional>
 #include <queue>
+#include <span>
 #include<vector>
 #include <string>
+#include <tuple>
 
 
 #include "grammar/grammar.h"
 #include "grammar/parser.h"
 #include "ast/ast.h"
+#include "lexer/token_pipeline.h"
+#include "lexer/token_ring.h"
 #include "token.h"
+#include "utils/thread_pool.h"
 
 namespace front::grammar {
-    SLRParser::SLRParser(Grammar grammar) : grammar_(std::move(grammar)) {
-        init_item_set();
+    SLRParser::SLRParser(Grammar grammar, const size_t build_threads) : grammar_(std::move(grammar)) {
+        actions_.reserve(grammar_.productions.size());
+        pop_counts_.reserve(grammar_.productions.size());
+        for (const auto &prod: grammar_.productions) {
+            actions_.push_back(prod.action);
+            has_actions_ = has_actions_ || prod.action != nullptr;
+            pop_counts_.push_back(static_cast<size_t>(std::ranges::count_if(
+                prod.body, [](const Symbol &sym) { return !sym.is_epsilon(); })));
+            unit_productions_.push_back(!grammar_.incremental_unit_.name.empty() &&
+                                        prod.head == grammar_.incremental_unit_);
+            heads_.push_back(grammar_.nonterminal_ids_.at(prod.head.name));
+        }
 
+        for (const auto &[nonterminal, placeholder]: grammar_.recovery_points_) {
+            const auto it = grammar_.nonterminal_ids_.find(nonterminal.name);
+            recovery_ids_.push_back(it == grammar_.nonterminal_ids_.end() ? SIZE_MAX : it->second);
+        }
+        const auto terminal_id = [&](const std::string &name) {
+            const auto it = grammar_.terminal_ids_.find(name);
+            return it == grammar_.terminal_ids_.end() ? kNoTerminal : static_cast<TerminalId>(it->second);
+        };
+        semicolon_ = terminal_id(";");
+        right_brace_ = terminal_id("}");
+
+        using clock = std::chrono::steady_clock;
+        using ms = std::chrono::duration<double, std::milli>;
+
+        const auto start = clock::now();
+        init_item_set(build_threads);
+        const auto item_sets_done = clock::now();
         calc_action_goto_tables();
+
+        build_stats_.item_sets_ms = ms(item_sets_done - start).count();
+        build_stats_.tables_ms = ms(clock::now() - item_sets_done).count();
+        build_stats_.states = item_sets_.size();
+        build_stats_.action_entries = action_table_.size();
+        build_stats_.goto_entries = goto_table_.size();
+    }
+
+    const SLRParser &SLRParser::shared() {
+        static const SLRParser parser{Grammar{}};
+        return parser;
+    }
+
+    std::vector<ParseResult> SLRParser::parse_batch(const std::span<const std::vector<Token> > inputs,
+                                                    const size_t threads) const {
+        std::vector<ParseResult> results(inputs.size());
+        const size_t workers = std::min(threads == 0 ? ThreadPool::default_threads() : threads, inputs.size());
+        if (workers <= 1) {
+            for (size_t i = 0; i < inputs.size(); ++i) {
+                results[i] = parse(inputs[i]);
+            }
+            return results;
+        }
+
+        // one task per input, so a few large files do not serialize a chunk
+        ThreadPool pool{workers};
+        std::vector<std::future<void> > pending;
+        pending.reserve(inputs.size());
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            pending.push_back(pool.submit([&, i] { results[i] = parse(inputs[i]); }));
+        }
+        for (auto &p: pending) p.get();
+        return results;
     }
 
     void SLRParser::print_item_sets(std::ostream &os) const {
@@ -52,7 +123,7 @@ namespace front::grammar {
     }
 
 
-    void SLRParser::closure(std::unordered_set<Item, ItemHash> &closure) {
+    void SLRParser::closure(std::unordered_set<Item, ItemHash> &closure) const {
         std::queue<Item> q;
         for (const auto &it: closure) q.push(it);
 
@@ -68,14 +139,14 @@ namespace front::grammar {
 
             for (auto prod_id: it->second) {
                 const auto &prod = grammar_.productions[prod_id];
-                Item new_item{std::make_shared<Production>(prod), 0};
+                Item new_item{&prod, 0};
                 auto [iter, inserted] = closure.insert(new_item);
                 if (inserted) {
                     q.push(*iter);
                 }
 
                 if (prod.body.size() == 1 && prod.body[0].is_epsilon()) {
-                    Item complete_item{std::make_shared<Production>(prod), 1};
+                    Item complete_item{&prod, 1};
                     auto [it2, inserted2] = closure.insert(complete_item);
                     if (inserted2) {
                         q.push(*it2);
@@ -85,46 +156,100 @@ namespace front::grammar {
         }
     }
 
+    SLRParser::ItemSetType SLRParser::closure_of(const std::vector<Item> &kernel) const {
+        ItemSetType items(kernel.begin(), kernel.end());
+        closure(items);
+        return items;
+    }
 
-    void SLRParser::init_item_set() {
-        // I0 = closure({ [S' -> .S] })
-        ItemSetType start_items;
-        const auto &start_prod = grammar_.productions[0];
-        start_items.insert(Item{std::make_shared<Production>(start_prod), 0});
-        closure(start_items);
-
-        auto [start_id, is_new] = add_state(std::move(start_items));
-
-        std::queue<int> workList;
-        workList.push(start_id);
+    std::vector<SLRParser::Transition> SLRParser::goto_kernels(const ItemSetType &items) const {
+        std::vector<Transition> transitions;
 
-        while (!workList.empty()) {
-            int I_id = workList.front();
-            workList.pop();
-            const auto &curr_set = item_sets_[I_id].items;
+        // for each item [A -> α.Xβ] in I, group A -> αX.β by X
+        for (const auto &item: items) {
+            if (item.is_complete()) continue;
+            Symbol X = item.dot();
+            if (X.is_epsilon()) continue;
 
-            std::unordered_map<Symbol, ItemSetType, SymbolHash> symbol_groups;
+            auto it = std::ranges::find(transitions, X, &Transition::symbol);
+            if (it == transitions.end()) {
+                transitions.push_back({std::move(X), {}});
+                it = std::prev(transitions.end());
+            }
+            it->kernel.push_back(item.next());
+        }
 
-            // for each item [A -> α.Xβ] in I, group by X
-            // insert A -> αX.β , collect in symbol_groups
-            for (const auto &item: curr_set) {
-                if (item.is_complete()) continue;
-                Symbol X = item.dot();
-                if (X == Symbol::Epsilon()) continue;
+        // fixed symbol order keeps state numbering independent of hashing
+        std::ranges::sort(transitions, [](const Transition &l, const Transition &r) {
+            return std::tie(l.symbol.type, l.symbol.name) < std::tie(r.symbol.type, r.symbol.name);
+        });
+        for (auto &t: transitions) {
+            std::ranges::sort(t.kernel, std::less{});
+        }
+        return transitions;
+    }
 
-                auto &J = symbol_groups[X];
-                J.insert(item.next());
+    void SLRParser::init_item_set(const size_t threads) {
+        // I0 = closure({ [S' -> .S] })
+        std::vector start_kernel{Item{&grammar_.productions[0], 0}};
+        item_sets_.push_back({0, closure_of(start_kernel)});
+        state_id_.emplace(std::move(start_kernel), 0);
+
+        // only spun up once a frontier is wide enough to be worth it
+        std::optional<ThreadPool> pool;
+        std::vector<int> frontier{0};
+
+        while (!frontier.empty()) {
+            const bool parallel = threads != 1 && frontier.size() >= kParallelFrontier;
+            if (parallel && !pool) {
+                pool.emplace(threads == 0 ? ThreadPool::default_threads() : threads);
             }
-
-            // for X in symbols:  GO(I, X) = closure(J_X)
-            for (auto &[X, kernel]: symbol_groups) {
-                closure(kernel);
-                auto [J_id, inserted] = add_state(std::move(kernel));
-                go_func_[{I_id, X}] = J_id;
-                if (inserted) {
-                    workList.push(J_id);
+            const auto for_each_index = [&](const size_t n, auto &&f) {
+                if (parallel) {
+                    pool->parallel_for(n, f);
+                } else {
+                    for (size_t i = 0; i < n; ++i) f(i);
+                }
+            };
+
+            // step1. GO kernels of every frontier state, resolved against the
+            // states known so far; state_id_ is only read during this step
+            std::vector<std::vector<Transition> > transitions(frontier.size());
+            for_each_index(frontier.size(), [&](const size_t i) {
+                transitions[i] = goto_kernels(item_sets_[frontier[i]].items);
+                for (auto &t: transitions[i]) {
+                    if (const auto it = state_id_.find(t.kernel); it != state_id_.end()) {
+                        t.target = it->second;
+                    }
+                }
+            });
+
+            // step2. number unseen kernels serially in (state, symbol) order
+            const size_t first_new = item_sets_.size();
+            std::vector<const std::vector<Item> *> new_kernels;
+            for (size_t i = 0; i < frontier.size(); ++i) {
+                for (auto &[X, kernel, target]: transitions[i]) {
+                    if (target < 0) {
+                        const int id = static_cast<int>(first_new + new_kernels.size());
+                        auto [it, inserted] = state_id_.try_emplace(std::move(kernel), id);
+                        if (inserted) {
+                            new_kernels.push_back(&it->first);
+                        }
+                        target = it->second;
+                    }
+                    go_func_[{frontier[i], X}] = target;
                 }
             }
+
+            // step3. close the new kernels
+            item_sets_.resize(first_new + new_kernels.size());
+            for_each_index(new_kernels.size(), [&](const size_t j) {
+                const int id = static_cast<int>(first_new + j);
+                item_sets_[id] = {id, closure_of(*new_kernels[j])};
+            });
+
+            frontier.resize(new_kernels.size());
+            std::iota(frontier.begin(), frontier.end(), static_cast<int>(first_new));
         }
     }
 
@@ -182,8 +307,8 @@ namespace front::grammar {
                     );
                 } else {
                     // A -> alpha .
-                    for (const auto &follow_set = grammar_.follow_set_[prod.head];
-                         const auto &a: follow_set) {
+                    grammar_.follow_of(prod.head).for_each([&](const size_t t) {
+                        const auto &a = grammar_.terminal_symbols_[t];
                         auto existing_it = action_table_.find({k, a});
 
                         if (existing_it != action_table_.end()) {
@@ -193,13 +318,13 @@ namespace front::grammar {
                             if (existing_action.type == SLRAction::ActionType::Shift) {
                                 // Shift First (Resolve in favor of Shift)
                                 // resolve dangling-else conflicts in favor of shift
-                                continue;
+                                return;
                             }
 
                             // reduce -> reduce
                             if (existing_action.type == SLRAction::ActionType::Reduce) {
                                 std::cerr << "Warning: Reduce/Reduce conflict ignored." << std::endl;
-                                continue;
+                                return;
                             }
                         }
 
@@ -208,192 +333,237 @@ namespace front::grammar {
                             {k, a},
                             SLRAction::reduce(static_cast<int>(prod.id))
                         );
-                    }
+                    });
                 }
             }
         }
-    }
 
-    std::pair<int, bool> SLRParser::add_state(ItemSetType &&items) {
-        auto key = make_key(items);
-        if (const auto it = state_id_.find(key);
-            it != state_id_.end()) {
-            return {it->second, false};
+        // step3. flatten both tables for the parse loop
+        n_nonterminals_ = grammar_.nonterminal_symbols_.size();
+        action_rows_.assign(item_sets_.size() * kTokenTypeCount, SLRAction::error());
+        goto_rows_.assign(item_sets_.size() * n_nonterminals_, -1);
+        // token types sharing a terminal (Ident and main) share its column
+        std::vector<std::vector<size_t> > types_of(grammar_.terminal_symbols_.size());
+        for (size_t type = 0; type < kTokenTypeCount; ++type) {
+            if (const TerminalId t = grammar_.token_terminals_[type]; t != kNoTerminal) {
+                types_of[t].push_back(type);
+            }
+        }
+        for (const auto &[key, action]: action_table_) {
+            const auto &[state, sym] = key;
+            for (const size_t type: types_of[grammar_.terminal_ids_.at(sym.name)]) {
+                action_rows_[static_cast<size_t>(state) * kTokenTypeCount + type] = action;
+            }
+        }
+        for (const auto &[key, to_state]: goto_table_) {
+            const auto &[state, sym] = key;
+            goto_rows_[static_cast<size_t>(state) * n_nonterminals_ + grammar_.nonterminal_ids_.at(sym.name)] = to_state;
         }
-
-        int id = static_cast<int>(item_sets_.size());
-        ItemSet set{id, std::move(items)};
-        item_sets_.push_back(std::move(set));
-        state_id_.emplace(std::move(key), id);
-        return {id, true};
     }
 
+    template<TokenSource Source>
+    bool SLRParser::recover(Source &source, size_t &resumed_at,
+                            std::vector<int> &state_stack, std::vector<ast::SemVal> &val_stack) const {
+        const auto terminal_here = [&] {
+            const Token *token = source.current();
+            return token ? grammar_.terminal_of(*token) : kNoTerminal;
+        };
+
+        // a second error at the position we just resumed from would retry the
+        // same recovery forever, so discard that token first
+        if (source.position() == resumed_at) {
+            if (terminal_here() == kEndTerminal) return false;
+            source.advance();
+        }
 
-    static std::string trace_lhs_for_token(const Token &tok) {
-        switch (tok.type) {
-            case TokenType::Identifier:
-                return "Ident";
-
-            case TokenType::LiteralInt:
-                return "IntConst";
-
-            case TokenType::LiteralFloat:
-                return "floatConst";
+        while (source.current() != nullptr) {
+            TerminalId a = terminal_here();
+            if (a != kNoTerminal && a == semicolon_) {
+                source.advance();
+                a = terminal_here();
+                if (a == kNoTerminal) continue;
+            } else if (a == kNoTerminal || (a != right_brace_ && a != kEndTerminal)) {
+                source.advance();
+                continue;
+            }
 
-            case TokenType::KwInt:
-            case TokenType::KwVoid:
-            case TokenType::KwReturn:
-            case TokenType::KwFloat:
-            case TokenType::KwIf:
-            case TokenType::KwElse:
-            case TokenType::KwConst:
-                return tok.lexeme;
-            case TokenType::KwMain:
-                return "Ident";
+            const TokenType type = source.current()->type;
+            for (size_t depth = state_stack.size(); depth-- > 0;) {
+                for (size_t r = 0; r < recovery_ids_.size(); ++r) {
+                    if (recovery_ids_[r] == SIZE_MAX) continue;
+                    const int target = goto_at(state_stack[depth], recovery_ids_[r]);
+                    if (target < 0) continue;
+                    if (action_at(target, type).type == SLRAction::ActionType::Error) continue;
+
+                    const ActionFn placeholder = grammar_.recovery_points_[r].placeholder;
+                    state_stack.resize(depth + 1);
+                    val_stack.resize(depth);
+                    state_stack.push_back(target);
+                    val_stack.push_back(placeholder ? placeholder({}) : ast::SemVal{});
+                    resumed_at = source.position();
+                    return true;
+                }
+            }
 
-            default:
-                return tok.lexeme;
+            if (a == kEndTerminal) return false;
+            source.advance();
         }
-    }
 
+        return false;
+    }
 
-    ParseResult SLRParser::parse(const std::vector<Token> &tokens) const {
-        const auto &token_map = grammar_.token_to_terminal_;
-
-        std::vector<int> state_stack;
-        state_stack.push_back(0); // start state
-        std::vector<ast::SemVal> val_stack;
-
-        size_t curr = 0;
-        std::vector<ParseStep> result;
-        result.reserve(tokens.size() * 2);
+    template bool SLRParser::recover(VectorTokenSource &, size_t &,
+                                     std::vector<int> &, std::vector<ast::SemVal> &) const;
 
-        while (!state_stack.empty()) {
-            int s = state_stack.back();
+    template bool SLRParser::recover(lexer::TokenRing &, size_t &,
+                                     std::vector<int> &, std::vector<ast::SemVal> &) const;
 
-            Token current_token;
-            Symbol a;
+    template bool SLRParser::recover(lexer::TokenPipeline &, size_t &,
+                                     std::vector<int> &, std::vector<ast::SemVal> &) const;
 
-            if (curr < tokens.size()) {
-                current_token = tokens[curr];
-                if (!token_map.contains(current_token)) {
-                    result.emplace_back(Symbol::NonTerminal("ERROR"),
-                                        Symbol::Terminal(current_token.lexeme),
-                                        Error);
+    namespace {
+        // records the token range of every reduction to the incremental unit
+        struct ItemSpanSink {
+            static constexpr bool enabled = false;
 
-                    std::cerr << "Parse Error! at line: " << current_token.loc.line
-                            << ", col: " << current_token.loc.column << std::endl;
-                    std::cerr << "unexpected symbol: " << current_token.lexeme << std::endl;
+            const std::vector<char> &unit_productions;
+            std::vector<ItemSpan> &items;
 
+            void step(std::string_view, std::string_view, ParseAction) {
+            }
 
-                    return {{}, result, false};
+            void reduced(const size_t production, const size_t begin, const size_t end, const ast::SemVal &value) {
+                if (unit_productions[production]) {
+                    items.push_back({begin, end, std::holds_alternative<ast::FuncPtr>(value)});
                 }
-                a = token_map.at(current_token);
-            } else {
-                std::cerr << "Error: Reached end of input tokens, using End symbol as lookahead." << std::endl;
-                return {{}, result, false};
             }
-
-
-            auto action_it = action_table_.find({s, a});
-            if (action_it == action_table_.end()) {
-                result.emplace_back(Symbol::NonTerminal("ERROR"), a, Error);
-                std::cerr << "Parse Error! at line: " << current_token.loc.line
-                        << ", col: " << current_token.loc.column << std::endl;
-                std::cerr << "No action for state " << s << " and lookahead " << a.name << std::endl;
-                return {{}, result, false};
+        };
+
+        // TokenSource over a slice of the token stream followed by its EOF,
+        // so a region is parsed where it lies instead of from a copy
+        class FragmentTokenSource {
+        public:
+            FragmentTokenSource(const std::span<const Token> tokens, const Token &eof)
+                : tokens_(tokens), eof_(eof) {
             }
 
-            switch (const SLRAction &act = action_it->second; act.type) {
-                case SLRAction::ActionType::Shift: {
-                    // Shift
-                    Symbol lhs = T(trace_lhs_for_token(current_token));
-                    Symbol rhs = T(current_token.lexeme);
-                    result.emplace_back(lhs, rhs, Move);
-                    state_stack.push_back(act.target);
-
-                    val_stack.push_back(ast::make_semantic(current_token));
-
-                    if (curr < tokens.size()) {
-                        curr++;
-                    }
-                    break;
-                }
+            [[nodiscard]] const Token *current() const {
+                if (pos_ < tokens_.size()) return &tokens_[pos_];
+                return pos_ == tokens_.size() ? &eof_ : nullptr;
+            }
 
-                case SLRAction::ActionType::Reduce: {
-                    // Reduce
-                    const auto &prod = grammar_.productions[act.target];
-                    Symbol top_symbol = prod.head;
-                    if (prod.trace.has_value()) {
-                        result.emplace_back(NT(prod.trace->first), T(prod.trace->second), Reduction);
-                    }
+            void advance() {
+                if (pos_ <= tokens_.size()) ++pos_;
+            }
 
-                    // pop stack
-                    const size_t pop_count = std::ranges::count_if(
-                        prod.body, [](const Symbol &sym) { return !sym.is_epsilon(); }
-                    );
-                    if (state_stack.size() < pop_count) {
-                        std::cerr << "Parse Error: State stack underflow during reduce" << std::endl;
-                        return {{}, result, false};
-                    }
+            [[nodiscard]] size_t position() const { return pos_; }
 
-                    std::vector<ast::SemVal> rhs_vals;
-                    rhs_vals.reserve(pop_count);
-                    {
-                        const auto start_it = val_stack.end() - static_cast<int>(pop_count);
-                        std::ranges::move(
-                            std::ranges::subrange(start_it, val_stack.end()),
-                            std::back_inserter(rhs_vals)
-                        );
-                    }
+            [[nodiscard]] Location end_location() const { return eof_.loc; }
 
-                    state_stack.resize(state_stack.size() - pop_count);
-                    val_stack.resize(val_stack.size() - pop_count);
-                    // execute semantic action
-                    ast::SemVal new_val{std::monostate{}};
-                    if (prod.action) {
-                        new_val = prod.action(rhs_vals);
-                    }
+        private:
+            std::span<const Token> tokens_;
+            const Token &eof_;
+            size_t pos_{0};
+        };
+    }
 
-                    // GOTO
-                    if (state_stack.empty()) {
-                        std::cerr << "Parse Error: Stack empty after pop" << std::endl;
-                        return {nullptr, result, false};
-                    }
+    IncrementalParse SLRParser::parse_incremental(const std::vector<Token> &tokens) const {
+        IncrementalParse parsed;
+        std::vector<ItemSpan> spans;
+        ItemSpanSink sink{unit_productions_, spans};
+        parsed.result = parse(tokens, sink);
+        if (parsed.result.program != nullptr && !parsed.result.program->arenas.empty()) {
+            for (auto &span: spans) {
+                span.arena = parsed.result.program->arenas.front().get();
+            }
+        }
+        parsed.items = ItemSpans{spans};
+        return parsed;
+    }
 
-                    int s_prime = state_stack.back();
-                    auto goto_it = goto_table_.find({s_prime, prod.head});
+    IncrementalParse SLRParser::reparse(IncrementalParse previous, const std::vector<Token> &tokens,
+                                        const TokenEdit &edit) const {
+        auto &items = previous.items;
+        if (!previous.result.success || previous.result.program == nullptr || items.empty() ||
+            tokens.empty() || tokens.back().type != TokenType::EndOfFile) {
+            return parse_incremental(tokens);
+        }
 
-                    if (goto_it == goto_table_.end()) {
-                        result.emplace_back(top_symbol, a, Error);
-                        std::cerr << "Parse Error: No GOTO entry for state " << s_prime
-                                << " and symbol " << prod.head.name << std::endl;
-                        return {nullptr, result, false};
-                    }
+        // items overlapping or touching the edit are parsed again, the rest
+        // stay where they are
+        const size_t lo = items.first_ending_at_or_after(edit.begin);
+        const size_t hi = std::max(lo, items.first_beginning_after(edit.old_end));
+        const ItemSpan first = lo < items.size() ? items.at(lo) : ItemSpan{};
+        const ItemSpan last = lo < hi ? items.at(hi - 1) : ItemSpan{};
+
+        const size_t region_begin = lo < hi ? std::min(edit.begin, first.begin) : edit.begin;
+        const size_t region_old_end = lo < hi ? std::max(edit.old_end, last.end) : edit.old_end;
+        const auto shift = static_cast<std::ptrdiff_t>(edit.new_end) - static_cast<std::ptrdiff_t>(edit.old_end);
+        const auto region_new_end = static_cast<std::ptrdiff_t>(region_old_end) + shift;
+        if (region_new_end < static_cast<std::ptrdiff_t>(region_begin) ||
+            region_new_end >= static_cast<std::ptrdiff_t>(tokens.size())) {
+            return parse_incremental(tokens);
+        }
 
-                    state_stack.push_back(goto_it->second);
-                    val_stack.push_back(std::move(new_val));
-                    break;
-                }
+        FragmentTokenSource source{
+            std::span{tokens}.subspan(region_begin, static_cast<size_t>(region_new_end) - region_begin),
+            tokens.back()
+        };
+        std::vector<ItemSpan> spans;
+        ItemSpanSink sink{unit_productions_, spans};
+        auto reparsed = parse_source(source, sink);
+        if (!reparsed.success || reparsed.program == nullptr) {
+            // report diagnostics against the whole file
+            return parse_incremental(tokens);
+        }
 
-                case SLRAction::ActionType::Accept: {
-                    result.emplace_back(grammar_.start_symbol_, a == End() ? T("EOF") : a, Accept);
-                    ast::ProgramPtr root = nullptr;
-                    if (!val_stack.empty()) {
-                        if (auto p = std::get_if<ast::ProgramPtr>(&val_stack.back())) {
-                            root = std::move(*p);
-                        }
-                    }
-                    return {std::move(root), result, true};
-                }
-                default: {
-                    result.emplace_back(Symbol::NonTerminal("ERROR"), a, Error);
-                    std::cerr << "Parse Error: Invalid action type." << std::endl;
-                    return {nullptr, result, false};
-                }
+        auto &program = *previous.result.program;
+        auto &fresh = *reparsed.program;
+        // where the region sits in Program::globals and Program::functions
+        const auto globals_at = [&](const size_t i) {
+            return i < items.size() ? (i == lo ? first : items.at(i)).globals_before : program.globals.size();
+        };
+        const auto functions_at = [&](const size_t i) {
+            return i < items.size() ? (i == lo ? first : items.at(i)).functions_before : program.functions.size();
+        };
+        // the items replaced one for one are assigned in place, so only a
+        // change in their number moves the later pointers
+        const auto splice = [](auto &into, const size_t from, const size_t to, auto &with) {
+            const size_t common = std::min(to - from, with.size());
+            const auto at = into.begin() + static_cast<std::ptrdiff_t>(from + common);
+            std::move(with.begin(), with.begin() + static_cast<std::ptrdiff_t>(common),
+                      into.begin() + static_cast<std::ptrdiff_t>(from));
+            if (to - from > common) {
+                into.erase(at, into.begin() + static_cast<std::ptrdiff_t>(to));
+            } else {
+                into.insert(at, std::make_move_iterator(with.begin() + static_cast<std::ptrdiff_t>(common)),
+                            std::make_move_iterator(with.end()));
             }
+        };
+        // the replaced nodes go first, so their arenas can follow them
+        splice(program.globals, globals_at(lo), globals_at(hi), fresh.globals);
+        splice(program.functions, functions_at(lo), functions_at(hi), fresh.functions);
+        program.constants_folded = false;
+
+        const ast::Arena *arena = fresh.arenas.empty() ? nullptr : fresh.arenas.front().get();
+        for (auto &span: spans) {
+            span.begin += region_begin;
+            span.end += region_begin;
+            span.arena = arena;
         }
 
-        return {nullptr, result, false};
+        // an arena added by an earlier reparse goes with its last item; the
+        // first one also holds what fold_constants() built, so it stays
+        for (const auto *removed: items.replace(lo, hi, spans, shift)) {
+            const auto it = previous.fragment_items.find(removed);
+            if (it == previous.fragment_items.end() || --it->second > 0) continue;
+            previous.fragment_items.erase(it);
+            std::erase_if(program.arenas, [&](const auto &owned) { return owned.get() == removed; });
+        }
+        if (!spans.empty()) {
+            previous.fragment_items[arena] = spans.size();
+            std::ranges::move(fresh.arenas, std::back_inserter(program.arenas));
+        }
+        return previous;
     }
 }
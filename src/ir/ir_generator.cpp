@@ -1,14 +1,24 @@
 #include "ir/ir_generator.h"
+#include "ast/fold.h"
 #include "ir/codegen_context.h"
+#include "utils/thread_pool.h"
+
+#include <algorithm>
 
 #include "Module.h"
 
 namespace front::ir {
-    IRGenerator::Result IRGenerator::generate(const ast::ProgramPtr &program) {
+    IRGenerator::Result IRGenerator::generate(const ast::ProgramPtr &program, const size_t jobs) {
         auto module = std::make_unique<Module>("cminusminus");
         CodegenContext ctx(std::move(module));
         if (program) {
-            program->codegen(ctx);
+            ast::fold_constants(*program);
+            if (jobs > 1 && program->functions.size() > 1) {
+                ThreadPool pool{std::min(jobs, program->functions.size())};
+                program->codegen(ctx, &pool);
+            } else {
+                program->codegen(ctx);
+            }
         }
         return {std::move(ctx.module_ptr)};
     }
@@ -33,57 +33,87 @@ namespace front::lexer {
             throw std::runtime_error("DFA has no start state");
         size_t pos = 0;
         while (pos < source_.size()) {
-            int state = dfa->start_state();
-            size_t cursor = pos;
-            int last_accepting_state = -1;
-            size_t last_accepting_pos = pos;
-            if (state >= 0 && dfa->states()[state].token >= 0) {
+            tokens.push_back(scan(pos));
+            advance(tokens.back().lexeme);
+        }
+        optimize();
+        return tokens;
+    }
+
+    bool Lexer::next(Token &out) {
+        if (emitted_eof_) return false;
+        if (dfa->start_state() == -1)
+            throw std::runtime_error("DFA has no start state");
+        while (scan_pos_ < source_.size()) {
+            Token token = scan(scan_pos_);
+            advance(token.lexeme);
+            if (!is_discarded(token)) {
+                out = std::move(token);
+                return true;
+            }
+        }
+        out = {TokenType::EndOfFile, TokenCategory::End, {row, column}, "$"};
+        emitted_eof_ = true;
+        return true;
+    }
+
+    Token Lexer::scan(size_t &pos) const {
+        int state = dfa->start_state();
+        size_t cursor = pos;
+        int last_accepting_state = -1;
+        size_t last_accepting_pos = pos;
+        if (state >= 0 && dfa->states()[state].token >= 0) {
+            last_accepting_state = state;
+            last_accepting_pos = cursor;
+        }
+        while (cursor < source_.size() && state >= 0) {
+            auto c = source_[cursor];
+            int next = dfa->transition(state, c);
+            if (next < 0) break;
+            state = next;
+            cursor++;
+            if (dfa->states()[state].token >= 0) {
                 last_accepting_state = state;
                 last_accepting_pos = cursor;
             }
-            while (cursor < source_.size() && state >= 0) {
-                auto c = source_[cursor];
-                int next = dfa->transition(state, c);
-                if (next < 0) break;
-                state = next;
-                cursor++;
-                if (dfa->states()[state].token >= 0) {
-                    last_accepting_state = state;
-                    last_accepting_pos = cursor;
-                }
-            }
-            Token token;
-            if (last_accepting_state >= 0 && last_accepting_pos > pos) {
-                int accept = dfa->states()[last_accepting_state].token;
-                token = {
-                    std::get<1>(rules[accept]),
-                    std::get<2>(rules[accept]),
-                    {row, column},
-                    source_.substr(pos, last_accepting_pos - pos)
-                };
-                pos = last_accepting_pos;
-            } else {
-                token = {
-                    TokenType::Invalid,
-                    TokenCategory::Invalid,
-                    {row, column},
-                    {1, source_[pos]}
-                };
-                pos++;
+        }
+        Token token;
+        if (last_accepting_state >= 0 && last_accepting_pos > pos) {
+            int accept = dfa->states()[last_accepting_state].token;
+            token = {
+                std::get<1>(rules[accept]),
+                std::get<2>(rules[accept]),
+                {row, column},
+                source_.substr(pos, last_accepting_pos - pos)
+            };
+            pos = last_accepting_pos;
+            if (token.type == TokenType::Identifier || token.type == TokenType::KwMain) {
+                token.symbol = Interner::global().intern(token.lexeme);
             }
-            tokens.push_back(token);
-            advance(token.lexeme);
+        } else {
+            token = {
+                TokenType::Invalid,
+                TokenCategory::Invalid,
+                {row, column},
+                {1, source_[pos]}
+            };
+            pos++;
         }
-        optimize();
-        return tokens;
+        return token;
     }
 
     std::vector<Token> &Lexer::tokenize(const std::string &source) {
-        source_ = source;
+        reset(source);
+        return tokenize();
+    }
+
+    void Lexer::reset(std::string source) {
+        source_ = std::move(source);
         tokens.clear();
         row = 1;
         column = 1;
-        return tokenize();
+        scan_pos_ = 0;
+        emitted_eof_ = false;
     }
 
 
@@ -91,22 +121,25 @@ namespace front::lexer {
         if (tokens.empty()) return;
         std::vector<Token> optimized_tokens;
         optimized_tokens.reserve(tokens.size());
-        for (const auto &token: tokens) {
-#ifdef FILTER_INVALID_TOKENS
-            if (token.category != TokenCategory::Spacer && token.category != TokenCategory::Invalid) {
-                optimized_tokens.push_back(token);
-            }
-#else
-            if (token.category != TokenCategory::Spacer) {
-                optimized_tokens.push_back(token);
+        for (auto &token: tokens) {
+            if (!is_discarded(token)) {
+                optimized_tokens.push_back(std::move(token));
             }
-#endif
         }
         tokens = std::move(optimized_tokens);
         tokens.push_back({TokenType::EndOfFile, TokenCategory::End, {row, column}, "$"});
     }
 
 
+    bool Lexer::is_discarded(const Token &token) {
+#ifdef FILTER_INVALID_TOKENS
+        return token.category == TokenCategory::Spacer || token.category == TokenCategory::Invalid;
+#else
+        return token.category == TokenCategory::Spacer;
+#endif
+    }
+
+
     std::unique_ptr<NFA<Symbol> > Lexer::init_rules() {
         rules = {
             {"( |\t)+", TokenType::Spacer, TokenCategory::Spacer},
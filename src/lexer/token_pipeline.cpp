@@ -0,0 +1,67 @@
+#include "lexer/token_pipeline.h"
+
+#include <utility>
+
+#include "lexer/token_ring.h"
+
+
+namespace front::lexer {
+    TokenPipeline::TokenPipeline(Lexer &lexer) {
+        producer_ = std::thread([this, &lexer] { produce(lexer); });
+        try {
+            next_batch();
+        } catch (...) {
+            producer_.join();
+            throw;
+        }
+    }
+
+    TokenPipeline::~TokenPipeline() {
+        stop_.store(true, std::memory_order_relaxed);
+        producer_.join();
+    }
+
+    void TokenPipeline::advance() {
+        if (offset_ >= batch_.size()) return;
+        last_loc_ = batch_[offset_].loc;
+        ++position_;
+        if (++offset_ == batch_.size()) {
+            next_batch();
+        }
+    }
+
+    void TokenPipeline::produce(Lexer &lexer) {
+        try {
+            TokenRing ring{lexer};
+            while (ring.current() != nullptr && !stop_.load(std::memory_order_relaxed)) {
+                std::vector<Token> batch;
+                batch.reserve(kBatchSize);
+                for (; ring.current() != nullptr && batch.size() < kBatchSize; ring.advance()) {
+                    batch.push_back(*ring.current());
+                }
+                while (!queue_.try_push(batch)) {
+                    if (stop_.load(std::memory_order_relaxed)) return;
+                    std::this_thread::yield();
+                }
+            }
+        } catch (...) {
+            error_ = std::current_exception();
+        }
+        produced_all_.store(true, std::memory_order_release);
+    }
+
+    void TokenPipeline::next_batch() {
+        batch_.clear();
+        offset_ = 0;
+        while (!queue_.try_pop(batch_)) {
+            if (produced_all_.load(std::memory_order_acquire)) {
+                // anything pushed before the flag was set is visible now
+                if (queue_.try_pop(batch_)) break;
+                batch_.clear();
+                if (error_) std::rethrow_exception(error_);
+                return;
+            }
+            std::this_thread::yield();
+        }
+    }
+}
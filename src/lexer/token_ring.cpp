@@ -0,0 +1,51 @@
+#include "lexer/token_ring.h"
+
+#include <algorithm>
+
+
+namespace front::lexer {
+    TokenRing::TokenRing(Lexer &lexer) : lexer_(lexer) {
+        fill();
+        settle();
+    }
+
+    void TokenRing::advance() {
+        if (size_ == 0) return;
+        head_ = (head_ + 1) & (kCapacity - 1);
+        --size_;
+        ++position_;
+        fill();
+        settle();
+    }
+
+    void TokenRing::fill() {
+        while (size_ <= kLookahead && !exhausted_) {
+            Token &next = slot(size_);
+            if (!lexer_.next(next)) {
+                exhausted_ = true;
+                break;
+            }
+            last_loc_ = next.loc;
+            ++size_;
+        }
+    }
+
+    void TokenRing::settle() {
+        if (size_ == 0) return;
+        Token &token = slot(0);
+        if (token.type == TokenType::SepLBrace) {
+            ++brace_depth_;
+        } else if (token.type == TokenType::SepRBrace) {
+            brace_depth_ = std::max(0, brace_depth_ - 1);
+        }
+
+        // same rule as post_process(): `int f (` / `float f (` at file scope
+        if (brace_depth_ == 0 && size_ > kLookahead &&
+            (token.type == TokenType::KwInt || token.type == TokenType::KwFloat) &&
+            (slot(1).type == TokenType::Identifier || slot(1).type == TokenType::KwMain) &&
+            slot(2).type == TokenType::SepLParen) {
+            token.category = TokenCategory::FuncDef;
+            token.type = token.type == TokenType::KwInt ? TokenType::KwIntFunc : TokenType::KwFloatFunc;
+        }
+    }
+}
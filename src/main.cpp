@@ -2,14 +2,25 @@
 #include <fstream>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <vector>
+#include <cstdint>
+#include <cstdlib>
 #include <cstring>
+#include <filesystem>
 #include <optional>
 
+#include "ast/serialize.h"
 #include "lexer/lexer.h"
+#include "lexer/token_pipeline.h"
+#include "lexer/token_ring.h"
 #include "grammar/grammar.h"
+#include "grammar/parser_ll.h"
+#include "grammar/parser_rd.h"
 #include "grammar/parser_slr.h"
 #include "ir/ir_generator.h"
+#include "utils/sha256.h"
+#include "utils/util.h"
 
 using namespace front;
 
@@ -22,6 +33,11 @@ static void print_usage(const char *prog) {
             << "  --dump-tokens     Print lexer output to stdout\n"
             << "  --dump-parse      Print SLR parse trace to stdout\n"
             << "  --gtrace-only     Parse and print trace only (no IR generation)\n"
+            << "  --parser <kind>   slr (default), ll1 or rd; ll1 and rd only check syntax\n"
+            << "  --fused           Parse while lexing, without building a token vector (slr)\n"
+            << "  --pipeline        Like --fused, with the lexer on its own thread (slr)\n"
+            << "  --cache-dir <dir> Reuse the parsed AST of an unchanged source from <dir> (slr)\n"
+            << "  -j <n>            Generate function bodies on <n> threads (same IR)\n"
             << "  -h, --help        Show help\n"
             << "\nSource file:\n"
             << "  <source-file>     Path to source file (default: stdin)\n"
@@ -34,6 +50,8 @@ static std::string read_all_from_stream(std::istream &is) {
     return oss.str();
 }
 
+enum class Backend { SLR, LL1, RD };
+
 struct Options {
     std::string input_path;
     std::string output_file;
@@ -42,6 +60,11 @@ struct Options {
     bool dump_parse{false};
     bool lex_only{false};
     bool gtrace_only{false};
+    Backend backend{Backend::SLR};
+    bool fused{false};
+    bool pipeline{false};
+    std::string cache_dir;
+    size_t jobs{1};
 };
 
 static std::optional<Options> parse_args(int argc, char *argv[]) {
@@ -80,6 +103,51 @@ static std::optional<Options> parse_args(int argc, char *argv[]) {
             opts.output_file.clear();
             continue;
         }
+        if (strcmp(arg, "--parser") == 0) {
+            if (i + 1 >= argc) {
+                std::cerr << "Error: --parser requires slr, ll1 or rd\n";
+                return std::nullopt;
+            }
+            const char *kind = argv[++i];
+            if (strcmp(kind, "slr") == 0) {
+                opts.backend = Backend::SLR;
+            } else if (strcmp(kind, "ll1") == 0) {
+                opts.backend = Backend::LL1;
+            } else if (strcmp(kind, "rd") == 0) {
+                opts.backend = Backend::RD;
+            } else {
+                std::cerr << "Error: unknown parser: " << kind << "\n";
+                return std::nullopt;
+            }
+            continue;
+        }
+        if (strcmp(arg, "--fused") == 0) {
+            opts.fused = true;
+            continue;
+        }
+        if (strcmp(arg, "--pipeline") == 0) {
+            opts.pipeline = true;
+            continue;
+        }
+        if (strcmp(arg, "--cache-dir") == 0) {
+            if (i + 1 >= argc) {
+                std::cerr << "Error: --cache-dir requires a directory\n";
+                return std::nullopt;
+            }
+            opts.cache_dir = argv[++i];
+            continue;
+        }
+        if (strcmp(arg, "-j") == 0) {
+            char *end = nullptr;
+            const unsigned long jobs = i + 1 < argc ? strtoul(argv[i + 1], &end, 10) : 0;
+            if (jobs == 0 || *end != '\0') {
+                std::cerr << "Error: -j requires a positive thread count\n";
+                return std::nullopt;
+            }
+            opts.jobs = jobs;
+            ++i;
+            continue;
+        }
         if (strcmp(arg, "--lex-only") == 0) {
             opts.lex_only = true;
             opts.dump_tokens = true;
@@ -103,6 +171,79 @@ static std::optional<Options> parse_args(int argc, char *argv[]) {
     return opts;
 }
 
+// the LL(1) backends recognize the input without building an AST
+static bool check_syntax(const Backend backend, const std::vector<Token> &tokens, const bool dump_parse) {
+    grammar::StreamTraceSink trace{std::cout};
+    if (backend == Backend::LL1) {
+        const grammar::LL1Parser parser{};
+        grammar::NullTraceSink none;
+        return dump_parse ? parser.parse(tokens, trace) : parser.parse(tokens, none);
+    }
+    const grammar::RDParser parser{};
+    return dump_parse ? parser.parse(tokens, trace) : parser.parse(tokens);
+}
+
+// identifies a source in the AST cache: its SHA-256 and its length
+struct CacheKey {
+    Sha256Digest digest{};
+    uint64_t length{0};
+};
+
+static CacheKey cache_key(const std::string &source) {
+    return {sha256(source), source.size()};
+}
+
+// the cached AST of a source, named by its digest. An entry repeats the key
+// (digest, then length as u64) ahead of the AST blob and is used only when
+// both match, so no copy of the source is kept.
+static std::filesystem::path cache_entry(const std::string &cache_dir, const CacheKey &key) {
+    return std::filesystem::path{cache_dir} / (to_hex(key.digest) + ".ast");
+}
+
+// a missing, stale or damaged entry is only a miss
+static ast::ProgramPtr load_cached(const std::filesystem::path &entry, const CacheKey &key) {
+    std::ifstream ifs(entry, std::ios::binary);
+    if (!ifs) {
+        return nullptr;
+    }
+    const std::string bytes = read_all_from_stream(ifs);
+    constexpr size_t header = sizeof(key.digest) + sizeof(key.length);
+    if (bytes.size() < header) {
+        return nullptr;
+    }
+    CacheKey stored;
+    std::memcpy(stored.digest.data(), bytes.data(), sizeof(stored.digest));
+    std::memcpy(&stored.length, bytes.data() + sizeof(stored.digest), sizeof(stored.length));
+    if (stored.digest != key.digest || stored.length != key.length) {
+        return nullptr;
+    }
+    try {
+        return ast::deserialize(std::string_view{bytes}.substr(header));
+    } catch (const std::runtime_error &) {
+        return nullptr;
+    }
+}
+
+// failing to fill the cache never fails the compilation
+static void store_cached(const std::filesystem::path &entry, const CacheKey &key, const ast::Program &program) {
+    std::error_code ec;
+    std::filesystem::create_directories(entry.parent_path(), ec);
+    // written aside and renamed, so readers never see a partial entry
+    auto partial = entry;
+    partial += ".tmp";
+    {
+        std::ofstream ofs(partial, std::ios::binary);
+        ofs.write(reinterpret_cast<const char *>(key.digest.data()), sizeof(key.digest));
+        ofs.write(reinterpret_cast<const char *>(&key.length), sizeof(key.length));
+        ofs << ast::serialize(program);
+        if (!ofs) {
+            std::cerr << "Warning: cannot write cache entry: " << partial.string() << std::endl;
+            return;
+        }
+    }
+    std::filesystem::rename(partial, entry, ec);
+}
+
 int main(int argc, char *argv[]) {
     auto opts_opt = parse_args(argc, argv);
     if (!opts_opt) {
@@ -115,7 +256,12 @@ int main(int argc, char *argv[]) {
         dump_tokens,
         dump_parse,
         lex_only,
-        gtrace_only] = *opts_opt;
+        gtrace_only,
+        backend,
+        fused,
+        pipeline,
+        cache_dir,
+        jobs] = *opts_opt;
 
     try {
         std::string source_code;
@@ -130,34 +276,83 @@ int main(int argc, char *argv[]) {
             source_code = read_all_from_stream(ifs);
         }
 
-        lexer::Lexer lexer{std::move(source_code)};
-        const auto &tokens = lexer.tokenize();
-        if (dump_tokens) {
-            lexer::print_tokens(std::cout, tokens);
-        }
-        if (lex_only) {
-            return 0;
+        // only a plain SLR compile skips the frontend; the dumps need it to run
+        const bool use_cache = !cache_dir.empty() && backend == Backend::SLR && !dump_tokens && !dump_parse;
+        CacheKey key;
+        std::filesystem::path entry;
+        ast::ProgramPtr program;
+        if (use_cache) {
+            key = cache_key(source_code);
+            entry = cache_entry(cache_dir, key);
+            program = load_cached(entry, key);
         }
 
-        const auto &processed = post_process(tokens);
-        grammar::Grammar grammar{};
-        const grammar::SLRParser parser{std::move(grammar)};
-        const auto &[root, steps, success] = parser.parse(processed);
+        if (!program) {
+            lexer::Lexer lexer{std::move(source_code)};
+            grammar::ParseResult parsed;
 
-        if (dump_parse) {
-            grammar::print_parse_steps(std::cout, steps);
-        }
+            const auto parse_from = [&](auto &source) {
+                const auto &parser = grammar::SLRParser::shared();
+                if (dump_parse) {
+                    grammar::StreamTraceSink trace{std::cout};
+                    parsed = parser.parse_source(source, trace);
+                } else {
+                    parsed = parser.parse_source(source);
+                }
+            };
 
-        if (!success) {
-            std::cerr << "Parse error\n";
-            return 1;
-        }
+            if (pipeline && backend == Backend::SLR && !dump_tokens) {
+                // the lexer runs ahead on a second thread
+                lexer::TokenPipeline tokens{lexer};
+                parse_from(tokens);
+            } else if (fused && backend == Backend::SLR && !dump_tokens) {
+                // the lexer runs on demand from inside the parse loop
+                lexer::TokenRing ring{lexer};
+                parse_from(ring);
+            } else {
+                const auto &tokens = lexer.tokenize();
+                if (dump_tokens) {
+                    lexer::print_tokens(std::cout, tokens);
+                }
+                if (lex_only) {
+                    return 0;
+                }
+
+                const auto &processed = post_process(tokens);
+                if (backend != Backend::SLR) {
+                    if (!check_syntax(backend, processed, dump_parse)) {
+                        std::cerr << "Parse error\n";
+                        return 1;
+                    }
+                    return 0;
+                }
 
-        if (gtrace_only) {
-            return 0;
+                const auto &parser = grammar::SLRParser::shared();
+                if (dump_parse) {
+                    grammar::StreamTraceSink trace{std::cout};
+                    parsed = parser.parse(processed, trace);
+                } else {
+                    parsed = parser.parse(processed);
+                }
+            }
+            const auto &[root, success, diagnostics] = parsed;
+
+            if (!success) {
+                grammar::print_diagnostics(std::cerr, diagnostics);
+                std::cerr << "Parse error\n";
+                return 1;
+            }
+
+            if (gtrace_only) {
+                return 0;
+            }
+            program = std::move(parsed.program);
+            if (use_cache && program) {
+                store_cached(entry, key, *program);
+            }
         }
 
-        auto [module] = ir::IRGenerator::generate(root);
+        auto [module] = ir::IRGenerator::generate(program, jobs);
         std::string ir = module->print();
 
         if (!output_file.empty()) {
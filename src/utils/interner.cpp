@@ -0,0 +1,50 @@
+#include "utils/interner.h"
+
+#include <mutex>
+#include <stdexcept>
+
+namespace front {
+    SymbolId Interner::intern(const std::string_view name) {
+        {
+            std::shared_lock lock(mutex_);
+            if (const auto it = ids_.find(name); it != ids_.end()) {
+                return it->second;
+            }
+        }
+        std::unique_lock lock(mutex_);
+        // another thread may have added it between the two locks
+        if (const auto it = ids_.find(name); it != ids_.end()) {
+            return it->second;
+        }
+        if (names_.size() >= kNoSymbol) {
+            throw std::length_error("symbol table exceeds 32-bit ids");
+        }
+        const std::string_view stored = strings_.emplace_back(name);
+        const auto id = static_cast<SymbolId>(names_.size());
+        names_.push_back(stored);
+        ids_.emplace(stored, id);
+        return id;
+    }
+
+    std::string_view Interner::name(const SymbolId id) const {
+        std::shared_lock lock(mutex_);
+        return names_.at(id);
+    }
+
+    size_t Interner::size() const {
+        std::shared_lock lock(mutex_);
+        return names_.size();
+    }
+
+    void Interner::reset() {
+        std::unique_lock lock(mutex_);
+        ids_.clear();
+        names_.clear();
+        strings_.clear();
+    }
+
+    Interner &Interner::global() {
+        static Interner interner;
+        return interner;
+    }
+}
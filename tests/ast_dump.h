@@ -0,0 +1,16 @@
+//
+// Shared by the tests that compare parse trees through their printed form.
+//
+#pragma once
+#include <sstream>
+#include <string>
+
+#include "ast/ast.h"
+
+// the tree as print_ast writes it; "<none>" when there is no tree
+inline std::string dump(const front::ast::ProgramPtr &program) {
+    if (!program) return "<none>";
+    std::ostringstream os;
+    front::ast::print_ast(program, os);
+    return os.str();
+}
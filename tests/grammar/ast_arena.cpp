@@ -0,0 +1,87 @@
+//
+// A parse builds its tree in one arena owned by the program: names are interned
+// and outlive the tokens, and an incremental reparse keeps the arenas of live
+// items alive, dropping a reparsed fragment's arena with its last item.
+//
+#include <cassert>
+#include <string>
+#include <vector>
+
+#include "ast/ast.h"
+#include "grammar/parser_slr.h"
+#include "lexer/lexer.h"
+#include "token.h"
+
+using namespace front;
+using namespace front::grammar;
+
+static std::vector<Token> lex(const std::string &src) {
+    lexer::Lexer lexer{src};
+    return post_process(lexer.tokenize());
+}
+
+static const ast::CallExpr &returned_call(const ast::FuncDef &func) {
+    const auto &item = func.body->items.back();
+    const auto *ret = ast::node_cast<ast::ReturnStmt>(item.stmt.get());
+    assert(ret != nullptr);
+    const auto *call = ast::node_cast<ast::CallExpr>(ret->value.get());
+    assert(call != nullptr);
+    return *call;
+}
+
+int main() {
+    const auto &parser = SLRParser::shared();
+
+    ParseResult result;
+    {
+        // the tokens die before the tree is inspected
+        const auto tokens = lex("int add(int a, int b) { return a + b; }\n"
+                                "int main() { return add(1, 2); }\n");
+        result = parser.parse(tokens);
+    }
+    assert(result.success);
+    const auto &program = *result.program;
+    assert(program.arenas.size() == 1);
+    assert(program.arenas.front()->objects() > 0);
+
+    assert(program.functions.size() == 2);
+    const auto &add = *program.functions[0];
+    assert(symbol_name(add.name) == "add");
+    assert(add.params.size() == 2);
+    assert(symbol_name(add.params[0].name) == "a" && symbol_name(add.params[1].name) == "b");
+
+    const auto &call = returned_call(*program.functions[1]);
+    assert(call.callee == Interner::global().intern("add"));
+    assert(call.args.size() == 2);
+
+    // recognizer-only grammars never touch an arena
+    Grammar plain{"S'", {{"S'", {NT("S")}}, {"S", {T("Ident")}}}};
+    plain.init_token_map();
+    const SLRParser recognizer{std::move(plain)};
+    const auto bare = recognizer.parse(lex("x"));
+    assert(bare.success && bare.program == nullptr);
+
+    // a reparse splices nodes from the old arena and the fragment's arena
+    const auto before = lex("int g = 1;\nint f() { return g; }\nint main() { return f(); }\n");
+    auto edited = before;
+    size_t pos = 0;
+    while (edited[pos].type != TokenType::LiteralInt) ++pos;
+    edited[pos].lexeme = "7";
+
+    auto parsed = parser.parse_incremental(before);
+    parsed = parser.reparse(std::move(parsed), edited, TokenEdit{pos, pos + 1, pos + 1});
+    assert(parsed.result.success);
+    const auto &spliced = *parsed.result.program;
+    assert(spliced.arenas.size() == 2);
+    assert(spliced.globals.size() == 1 && spliced.functions.size() == 2);
+    assert(symbol_name(spliced.functions[0]->name) == "f" && symbol_name(spliced.functions[1]->name) == "main");
+
+    // editing the same item again drops the fragment arena it replaces
+    const auto *first_fragment = spliced.arenas.back().get();
+    edited[pos].lexeme = "8";
+    parsed = parser.reparse(std::move(parsed), edited, TokenEdit{pos, pos + 1, pos + 1});
+    assert(parsed.result.success);
+    assert(parsed.result.program->arenas.size() == 2);
+    assert(parsed.result.program->arenas.back().get() != first_fragment);
+    return 0;
+}
@@ -0,0 +1,87 @@
+//
+// A serialized program must load back into the same tree, and a damaged
+// blob must be rejected rather than half-loaded.
+//
+#include <cassert>
+#include <stdexcept>
+#include <string>
+
+#include "ast/ast.h"
+#include "ast/serialize.h"
+#include "grammar/parser_slr.h"
+#include "ir/ir_generator.h"
+#include "lexer/lexer.h"
+#include "token.h"
+#include "utils/interner.h"
+
+#include "ast_dump.h"
+
+using namespace front;
+
+static ast::ProgramPtr parse(const std::string &src) {
+    lexer::Lexer lexer{src};
+    auto result = grammar::SLRParser::shared().parse(post_process(lexer.tokenize()));
+    assert(result.success);
+    return std::move(result.program);
+}
+
+static bool rejects(const std::string &blob) {
+    try {
+        ast::deserialize(blob);
+    } catch (const std::runtime_error &) {
+        return true;
+    }
+    return false;
+}
+
+int main() {
+    const auto program = parse(
+        "const int k = 3, m = -3;\n"
+        "float scale = 1.5;\n"
+        "int g;\n"
+        "int add(int a, int b) { return a + b; }\n"
+        "void touch() { ; return; }\n"
+        "int main() {\n"
+        "    int x = add(k, 2) * 4, y;\n"
+        "    y = -x + x % 2;\n"
+        "    if (x < 0 || x % 2 == 0) y = +1;\n"
+        "    { touch(); }\n"
+        "    if (x > y) x = x - 1; else { y = y + 1; }\n"
+        "    return x;\n"
+        "}\n");
+    const auto blob = ast::serialize(*program);
+
+    const auto loaded = ast::deserialize(blob);
+    assert(dump(loaded) == dump(program));
+    assert(ast::serialize(*loaded) == blob);
+    const auto original_ir = ir::IRGenerator::generate(program).module->print();
+    assert(ir::IRGenerator::generate(loaded).module->print() == original_ir);
+
+    // damage: truncation, trailing bytes, another version, a bad child link
+    assert(rejects(blob.substr(0, blob.size() - 1)));
+    assert(rejects(blob + '\0'));
+    auto version = blob;
+    version[4] ^= 1;
+    assert(rejects(version));
+    auto link = blob;
+    link[link.size() - 1] ^= 0x7f;
+    assert(rejects(link));
+
+    // a rejected blob interns none of its names
+    auto renamed = link;
+    renamed.replace(renamed.find("scale"), 5, "qz9wv");
+    const size_t interned = Interner::global().size();
+    assert(rejects(renamed));
+    assert(Interner::global().size() == interned);
+
+    // loading does not recurse, so depth is bounded by memory only
+    std::string deep = "int main() { return 0";
+    for (int i = 0; i < 50000; ++i) {
+        deep += " + 1";
+    }
+    deep += "; }\n";
+    const auto deep_program = parse(deep);
+    const auto deep_blob = ast::serialize(*deep_program);
+    assert(ast::serialize(*ast::deserialize(deep_blob)) == deep_blob);
+    return 0;
+}
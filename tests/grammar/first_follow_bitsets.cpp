@@ -0,0 +1,158 @@
+//
+// FIRST and FOLLOW are computed on terminal bitsets with a worklist; they
+// must agree with the plain fixpoint over symbol sets that the bitsets
+// replaced, on the real grammars and on chains of nullable nonterminals.
+//
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "grammar/grammar.h"
+
+using namespace front::grammar;
+
+namespace {
+    using SymbolSet = std::unordered_set<Symbol, SymbolHash>;
+    using SetMap = std::unordered_map<Symbol, SymbolSet, SymbolHash>;
+
+    // the set-based fixpoints, as Grammar computed them before the bitsets
+    SetMap reference_first(const Grammar &g) {
+        SetMap first;
+        for (const auto &terminal: g.terminals_) {
+            first[T(terminal)].insert(T(terminal));
+        }
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (const auto &nt: g.non_terminals) {
+                auto &into = first[NT(nt)];
+                const auto it = g.production_map.find(nt);
+                if (it == g.production_map.end()) continue;
+                for (const size_t i: it->second) {
+                    const auto &body = g.productions[i].body;
+                    if (body.size() == 1 && body[0].is_epsilon()) {
+                        changed |= into.insert(Symbol::Epsilon()).second;
+                        continue;
+                    }
+                    bool all_nullable = true;
+                    for (const auto &y: body) {
+                        if (y.is_epsilon()) break;
+                        const auto firsts = first[y];
+                        for (const auto &sym: firsts) {
+                            if (!sym.is_epsilon()) changed |= into.insert(sym).second;
+                        }
+                        if (!firsts.contains(Symbol::Epsilon())) {
+                            all_nullable = false;
+                            break;
+                        }
+                    }
+                    if (all_nullable) changed |= into.insert(Symbol::Epsilon()).second;
+                }
+            }
+        }
+        return first;
+    }
+
+    SetMap reference_follow(const Grammar &g, SetMap &first) {
+        SetMap follow;
+        follow[g.start_symbol_].insert(Symbol::End());
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (const auto &prod: g.productions) {
+                const auto &body = prod.body;
+                for (size_t i = 0; i < body.size(); ++i) {
+                    if (!body[i].is_non_terminal()) continue;
+                    bool all_nullable = true;
+                    for (size_t j = i + 1; j < body.size(); ++j) {
+                        if (body[j].is_epsilon()) continue;
+                        const auto &firsts = first[body[j]];
+                        for (const auto &sym: firsts) {
+                            if (!sym.is_epsilon()) changed |= follow[body[i]].insert(sym).second;
+                        }
+                        if (!firsts.contains(Symbol::Epsilon())) {
+                            all_nullable = false;
+                            break;
+                        }
+                    }
+                    if (all_nullable) {
+                        const auto head_follow = follow[prod.head];
+                        for (const auto &sym: head_follow) {
+                            changed |= follow[body[i]].insert(sym).second;
+                        }
+                    }
+                }
+            }
+        }
+        return follow;
+    }
+
+    // the nonterminals' sets of `actual` match `expected`, empty or absent alike
+    bool same_sets(const Grammar &g, const SetMap &actual, const SetMap &expected) {
+        for (const auto &nt: g.non_terminals) {
+            const auto a = actual.find(NT(nt));
+            const auto e = expected.find(NT(nt));
+            const SymbolSet none;
+            if ((a == actual.end() ? none : a->second) != (e == expected.end() ? none : e->second)) {
+                std::cerr << "sets of " << nt << " differ" << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void check(const Grammar &g) {
+        auto first = reference_first(g);
+        const auto follow = reference_follow(g, first);
+        assert(same_sets(g, g.first_set_, first));
+        assert(same_sets(g, g.follow_set_, follow));
+
+        // the memoized suffix FIRSTs agree with the symbol-set ones
+        for (const auto &prod: g.productions) {
+            if (prod.id == -1u || (prod.body.size() == 1 && prod.body[0].is_epsilon())) continue;
+            const auto &suffix = g.first_of_suffix(prod.id, 0);
+            const auto expected = g.first_of_sequence(prod.body);
+            assert(suffix.nullable == expected.contains(Symbol::Epsilon()));
+            assert(suffix.first.size() + suffix.nullable == expected.size());
+            suffix.first.for_each([&](const size_t t) {
+                assert(expected.contains(g.terminal_symbols_[t]));
+            });
+        }
+    }
+}
+
+int main() {
+    check(Grammar{});
+    // the LL(1) normalization adds ε-productions, so this one has nullables
+    const Grammar ll1{true};
+    check(ll1);
+    assert(std::ranges::any_of(ll1.first_set_, [](const auto &entry) {
+        return entry.second.contains(Symbol::Epsilon());
+    }));
+
+    // S -> A B c | B; A -> B C | a; B -> C | ε; C -> D; D -> ε | d:
+    // nullability has to travel up three levels before it reaches S
+    const Symbol eps = Symbol::Epsilon();
+    Grammar chains{
+        "S",
+        {
+            {"S", {NT("A"), NT("B"), T("c")}},
+            {"S", {NT("B")}},
+            {"A", {NT("B"), NT("C")}},
+            {"A", {T("a")}},
+            {"B", {NT("C")}},
+            {"B", {eps}},
+            {"C", {NT("D")}},
+            {"D", {eps}},
+            {"D", {T("d")}},
+        }
+    };
+    check(chains);
+    assert(chains.first_set_.at(NT("S")).contains(eps));
+    assert(chains.follow_set_.at(NT("D")).contains(T("c")));
+    assert(chains.follow_set_.at(NT("D")).contains(Symbol::End()));
+    return 0;
+}
@@ -0,0 +1,68 @@
+//
+// The flat encoding must describe the same tree as the pointer AST: it prints
+// identically, and converting it back gives a program with identical IR.
+//
+#include <cassert>
+#include <sstream>
+#include <string>
+
+#include "ast/ast.h"
+#include "ast/flat_ast.h"
+#include "grammar/parser_slr.h"
+#include "ir/ir_generator.h"
+#include "lexer/lexer.h"
+#include "token.h"
+
+#include "ast_dump.h"
+
+using namespace front;
+
+static std::string dump(const ast::FlatAst &flat) {
+    std::ostringstream os;
+    ast::print_ast(flat, os);
+    return os.str();
+}
+
+int main() {
+    const std::string src =
+            "const int k = 3, m = -3;\n"
+            "float scale = 1.5;\n"
+            "int g;\n"
+            "int add(int a, int b) { return a + b; }\n"
+            "void touch() { ; return; }\n"
+            "int main() {\n"
+            "    int x = add(k, 2) * 4, y;\n"
+            "    y = -x + x % 2;\n"
+            "    if (x < 0 || x % 2 == 0) y = +1;\n"
+            "    { touch(); }\n"
+            "    if (x > y) x = x - 1; else { y = y + 1; }\n"
+            "    if (x) ;\n"
+            "    return x;\n"
+            "}\n";
+    lexer::Lexer lexer{src};
+    const auto result = grammar::SLRParser::shared().parse(post_process(lexer.tokenize()));
+    assert(result.success);
+
+    const auto flat = ast::flatten(*result.program);
+    assert(flat.globals.size() == 3 && flat.functions.size() == 3);
+    assert(flat.kinds.size() == flat.payloads.size() && flat.kinds.size() == flat.child_count.size());
+    // children precede their parents
+    for (ast::NodeId id = 0; id < flat.size(); ++id) {
+        for (const ast::NodeId child: flat.children_of(id)) {
+            assert(child < id);
+        }
+    }
+    assert(flat.kinds[flat.functions.back()] == ast::FlatKind::Func);
+    assert(flat.name(flat.functions.back()) == "main");
+
+    const auto expected = dump(result.program);
+    assert(dump(flat) == expected);
+
+    const auto rebuilt = ast::to_program(flat);
+    assert(dump(rebuilt) == expected);
+
+    const auto original_ir = ir::IRGenerator::generate(result.program).module->print();
+    const auto rebuilt_ir = ir::IRGenerator::generate(rebuilt).module->print();
+    assert(original_ir == rebuilt_ir);
+    return 0;
+}
@@ -0,0 +1,75 @@
+//
+// The generated recursive-descent parser must accept and reject exactly what
+// the table-driven LL1Parser does, with an identical trace.
+//
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "grammar/parser.h"
+#include "grammar/parser_ll.h"
+#include "grammar/parser_rd.h"
+#include "lexer/lexer.h"
+#include "token.h"
+
+using namespace front;
+using namespace front::grammar;
+
+static bool same_trace(const std::vector<ParseStep> &lhs, const std::vector<ParseStep> &rhs) {
+    if (lhs.size() != rhs.size()) return false;
+    for (size_t i = 0; i < lhs.size(); ++i) {
+        if (lhs[i].top.name != rhs[i].top.name ||
+            lhs[i].lookahead.name != rhs[i].lookahead.name ||
+            lhs[i].action != rhs[i].action) {
+            std::cerr << "step " << i + 1 << " differs: "
+                    << lhs[i].top << '#' << lhs[i].lookahead << " vs "
+                    << rhs[i].top << '#' << rhs[i].lookahead << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+static void check(const LL1Parser &ll1, const RDParser &rd, const std::string &src, const bool accepted) {
+    lexer::Lexer lexer{src};
+    const auto tokens = post_process(lexer.tokenize());
+
+    VectorTraceSink ll1_trace;
+    VectorTraceSink rd_trace;
+    assert(ll1.parse(tokens, ll1_trace) == accepted);
+    assert(rd.parse(tokens, rd_trace) == accepted);
+    assert(same_trace(ll1_trace.steps, rd_trace.steps));
+}
+
+int main() {
+    const LL1Parser ll1{};
+    const RDParser rd{};
+
+    check(ll1, rd, R"(
+        int g = 1, h = 2;
+        const float pi = 3.14;
+        int add(int a, int b) {
+            return a + b;
+        }
+        int main() {
+            int a = 1;
+            float f = 2.5;
+            if (a < 10) {
+                if (a == 3 || a > 7 && a != 8) a = a + 2;
+                else a = a + 1;
+            }
+            return add(a, g) * (h - -2) % 5;
+        }
+    )", true);
+
+    check(ll1, rd, R"(
+        int main() {
+            int a = 1
+            return a;
+        }
+    )", false);
+
+    check(ll1, rd, "int main() { return 0; } }", false);
+    return 0;
+}
@@ -0,0 +1,156 @@
+//
+// Incremental reparsing must produce the same tree as a full parse while
+// reusing the top-level items the edit did not touch.
+//
+#include <bit>
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "ast/ast.h"
+#include "grammar/grammar.h"
+#include "grammar/parser_slr.h"
+#include "lexer/lexer.h"
+#include "token.h"
+
+#include "ast_dump.h"
+
+using namespace front;
+using namespace front::grammar;
+
+static std::vector<Token> lex(const std::string &src) {
+    lexer::Lexer lexer{src};
+    return post_process(lexer.tokenize());
+}
+
+// the smallest token range that differs between the two streams
+static TokenEdit diff_tokens(const std::vector<Token> &before, const std::vector<Token> &after) {
+    const auto same = [](const Token &l, const Token &r) { return l == r && l.lexeme == r.lexeme; };
+    size_t prefix = 0;
+    while (prefix < before.size() && prefix < after.size() && same(before[prefix], after[prefix])) ++prefix;
+    size_t suffix = 0;
+    while (suffix < before.size() - prefix && suffix < after.size() - prefix &&
+           same(before[before.size() - 1 - suffix], after[after.size() - 1 - suffix])) {
+        ++suffix;
+    }
+    return {prefix, before.size() - suffix, after.size() - suffix};
+}
+
+int main() {
+    const SLRParser parser{Grammar{}};
+
+    const std::string v1 = R"(
+        int g = 1;
+        int f1(int a) { return a + g; }
+        int f2(int b) { return b * 2; }
+        int main() { return f1(1) + f2(2); }
+    )";
+    const auto tokens1 = lex(v1);
+    auto parsed = parser.parse_incremental(tokens1);
+    assert(parsed.result.success);
+    assert(parsed.items.size() == 4);
+
+    // change a literal inside f2: only f2 is reparsed
+    const std::string v2 = R"(
+        int g = 1;
+        int f1(int a) { return a + g; }
+        int f2(int b) { return b * 3; }
+        int main() { return f1(1) + f2(2); }
+    )";
+    const auto tokens2 = lex(v2);
+    const auto *f1 = parsed.result.program->functions[0].get();
+    const auto *f2 = parsed.result.program->functions[1].get();
+    const auto *global = parsed.result.program->globals[0].get();
+    parsed = parser.reparse(std::move(parsed), tokens2, diff_tokens(tokens1, tokens2));
+    assert(parsed.result.success);
+    assert(parsed.result.program->functions[0].get() == f1);
+    assert(parsed.result.program->functions[1].get() != f2);
+    assert(parsed.result.program->globals[0].get() == global);
+    assert(dump(parsed.result.program) == dump(parser.parse(tokens2).program));
+
+    // insert a function and a global, shifting everything after them
+    const std::string v3 = R"(
+        int g = 1;
+        int f1(int a) { return a + g; }
+        int h = 5;
+        int f3() { return h; }
+        int f2(int b) { return b * 3; }
+        int main() { return f1(1) + f2(2); }
+    )";
+    const auto tokens3 = lex(v3);
+    parsed = parser.reparse(std::move(parsed), tokens3, diff_tokens(tokens2, tokens3));
+    assert(parsed.result.success);
+    assert(parsed.items.size() == 6);
+    assert(dump(parsed.result.program) == dump(parser.parse(tokens3).program));
+
+    // a broken edit reports errors, and the next good edit recovers
+    const std::string v4 = R"(
+        int g = 1;
+        int f1(int a) { return a + ; }
+        int h = 5;
+        int f3() { return h; }
+        int f2(int b) { return b * 3; }
+        int main() { return f1(1) + f2(2); }
+    )";
+    const auto tokens4 = lex(v4);
+    parsed = parser.reparse(std::move(parsed), tokens4, diff_tokens(tokens3, tokens4));
+    assert(!parsed.result.success);
+    assert(parsed.result.diagnostics.size() == 1);
+
+    parsed = parser.reparse(std::move(parsed), tokens3, diff_tokens(tokens4, tokens3));
+    assert(parsed.result.success);
+    assert(dump(parsed.result.program) == dump(parser.parse(tokens3).program));
+
+    // delete the first global
+    const std::string v5 = R"(
+        int f1(int a) { return a + g; }
+        int h = 5;
+        int f3() { return h; }
+        int f2(int b) { return b * 3; }
+        int main() { return f1(1) + f2(2); }
+    )";
+    const auto tokens5 = lex(v5);
+    parsed = parser.reparse(std::move(parsed), tokens5, diff_tokens(tokens3, tokens5));
+    assert(parsed.result.success);
+    assert(parsed.items.size() == 5);
+    assert(dump(parsed.result.program) == dump(parser.parse(tokens5).program));
+
+    // a large file: inserting a global near the start moves every later
+    // item, yet the reparse only rewrites tree nodes on a few root paths
+    constexpr size_t kPairs = 1000;
+    std::string large;
+    for (size_t i = 0; i < kPairs; ++i) {
+        large.append("int g").append(std::to_string(i)).append(" = 1;\n");
+        large.append("int f").append(std::to_string(i)).append("(int a) { return a + 2; }\n");
+    }
+    const auto large_tokens = lex(large);
+    parsed = parser.parse_incremental(large_tokens);
+    assert(parsed.result.success);
+    assert(parsed.items.size() == 2 * kPairs);
+    const auto *last_function = parsed.result.program->functions.back().get();
+
+    std::string inserted = large;
+    inserted.insert(inserted.find('\n') + 1, "int h = 5;\n");
+    const auto inserted_tokens = lex(inserted);
+    parsed = parser.reparse(std::move(parsed), inserted_tokens, diff_tokens(large_tokens, inserted_tokens));
+    assert(parsed.result.success);
+    assert(parsed.items.size() == 2 * kPairs + 1);
+    const size_t touched = parsed.items.last_touched();
+    std::cout << "nodes touched: " << touched << " of " << parsed.items.size() << std::endl;
+    assert(touched <= 16 * std::bit_width(parsed.items.size()));
+    assert(parsed.result.program->functions.back().get() == last_function);
+
+    // the untouched spans still read back where a full parse puts them
+    const auto spans = parsed.items.spans();
+    const auto expected = parser.parse_incremental(inserted_tokens).items.spans();
+    assert(spans.size() == expected.size());
+    for (size_t i = 0; i < spans.size(); ++i) {
+        assert(spans[i].begin == expected[i].begin && spans[i].end == expected[i].end);
+        assert(spans[i].function == expected[i].function);
+        assert(spans[i].globals_before == expected[i].globals_before);
+        assert(spans[i].functions_before == expected[i].functions_before);
+    }
+    assert(dump(parsed.result.program) == dump(parser.parse(inserted_tokens).program));
+    return 0;
+}
@@ -0,0 +1,78 @@
+//
+// Building the LR(0) collection on a thread pool must number states exactly
+// like the serial build.
+//
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "grammar/grammar.h"
+#include "grammar/parser_slr.h"
+
+using namespace front::grammar;
+
+// L0 -> L0 op0 L1 | L1, ..., Ln -> ( L0 ) | id
+static Grammar make_precedence_grammar(const int levels) {
+    std::vector<std::vector<Symbol> > bodies;
+    std::vector<std::string> heads;
+    // appended rather than "L" + to_string(i): GCC 12 warns -Wrestrict on that
+    const auto name = [](const char *prefix, const int i) {
+        std::string out{prefix};
+        out.append(std::to_string(i));
+        return out;
+    };
+    const auto level = [&](const int i) { return name("L", i); };
+
+    heads.emplace_back("S");
+    bodies.push_back({NT(level(0))});
+    for (int i = 0; i < levels; ++i) {
+        heads.push_back(level(i));
+        bodies.push_back({NT(level(i)), T(name("op", i)), NT(level(i + 1))});
+        heads.push_back(level(i));
+        bodies.push_back({NT(level(i + 1))});
+    }
+    heads.push_back(level(levels));
+    bodies.push_back({T("("), NT(level(0)), T(")")});
+    heads.push_back(level(levels));
+    bodies.push_back({T("id")});
+
+    std::vector<Grammar::RawProduction> productions;
+    for (size_t i = 0; i < heads.size(); ++i) {
+        productions.emplace_back(heads[i], bodies[i]);
+    }
+    return Grammar{"S", productions};
+}
+
+static std::string sorted_tables(const SLRParser &parser) {
+    std::ostringstream os;
+    parser.print_go_function(os);
+    parser.print_action_table(os);
+
+    std::vector<std::string> lines;
+    std::istringstream is(os.str());
+    for (std::string line; std::getline(is, line);) {
+        lines.push_back(line);
+    }
+    std::ranges::sort(lines);
+
+    std::string joined;
+    for (const auto &line: lines) {
+        joined += line + '\n';
+    }
+    return joined;
+}
+
+int main() {
+    const SLRParser serial{make_precedence_grammar(60), 1};
+    const SLRParser parallel{make_precedence_grammar(60), 4};
+
+    const auto serial_tables = sorted_tables(serial);
+    assert(!serial_tables.empty());
+    assert(serial_tables == sorted_tables(parallel));
+
+    std::cout << "tables match" << std::endl;
+    return 0;
+}
@@ -0,0 +1,54 @@
+//
+// parse_batch on the shared parser must give the same results, in order, as
+// parsing each input on its own.
+//
+#include <cassert>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ast/ast.h"
+#include "grammar/parser_slr.h"
+#include "lexer/lexer.h"
+#include "token.h"
+
+#include "ast_dump.h"
+
+using namespace front;
+using namespace front::grammar;
+
+int main() {
+    std::vector<std::vector<Token> > inputs;
+    for (int i = 0; i < 16; ++i) {
+        std::string src = "int g = " + std::to_string(i) + ";\n";
+        for (int f = 0; f <= i; ++f) {
+            src += "int f" + std::to_string(f) + "(int a) { return a * " + std::to_string(f) + " + g; }\n";
+        }
+        // every fifth input is broken
+        src += i % 5 == 4 ? "int main() { return ; ; }\n" : "int main() { return f0(1); }\n";
+        src += i % 5 == 4 ? "int x = ;\n" : "";
+        lexer::Lexer lexer{src};
+        inputs.push_back(post_process(lexer.tokenize()));
+    }
+
+    // the shared instance is built once, even when first requested concurrently
+    const SLRParser *seen[4]{};
+    std::vector<std::thread> threads;
+    for (auto &slot: seen) {
+        threads.emplace_back([&slot] { slot = &SLRParser::shared(); });
+    }
+    for (auto &t: threads) t.join();
+    for (const auto *p: seen) assert(p == seen[0]);
+
+    const auto &parser = SLRParser::shared();
+    const auto results = parser.parse_batch(inputs, 4);
+    assert(results.size() == inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        const auto expected = parser.parse(inputs[i]);
+        assert(results[i].success == expected.success);
+        assert(results[i].success == (i % 5 != 4));
+        assert(results[i].diagnostics.size() == expected.diagnostics.size());
+        assert(dump(results[i].program) == dump(expected.program));
+    }
+    return 0;
+}
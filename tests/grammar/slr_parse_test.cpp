@@ -40,7 +40,8 @@ return ;
     grammar::SLRParser parser{std::move(grammar)};
 
     // 3. 运行 SLR 解析
-    auto res = parser.parse(tokens);
+    grammar::VectorTraceSink trace;
+    auto res = parser.parse(tokens, trace);
 
 
     ast::print_ast(res.program, std::cout);
@@ -48,7 +49,7 @@ return ;
     auto a = ir::IRGenerator::generate(res.program);
 
 
-    auto steps = res.actions;
+    const auto &steps = trace.steps;
 
     // 4. 输出规约序列（作业要求格式的雏形）
     for (size_t i = 0; i < steps.size(); ++i) {
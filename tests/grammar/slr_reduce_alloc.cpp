@@ -0,0 +1,152 @@
+//
+// The SLR reduce loop must not allocate: semantic actions see a span over the
+// value stack instead of a freshly built vector of right-hand-side values.
+// Checked on a bare recognizer and on the same grammar with scalar actions
+// running on every reduce.
+//
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <span>
+#include <vector>
+
+#include "grammar/grammar.h"
+#include "grammar/parser_slr.h"
+#include "token.h"
+
+using namespace front;
+using namespace front::grammar;
+
+static bool counting = false;
+static size_t allocations = 0;
+
+void *operator new(const std::size_t size) {
+    if (counting) ++allocations;
+    if (void *p = std::malloc(size == 0 ? 1 : size)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+// a + a * a + a * a + ... $
+static std::vector<Token> make_tokens(const size_t terms) {
+    std::vector<Token> tokens;
+    for (size_t i = 0; i < terms; ++i) {
+        if (i != 0) {
+            const bool mul = i % 2 == 0;
+            tokens.emplace_back(mul ? TokenType::OpMultiply : TokenType::OpPlus, TokenCategory::Operator,
+                                Location{}, mul ? "*" : "+");
+        }
+        tokens.emplace_back(TokenType::Identifier, TokenCategory::Identifier, Location{}, "a");
+    }
+    tokens.emplace_back(TokenType::EndOfFile, TokenCategory::End, Location{}, "$");
+    return tokens;
+}
+
+// E evaluates with every identifier worth 1; each reduce runs one of these
+static size_t reductions = 0;
+
+static ast::SemVal ident_value(std::span<ast::SemVal>) {
+    ++reductions;
+    return 1;
+}
+
+static ast::SemVal forward(const std::span<ast::SemVal> rhs) {
+    ++reductions;
+    return std::move(rhs.front());
+}
+
+static ast::SemVal parenthesized(const std::span<ast::SemVal> rhs) {
+    ++reductions;
+    return std::move(rhs[1]);
+}
+
+static ast::SemVal add(const std::span<ast::SemVal> rhs) {
+    ++reductions;
+    return std::get<int>(rhs[0]) + std::get<int>(rhs[2]);
+}
+
+static ast::SemVal multiply(const std::span<ast::SemVal> rhs) {
+    ++reductions;
+    return std::get<int>(rhs[0]) * std::get<int>(rhs[2]);
+}
+
+static size_t count_parse_allocations(const SLRParser &parser, const std::vector<Token> &tokens) {
+    allocations = 0;
+    counting = true;
+    const auto result = parser.parse(tokens);
+    counting = false;
+    assert(result.success);
+    return allocations;
+}
+
+static Grammar expression_grammar() {
+    Grammar g{
+        "S'",
+        {
+            {"S'", {NT("E")}},
+            {"E", {NT("E"), T("+"), NT("T")}},
+            {"E", {NT("T")}},
+            {"T", {NT("T"), T("*"), NT("F")}},
+            {"T", {NT("F")}},
+            {"F", {T("("), NT("E"), T(")")}},
+            {"F", {T("Ident")}}
+        }
+    };
+    g.init_token_map();
+    return g;
+}
+
+int main() {
+    const SLRParser parser{expression_grammar()};
+
+    const auto small = make_tokens(1'000);
+    const auto large = make_tokens(10'000);
+
+    const size_t small_allocs = count_parse_allocations(parser, small);
+    const size_t large_allocs = count_parse_allocations(parser, large);
+    std::cout << "allocations: " << small_allocs << " (1k terms), "
+            << large_allocs << " (10k terms)" << std::endl;
+
+    // only the two stack reservations; nothing per shift or reduce
+    assert(small_allocs <= 2);
+    assert(large_allocs == small_allocs);
+
+    // the same grammar with an action on every production
+    auto evaluating = expression_grammar();
+    for (auto &prod: evaluating.productions) {
+        if (prod.head.name == "E" && prod.body.size() == 3) {
+            prod.action = add;
+        } else if (prod.head.name == "T" && prod.body.size() == 3) {
+            prod.action = multiply;
+        } else if (prod.head.name == "F" && prod.body.size() == 3) {
+            prod.action = parenthesized;
+        } else if (prod.head.name == "F") {
+            prod.action = ident_value;
+        } else {
+            prod.action = forward;
+        }
+    }
+    const SLRParser evaluator{std::move(evaluating)};
+
+    // identifiers are interned on their first sighting; warm that up
+    count_parse_allocations(evaluator, small);
+    reductions = 0;
+    const size_t small_action_allocs = count_parse_allocations(evaluator, small);
+    const size_t small_reductions = reductions;
+    reductions = 0;
+    const size_t large_action_allocs = count_parse_allocations(evaluator, large);
+    std::cout << "with actions: " << small_action_allocs << " (1k terms), "
+            << large_action_allocs << " (10k terms)" << std::endl;
+
+    // ten times the input runs ten times the actions for no more allocations:
+    // the per-parse arena and the stacks, nothing per reduce
+    assert(small_reductions > small.size());
+    assert(reductions > 9 * small_reductions);
+    assert(large_action_allocs == small_action_allocs);
+    assert(small_action_allocs <= 3);
+    return 0;
+}
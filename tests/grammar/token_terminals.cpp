@@ -0,0 +1,35 @@
+//
+// The TokenType-indexed lookup must agree with the (type, category) token map
+// it is derived from, for both the SLR and the normalized LL(1) grammar.
+//
+#include <cassert>
+
+#include "grammar/grammar.h"
+#include "token.h"
+
+using namespace front;
+using namespace front::grammar;
+
+static void check(const Grammar &g) {
+    size_t mapped = 0;
+    for (const auto &[token, sym]: g.token_to_terminal_) {
+        const TerminalId id = g.terminal_of(token);
+        if (!g.terminal_ids_.contains(sym.name)) {
+            assert(id == kNoTerminal);
+            continue;
+        }
+        assert(id != kNoTerminal);
+        assert(g.terminal_symbols_[id] == sym);
+        ++mapped;
+    }
+    assert(mapped > 0);
+    assert(g.terminal_of(Token{TokenType::EndOfFile, TokenCategory::End}) == kEndTerminal);
+    assert(g.terminal_of(Token{TokenType::Invalid, TokenCategory::Invalid}) == kNoTerminal);
+    assert(g.terminal_of(Token{TokenType::Spacer, TokenCategory::Spacer}) == kNoTerminal);
+}
+
+int main() {
+    check(Grammar{});
+    check(Grammar{true});
+    return 0;
+}
@@ -16,13 +16,17 @@ using front::grammar::Grammar;
 using front::grammar::SLRParser;
 using front::lexer::Lexer;
 
-static std::tuple<bool, front::ast::ProgramPtr> parse_source(const std::string &src) {
+static front::grammar::ParseResult parse_with_recovery(const std::string &src) {
     Lexer lexer{src};
     const auto &tokens = lexer.tokenize();
     const auto processed = post_process(tokens);
     Grammar grammar{};
     const SLRParser parser{std::move(grammar)};
-    auto parsed = parser.parse(processed);
+    return parser.parse(processed);
+}
+
+static std::tuple<bool, front::ast::ProgramPtr> parse_source(const std::string &src) {
+    auto parsed = parse_with_recovery(src);
     return std::make_tuple(parsed.success, std::move(parsed.program));
 }
 
@@ -81,5 +85,32 @@ int main() {
     )";
     expect_failure(unbalanced_brace);
 
+    // every broken statement is reported in one pass and the rest of the
+    // program is still built
+    const std::string several_errors = R"(
+        int g = ;
+        int main() {
+            int a = 1 + ;
+            a = a * ;
+            return a;
+        }
+        int f() {
+            return * 2;
+        }
+    )";
+    const auto recovered = parse_with_recovery(several_errors);
+    assert(!recovered.success);
+    assert(recovered.diagnostics.size() == 4);
+    assert(recovered.diagnostics[0].loc.line == 2);
+    assert(recovered.diagnostics[1].loc.line == 4);
+    assert(recovered.diagnostics[2].loc.line == 5);
+    assert(recovered.diagnostics[3].loc.line == 9);
+    assert(recovered.program != nullptr);
+    assert(recovered.program->functions.size() == 2);
+
+    const auto unclosed = parse_with_recovery("int main() { return 0;");
+    assert(!unclosed.success);
+    assert(unclosed.diagnostics.size() == 1);
+
     return 0;
 }
@@ -0,0 +1,73 @@
+//
+// Scoped bindings in CodegenContext: inner scopes shadow outer ones, popping
+// a scope uncovers exactly what it shadowed, and redeclaring in the same
+// scope replaces the binding. A function-body context layers its own
+// scopes over the module's.
+//
+#include <cassert>
+#include <memory>
+#include <string>
+
+#include "Module.h"
+#include "ir/codegen_context.h"
+#include "utils/interner.h"
+
+using namespace front;
+using front::ir::Binding;
+
+static Binding tagged(const ast::BasicType type, const bool is_const = false) {
+    return {nullptr, type, is_const, false};
+}
+
+int main() {
+    ir::CodegenContext ctx(std::make_unique<Module>("scopes"));
+    auto &names = Interner::global();
+    const SymbolId x = names.intern("scope_test_x");
+    const SymbolId y = names.intern("scope_test_y");
+    const SymbolId unbound = names.intern("scope_test_unbound");
+
+    assert(ctx.lookup(x) == nullptr);
+    ctx.bind(x, tagged(ast::BasicType::Int));
+
+    ctx.push_scope();
+    ctx.bind(x, tagged(ast::BasicType::Float));
+    ctx.bind(y, tagged(ast::BasicType::Int));
+    assert(ctx.lookup(x)->type == ast::BasicType::Float);
+
+    ctx.push_scope();
+    assert(ctx.lookup(x)->type == ast::BasicType::Float);
+    ctx.bind(x, tagged(ast::BasicType::Void));
+    ctx.bind(x, tagged(ast::BasicType::Void, true));
+    assert(ctx.lookup(x)->is_const);
+    ctx.pop_scope();
+
+    assert(ctx.lookup(x)->type == ast::BasicType::Float && !ctx.lookup(x)->is_const);
+    assert(ctx.lookup(y) != nullptr);
+    ctx.pop_scope();
+
+    assert(ctx.lookup(x)->type == ast::BasicType::Int);
+    assert(ctx.lookup(y) == nullptr);
+    assert(ctx.lookup(unbound) == nullptr);
+
+    // bindings stay put while later scopes add more
+    const Binding *outer = ctx.lookup(x);
+    ctx.push_scope();
+    for (int i = 0; i < 1000; ++i) {
+        ctx.bind(names.intern("scope_test_v" + std::to_string(i)), tagged(ast::BasicType::Int));
+    }
+    assert(ctx.lookup(x) == outer);
+    ctx.pop_scope();
+
+    // a function-body context sees the module's bindings and shadows them
+    // without touching them
+    {
+        ir::CodegenContext body{ctx};
+        assert(body.lookup(x) == outer);
+        body.bind(x, tagged(ast::BasicType::Float));
+        body.bind(y, tagged(ast::BasicType::Int));
+        assert(body.lookup(x)->type == ast::BasicType::Float);
+        assert(ctx.lookup(x) == outer && ctx.lookup(y) == nullptr);
+    }
+    assert(ctx.lookup(x) == outer);
+    return 0;
+}
@@ -0,0 +1,73 @@
+//
+// Constant subexpressions are folded into literals before codegen, so
+// neither global initializers nor local code compute them at run time.
+//
+#include <cassert>
+#include <string>
+
+#include "ast/ast.h"
+#include "ast/fold.h"
+#include "grammar/parser_slr.h"
+#include "ir/ir_generator.h"
+#include "lexer/lexer.h"
+#include "token.h"
+
+using namespace front;
+
+static bool contains(const std::string &text, const std::string &needle) {
+    return text.find(needle) != std::string::npos;
+}
+
+int main() {
+    const std::string src =
+            "const int k = 2 * 3 + 1;\n"
+            "float half = 7 / 2;\n"
+            "int wrapped = 2147483647 + 1;\n"
+            "int by_zero = 1 / 0 + 5 % 0;\n"
+            "float f_by_zero = 1.0 / 0;\n"
+            "int main() {\n"
+            "    int x = 4 * (5 - 2);\n"
+            "    float y = 1 + 0.5;\n"
+            "    if (3 > 2 && 1) {\n"
+            "        x = x + -k;\n"
+            "    }\n"
+            "    if (0 || 2.5 < 1) {\n"
+            "        x = x / 0;\n"
+            "    }\n"
+            "    return x;\n"
+            "}\n";
+
+    lexer::Lexer lexer{src};
+    const auto result = grammar::SLRParser::shared().parse(post_process(lexer.tokenize()));
+    assert(result.success);
+
+    ast::fold_constants(*result.program);
+    assert(result.program->constants_folded);
+    const auto &body = *result.program->functions.front()->body;
+    const auto *x = ast::node_cast<ast::VarDecl>(body.items[0].decl.get());
+    const auto *x_init = ast::node_cast<ast::LiteralInt>(x->items.front().value.get());
+    assert(x_init != nullptr && x_init->value == 12);
+    const auto *y = ast::node_cast<ast::VarDecl>(body.items[1].decl.get());
+    const auto *y_init = ast::node_cast<ast::LiteralFloat>(y->items.front().value.get());
+    assert(y_init != nullptr && y_init->value == 1.5f);
+
+    const auto ir = ir::IRGenerator::generate(result.program).module->print();
+    assert(contains(ir, "@k = constant i32 7"));
+    // int division, as the same expression computes inside a function
+    assert(contains(ir, "@half = global float 0x4008000000000000"));
+    assert(contains(ir, "@wrapped = global i32 -2147483648"));
+    // a global initializer has no run time to trap at: division by zero is 0
+    assert(contains(ir, "@by_zero = global i32 0"));
+    assert(contains(ir, "@f_by_zero = global float 0x0000000000000000"));
+    assert(contains(ir, "store i32 12"));
+    assert(contains(ir, "br i1 true") && contains(ir, "br i1 false"));
+    for (const char *op: {"mul ", "sitofp", "fadd", "icmp", "fcmp", "phi"}) {
+        assert(!contains(ir, op));
+    }
+    // division by zero is left for run time
+    assert(contains(ir, "sdiv"));
+
+    // folding runs once; generating again gives the same module
+    assert(ir::IRGenerator::generate(result.program).module->print() == ir);
+    return 0;
+}
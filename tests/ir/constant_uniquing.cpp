@@ -0,0 +1,34 @@
+//
+// Constants are uniqued per Module: equal values are one object, so pointer
+// equality compares constants, and values that only look equal stay apart.
+//
+#include <cassert>
+#include <memory>
+
+#include "Constant.h"
+#include "Module.h"
+
+int main() {
+    auto module = std::make_unique<Module>("constants");
+    Module *m = module.get();
+
+    assert(ConstantInt::get(42, m) == ConstantInt::get(42, m));
+    assert(ConstantInt::get(42, m) != ConstantInt::get(43, m));
+    assert(ConstantInt::get(true, m) == ConstantInt::get(true, m));
+    // i1 true and i32 1 differ in type
+    assert(ConstantInt::get(true, m) != ConstantInt::get(1, m));
+    assert(ConstantInt::get(true, m)->get_type() == m->get_int1_type());
+
+    assert(ConstantFloat::get(1.5f, m) == ConstantFloat::get(1.5f, m));
+    // equal as floats, distinct as bit patterns
+    assert(ConstantFloat::get(0.0f, m) != ConstantFloat::get(-0.0f, m));
+
+    assert(ConstantZero::get(m->get_int32_type(), m) == ConstantZero::get(m->get_int32_type(), m));
+    assert(ConstantZero::get(m->get_int32_type(), m) != ConstantZero::get(m->get_float_type(), m));
+
+    // tables are per module
+    Module other("other");
+    assert(ConstantInt::get(42, &other) != ConstantInt::get(42, m));
+    assert(ConstantInt::get(42, &other)->get_type() == other.get_int32_type());
+    return 0;
+}
@@ -0,0 +1,124 @@
+//
+// Generated code can nest far deeper than the call stack allows recursion:
+// folding, codegen and flattening walk such trees on an explicit stack.
+//
+#include <cassert>
+#include <memory>
+#include <string>
+
+#include "ast/ast.h"
+#include "ast/flat_ast.h"
+#include "ir/ir_generator.h"
+#include "utils/interner.h"
+
+using namespace front;
+
+namespace {
+    constexpr int kDepth = 100000;
+
+    ast::ExprPtr identifier(const SymbolId name) {
+        auto id = ast::make_node<ast::IdentifierExpr>();
+        id->name = name;
+        return id;
+    }
+
+    ast::ExprPtr literal(const int value) {
+        auto lit = ast::make_node<ast::LiteralInt>();
+        lit->value = value;
+        return lit;
+    }
+
+    ast::StmtPtr assign(const SymbolId target, ast::ExprPtr value) {
+        auto stmt = ast::make_node<ast::AssignStmt>();
+        stmt->target = target;
+        stmt->expr = std::move(value);
+        return stmt;
+    }
+
+    // int main() {
+    //     int x = 1;
+    //     x = x + x + ... + x;          left spine of kDepth additions
+    //     x = -(-(...(1 + 2)...));      kDepth unary minuses over a constant
+    //     if (x) if (x) ... x = 2;      kDepth nested ifs
+    //     {{{ ... x = 3; ... }}}        kDepth nested blocks
+    //     return x;
+    // }
+    ast::ProgramPtr deep_program() {
+        auto program = std::make_unique<ast::Program>();
+        program->arenas.push_back(std::make_shared<ast::Arena>());
+        ast::ArenaScope scope{*program->arenas.back()};
+        const SymbolId x = Interner::global().intern("x");
+
+        auto body = ast::make_node<ast::BlockStmt>();
+        auto decl = ast::make_node<ast::VarDecl>();
+        decl->items.push_back({x, literal(1)});
+        body->items.push_back(ast::BlockItem::make_decl(std::move(decl)));
+
+        ast::ExprPtr sum = identifier(x);
+        for (int i = 0; i < kDepth; ++i) {
+            auto add = ast::make_node<ast::BinaryExpr>();
+            add->op = ast::BasicOp::Add;
+            add->lhs = std::move(sum);
+            add->rhs = identifier(x);
+            sum = std::move(add);
+        }
+        body->items.push_back(ast::BlockItem::make_stmt(assign(x, std::move(sum))));
+
+        auto constant = ast::make_node<ast::BinaryExpr>();
+        constant->op = ast::BasicOp::Add;
+        constant->lhs = literal(1);
+        constant->rhs = literal(2);
+        ast::ExprPtr negated = std::move(constant);
+        for (int i = 0; i < kDepth; ++i) {
+            auto neg = ast::make_node<ast::UnaryExpr>();
+            neg->op = ast::UnaryOp::Negative;
+            neg->operand = std::move(negated);
+            negated = std::move(neg);
+        }
+        body->items.push_back(ast::BlockItem::make_stmt(assign(x, std::move(negated))));
+
+        ast::StmtPtr nested_if = assign(x, literal(2));
+        for (int i = 0; i < kDepth; ++i) {
+            auto ifs = ast::make_node<ast::IfStmt>();
+            ifs->condition = identifier(x);
+            ifs->then_branch = std::move(nested_if);
+            nested_if = std::move(ifs);
+        }
+        body->items.push_back(ast::BlockItem::make_stmt(std::move(nested_if)));
+
+        ast::StmtPtr nested_block = assign(x, literal(3));
+        for (int i = 0; i < kDepth; ++i) {
+            auto block = ast::make_node<ast::BlockStmt>();
+            block->items.push_back(ast::BlockItem::make_stmt(std::move(nested_block)));
+            nested_block = std::move(block);
+        }
+        body->items.push_back(ast::BlockItem::make_stmt(std::move(nested_block)));
+
+        auto ret = ast::make_node<ast::ReturnStmt>();
+        ret->value = identifier(x);
+        body->items.push_back(ast::BlockItem::make_stmt(std::move(ret)));
+
+        auto main_fn = ast::make_node<ast::FuncDef>();
+        main_fn->type = ast::BasicType::Int;
+        main_fn->name = Interner::global().intern("main");
+        main_fn->body = std::move(body);
+        program->functions.push_back(std::move(main_fn));
+        return program;
+    }
+}
+
+int main() {
+    const auto program = deep_program();
+
+    const auto flat = ast::flatten(*program);
+    assert(flat.functions.size() == 1);
+
+    const auto ir = ir::IRGenerator::generate(program).module->print();
+    // the unary chain folded away: an even number of negations of 1 + 2
+    const auto &items = program->functions.front()->body->items;
+    const auto *folded = ast::node_cast<ast::AssignStmt>(items[2].stmt.get());
+    const auto *value = ast::node_cast<ast::LiteralInt>(folded->expr.get());
+    assert(value != nullptr && value->value == 3);
+    assert(ir.find("sub i32") == std::string::npos);
+    return 0;
+}
@@ -0,0 +1,106 @@
+//
+// Instructions, blocks and uses live on intrusive lists: operands are the use
+// nodes, so retargeting, growing and erasing operands keeps every use list
+// exact, and instructions can be inserted and removed anywhere in a block.
+//
+#include <cassert>
+#include <memory>
+#include <vector>
+
+#include "Constant.h"
+#include "Module.h"
+
+namespace {
+    // every use on v's list points back at v from the operand slot it names
+    size_t checked_uses(Value *v) {
+        size_t n = 0;
+        for (const auto *use : v->get_use_list()) {
+            const auto *user = static_cast<User *>(use->val_);
+            assert(user->get_operand(use->arg_no_) == v);
+            ++n;
+        }
+        return n;
+    }
+
+    std::vector<Instruction *> instructions(BasicBlock *bb) {
+        std::vector<Instruction *> out;
+        for (auto *inst : bb->get_instructions()) {
+            out.push_back(inst);
+        }
+        return out;
+    }
+}
+
+int main() {
+    auto module = std::make_unique<Module>("lists");
+    Module *m = module.get();
+    auto *i32 = m->get_int32_type();
+
+    auto *callee = Function::create(FunctionType::get(i32, std::vector<Type *>(40, i32)), "callee", m);
+    auto *fn = Function::create(FunctionType::get(i32, {}), "f", m);
+    auto *entry = BasicBlock::create(m, "entry", fn);
+    auto *exit = BasicBlock::create(m, "exit", fn);
+    assert(fn->get_entry_block() == entry && fn->get_num_basic_blocks() == 2);
+
+    auto *a = AllocaInst::create_alloca(i32, entry);
+    auto *b = AllocaInst::create_alloca(i32, entry);
+    auto *x = LoadInst::create_load(i32, a, entry);
+    auto *y = LoadInst::create_load(i32, a, entry);
+    auto *sum = BinaryInst::create_add(x, y, entry, m);
+    assert(checked_uses(a) == 2 && checked_uses(x) == 1);
+
+    // retargeting an operand moves its use between lists
+    sum->set_operand(1, x);
+    assert(checked_uses(x) == 2 && checked_uses(y) == 0);
+
+    // replace_all_use_with empties the old list into the new one
+    a->replace_all_use_with(b);
+    assert(checked_uses(a) == 0 && checked_uses(b) == 2);
+    assert(x->get_operand(0) == b);
+
+    // erasing a run of arguments shifts the later use nodes down
+    std::vector<Value *> args(40, sum);
+    auto *call = CallInst::create(callee, args, entry);
+    assert(checked_uses(sum) == 40 && checked_uses(callee) == 1);
+    call->remove_operands(1, 10);
+    assert(call->get_num_operand() == 31 && checked_uses(sum) == 30);
+    assert(call->get_operand(0) == callee);
+
+    // a phi may name values created after it; teardown copes with either order
+    auto *phi = PhiInst::create_phi(i32, exit);
+    exit->add_instr_begin(phi);
+    auto *late = BinaryInst::create_mul(sum, sum, exit, m);
+    phi->add_phi_pair_operand(late, entry);
+    phi->add_phi_pair_operand(ConstantInt::get(0, m), exit);
+    assert(checked_uses(late) == 1 && checked_uses(entry) == 1);
+    phi->remove_source(entry);
+    assert(checked_uses(late) == 0 && checked_uses(entry) == 0 && checked_uses(exit) == 1);
+
+    // operands appended one by one relocate the earlier use nodes
+    for (int i = 0; i < 32; ++i) {
+        phi->add_phi_pair_operand(late, entry);
+    }
+    assert(checked_uses(late) == 32 && checked_uses(entry) == 32 && checked_uses(exit) == 1);
+    phi->remove_operands(2, 63);
+    assert(phi->get_num_operand() == 4 && checked_uses(late) == 1 && checked_uses(entry) == 1);
+
+    // block edits: after the phis, at the front, and removal in the middle
+    auto *z = LoadInst::create_load(i32, b, exit);
+    exit->get_instructions().erase(z);
+    exit->add_instr_after_phi(z);
+    assert((instructions(exit) == std::vector<Instruction *>{phi, z, late}));
+    assert(z->getPrevInst() == phi && z->getSuccInst() == late);
+    entry->delete_instr(y);
+    assert(entry->get_num_of_instr() == 5 && x->getSuccInst() == sum);
+    assert(checked_uses(b) == 2);
+    ReturnInst::create_ret(phi, exit);
+    BranchInst::create_br(exit, entry);
+    assert(entry->get_terminator() != nullptr && exit->get_terminator() != nullptr);
+
+    auto *dead = BasicBlock::create(m, "dead", fn);
+    BranchInst::create_br(exit, dead);
+    fn->remove(dead);
+    assert(fn->get_num_basic_blocks() == 2 && fn->get_basic_blocks().back() == exit);
+    assert(m->print().find("call i32 @callee") != std::string::npos);
+    return 0;
+}
@@ -0,0 +1,104 @@
+//
+// A Module owns every IR object built for it: types, constants, globals,
+// functions, arguments, blocks and instructions. Destroying it must hand back
+// every heap block those objects took, on the sequential and parallel paths.
+//
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+#include "Constant.h"
+#include "Module.h"
+#include "ast/ast.h"
+#include "grammar/parser_slr.h"
+#include "ir/ir_generator.h"
+#include "lexer/lexer.h"
+#include "token.h"
+
+using namespace front;
+
+// pool workers allocate concurrently with the main thread
+static std::atomic<long> live_blocks{0};
+
+void *operator new(const std::size_t size) {
+    if (void *p = std::malloc(size == 0 ? 1 : size)) {
+        ++live_blocks;
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept {
+    if (p) --live_blocks;
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+    if (p) --live_blocks;
+    std::free(p);
+}
+
+namespace {
+    constexpr auto kSource = R"(
+const int limit = 2 * 3 + 1;
+float scale = 0.5;
+int total;
+
+int step(int a, int b) {
+    int s = a * b % limit;
+    if (s > total || a == 0) { total = total + s; } else { s = s - 1; }
+    return s;
+}
+
+float blend(float x, int y) { return x * scale + y; }
+
+int main() {
+    int x = step(3, 4);
+    if (x > 2 && blend(1.5, x) < 10.0) { scale = scale + 1; }
+    return x + step(x, 2);
+}
+)";
+
+    // lowers the program and drops the module; returns how many objects it held
+    size_t lower_and_drop(const ast::ProgramPtr &program, const size_t jobs) {
+        auto result = ir::IRGenerator::generate(program, jobs);
+        const size_t objects = result.module->num_objects();
+        assert(result.module->print().find("define i32 @main") != std::string::npos);
+        return objects;
+    }
+}
+
+int main() {
+    lexer::Lexer lexer{kSource};
+    const auto parsed = grammar::SLRParser::shared().parse(post_process(lexer.tokenize()));
+    assert(parsed.success);
+
+    // first lowering folds constants and warms up lazily built tables
+    const size_t objects = lower_and_drop(parsed.program, 1);
+    assert(objects > 100);
+
+    for (const size_t jobs : {1, 1, 4, 4}) {
+        const long before = live_blocks;
+        assert(lower_and_drop(parsed.program, jobs) == objects);
+        assert(live_blocks == before);
+    }
+
+    // the same holds for objects built by hand, including unused types
+    const long before = live_blocks;
+    {
+        Module m("manual");
+        auto *array = m.get_array_type(m.get_int32_type(), 16);
+        auto *fn_ty = FunctionType::get(m.get_void_type(), {m.get_pointer_type(array), m.get_float_type()});
+        assert(fn_ty->get_module() == &m);
+        auto *fn = Function::create(fn_ty, "f", &m);
+        auto *bb = BasicBlock::create(&m, "entry", fn);
+        auto *slot = AllocaInst::create_alloca(m.get_int32_type(), bb);
+        StoreInst::create_store(ConstantInt::get(7, &m), slot, bb);
+        ReturnInst::create_void_ret(bb);
+        IntegerType::get(32, &m);
+    }
+    assert(live_blocks == before);
+    return 0;
+}
@@ -0,0 +1,55 @@
+//
+// Function bodies lowered on a thread pool must give the same IR as the
+// sequential path, block numbers included, run after run, with bodies
+// sharing globals and calling each other.
+//
+#include <cassert>
+#include <string>
+
+#include "ast/ast.h"
+#include "grammar/parser_slr.h"
+#include "ir/ir_generator.h"
+#include "lexer/lexer.h"
+#include "token.h"
+
+using namespace front;
+
+namespace {
+    constexpr int kFunctions = 64;
+
+    std::string source() {
+        std::string src = "int total = 0;\nfloat scale = 0.5;\n";
+        for (int i = 0; i < kFunctions; ++i) {
+            const std::string n = std::to_string(i);
+            src += "int f" + n + "(int a) {\n"
+                    "    int x = a * " + n + ";\n"
+                    "    if (x > total || a == 0) { total = total + x; } else { x = x - 1; }\n"
+                    "    if (a % 3 == 1) { float y = scale * a; scale = y; }\n";
+            if (i > 0) {
+                src += "    x = x + f" + std::to_string(i - 1) + "(a - 1);\n";
+            }
+            src += "    return x;\n}\n";
+        }
+        src += "int main() { return f" + std::to_string(kFunctions - 1) + "(5); }\n";
+        return src;
+    }
+
+    std::string lower(const std::string &src, const size_t jobs) {
+        lexer::Lexer lexer{src};
+        const auto result = grammar::SLRParser::shared().parse(post_process(lexer.tokenize()));
+        assert(result.success);
+        return ir::IRGenerator::generate(result.program, jobs).module->print();
+    }
+}
+
+int main() {
+    const auto src = source();
+    const auto expected = lower(src, 1);
+    assert(expected.find("define i32 @f63") != std::string::npos);
+    // block numbers run on across the module: f0 takes 0-6, f1 starts at 7
+    assert(expected.find("label_or.rhs.7:") != std::string::npos);
+    for (int run = 0; run < 8; ++run) {
+        assert(lower(src, 4) == expected);
+    }
+    return 0;
+}
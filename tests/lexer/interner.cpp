@@ -0,0 +1,62 @@
+//
+// Identifiers are interned while lexing: equal names share one SymbolId, on
+// any thread, and the id maps back to the original text until the table is
+// reset.
+//
+#include <cassert>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "lexer/lexer.h"
+#include "token.h"
+#include "utils/interner.h"
+
+using namespace front;
+
+int main() {
+    lexer::Lexer lexer{"int main() { int count = 1; count = count + 1; return count; }"};
+    const auto &tokens = lexer.tokenize();
+
+    SymbolId count = kNoSymbol;
+    size_t uses = 0;
+    for (const auto &token: tokens) {
+        if (token.type == TokenType::Identifier) {
+            assert(token.symbol != kNoSymbol);
+            assert(symbol_name(token.symbol) == token.lexeme);
+            if (count == kNoSymbol) count = token.symbol;
+            assert(token.symbol == count);
+            ++uses;
+        } else if (token.type == TokenType::KwMain) {
+            assert(symbol_name(token.symbol) == "main");
+        } else {
+            assert(token.symbol == kNoSymbol);
+        }
+    }
+    assert(uses == 4);
+
+    // concurrent interning agrees on one id per name
+    Interner interner;
+    std::vector<std::vector<SymbolId> > seen(4);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < seen.size(); ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < 1000; ++i) {
+                // appended, not "v" + to_string(): GCC 12 warns -Wrestrict on that
+                seen[t].push_back(interner.intern(std::string{"v"}.append(std::to_string(i % 100))));
+            }
+        });
+    }
+    for (auto &thread: threads) thread.join();
+    assert(interner.size() == 100);
+    for (const auto &ids: seen) {
+        assert(ids == seen.front());
+    }
+    assert(interner.name(interner.intern("v42")) == "v42");
+
+    // a reset table numbers names afresh
+    interner.reset();
+    assert(interner.size() == 0);
+    assert(interner.intern("w") == 0 && interner.name(0) == "w");
+    return 0;
+}
@@ -0,0 +1,82 @@
+//
+// Parsing from a lexer running on its own thread must give exactly the
+// result of the sequential path, and the pipeline must shut down cleanly
+// when the parser stops early.
+//
+#include <cassert>
+#include <string>
+#include <vector>
+
+#include "ast/ast.h"
+#include "grammar/parser.h"
+#include "grammar/parser_slr.h"
+#include "lexer/lexer.h"
+#include "lexer/token_pipeline.h"
+#include "token.h"
+
+#include "ast_dump.h"
+
+using namespace front;
+
+static std::string large_source(const size_t functions) {
+    std::string src = "int g = 1;\n";
+    for (size_t f = 0; f < functions; ++f) {
+        src += "float f" + std::to_string(f) + "(int a) {\n";
+        for (int s = 0; s < 8; ++s) {
+            src += "    if (a < " + std::to_string(s) + ") { a = a * 2 + g; } else { a = a - 1; }\n";
+        }
+        src += "    return a;\n}\n";
+    }
+    return src + "int main() { return f0(g); }\n";
+}
+
+int main() {
+    const auto &parser = grammar::SLRParser::shared();
+
+    std::vector<std::string> sources{
+        "int main() { return 0; }\n",
+        large_source(200),
+        "int main() {\n    int a = ;\n    a = 1 +;\n    return a;\n}\n",
+        "int x = 1 @ 2;\nint main() { return x; }\n",
+        large_source(50) + "int broken( { return; }\n" + large_source(50),
+    };
+
+    lexer::Lexer lexer{};
+    for (const auto &source: sources) {
+        lexer.reset(source);
+        const auto tokens = post_process(lexer.tokenize());
+        grammar::VectorTraceSink sequential_trace;
+        const auto sequential = parser.parse(tokens, sequential_trace);
+
+        lexer.reset(source);
+        grammar::VectorTraceSink pipelined_trace;
+        lexer::TokenPipeline pipeline{lexer};
+        const auto pipelined = parser.parse_source(pipeline, pipelined_trace);
+
+        assert(pipelined.success == sequential.success);
+        assert(dump(pipelined.program) == dump(sequential.program));
+        assert(pipelined.diagnostics.size() == sequential.diagnostics.size());
+        for (size_t i = 0; i < sequential.diagnostics.size(); ++i) {
+            assert(pipelined.diagnostics[i].message == sequential.diagnostics[i].message);
+            assert(pipelined.diagnostics[i].loc.line == sequential.diagnostics[i].loc.line);
+            assert(pipelined.diagnostics[i].loc.column == sequential.diagnostics[i].loc.column);
+        }
+        assert(pipelined_trace.steps.size() == sequential_trace.steps.size());
+        for (size_t i = 0; i < sequential_trace.steps.size(); ++i) {
+            assert(pipelined_trace.steps[i].top == sequential_trace.steps[i].top);
+            assert(pipelined_trace.steps[i].lookahead == sequential_trace.steps[i].lookahead);
+            assert(pipelined_trace.steps[i].action == sequential_trace.steps[i].action);
+        }
+    }
+
+    // abandoning the input with the queue full must not hang the producer
+    lexer.reset(large_source(2000));
+    {
+        lexer::TokenPipeline pipeline{lexer};
+        for (int i = 0; i < 10 && pipeline.current() != nullptr; ++i) {
+            pipeline.advance();
+        }
+        assert(pipeline.position() == 10);
+    }
+    return 0;
+}
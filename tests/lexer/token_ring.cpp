@@ -0,0 +1,84 @@
+//
+// The fused lexer → ring → parser path must see exactly the tokens of
+// post_process(tokenize()) and parse them to the same result and trace.
+//
+#include <cassert>
+#include <string>
+#include <vector>
+
+#include "ast/ast.h"
+#include "grammar/parser.h"
+#include "grammar/parser_slr.h"
+#include "lexer/lexer.h"
+#include "lexer/token_ring.h"
+#include "token.h"
+
+#include "ast_dump.h"
+
+using namespace front;
+
+static const char *kSources[] = {
+    "int main() { return 0; }\n",
+    "int g = 1;\nconst float k = 2.5;\n"
+    "float half(float x) { return x / 2.0; }\n"
+    "int add(int a, int b) {\n    int main = a + b;\n    if (a < b) { a = a + 1; } else { b = b - 1; }\n"
+    "    return main;\n}\n"
+    "int main() { int x = add(g); return x; }\n",
+    // function-like declarations inside a body are left alone
+    "int f() { int g(1); { int h (2); } return 0; }\nint main() { return f(); }\n",
+    // errors: recovery must skip the same tokens in both modes
+    "int main() {\n    int a = ;\n    a = 1 +;\n    return a;\n}\n",
+    "int main() { return 1 }\n",
+    "int x = 1 @ 2;\nint main() { return x; }\n",
+    "int",
+};
+
+static bool same_token(const Token &a, const Token &b) {
+    return a.type == b.type && a.category == b.category && a.lexeme == b.lexeme &&
+           a.loc.line == b.loc.line && a.loc.column == b.loc.column;
+}
+
+int main() {
+    const auto &parser = grammar::SLRParser::shared();
+
+    for (const char *source: kSources) {
+        lexer::Lexer batch{source};
+        const auto expected = post_process(batch.tokenize());
+
+        // the ring yields the post-processed tokens, in order
+        lexer::Lexer streaming{source};
+        lexer::TokenRing ring{streaming};
+        std::vector<Token> streamed;
+        for (; ring.current() != nullptr; ring.advance()) {
+            assert(ring.position() == streamed.size());
+            streamed.push_back(*ring.current());
+        }
+        assert(streamed.size() == expected.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            assert(same_token(streamed[i], expected[i]));
+        }
+
+        // and parsing from it matches parsing the vector
+        grammar::VectorTraceSink vector_trace, fused_trace;
+        const auto from_vector = parser.parse(expected, vector_trace);
+        lexer::Lexer fused{source};
+        lexer::TokenRing fused_ring{fused};
+        const auto from_ring = parser.parse_source(fused_ring, fused_trace);
+
+        assert(from_ring.success == from_vector.success);
+        assert(dump(from_ring.program) == dump(from_vector.program));
+        assert(from_ring.diagnostics.size() == from_vector.diagnostics.size());
+        for (size_t i = 0; i < from_vector.diagnostics.size(); ++i) {
+            assert(from_ring.diagnostics[i].message == from_vector.diagnostics[i].message);
+            assert(from_ring.diagnostics[i].loc.line == from_vector.diagnostics[i].loc.line);
+            assert(from_ring.diagnostics[i].loc.column == from_vector.diagnostics[i].loc.column);
+        }
+        assert(fused_trace.steps.size() == vector_trace.steps.size());
+        for (size_t i = 0; i < vector_trace.steps.size(); ++i) {
+            assert(fused_trace.steps[i].top == vector_trace.steps[i].top);
+            assert(fused_trace.steps[i].lookahead == vector_trace.steps[i].lookahead);
+            assert(fused_trace.steps[i].action == vector_trace.steps[i].action);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,179 @@
+//
+// rdgen: turns the normalized LL(1) grammar into a header of direct-coded
+// recursive-descent functions, one per nonterminal, each a `switch` on the
+// lookahead terminal id. Run at build time; see include/grammar/parser_rd.h.
+//
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "grammar/grammar.h"
+#include "grammar/parser_ll.h"
+
+using namespace front::grammar;
+
+static std::string quoted(const std::string &s) {
+    std::string out = "\"";
+    for (const char c: s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out + '"';
+}
+
+// comments must not end up containing a line continuation or `*/`
+static std::string comment_safe(const std::string &s) {
+    std::string out;
+    for (const char c: s) {
+        out += c == '\\' ? '/' : c;
+    }
+    return out;
+}
+
+static void emit_nonterminal(std::ostream &os, const LL1Parser &parser, const size_t A) {
+    const auto &g = parser.grammar_;
+    const size_t n_terminals = g.terminal_symbols_.size();
+
+    // terminals grouped by the production they select, in terminal order
+    std::map<int, std::vector<size_t> > cases;
+    std::vector<int> order;
+    for (size_t t = 0; t < n_terminals; ++t) {
+        const int pid = parser.table_entry(A, t);
+        if (pid == LL1Parser::kNoProduction) continue;
+        if (!cases.contains(pid)) order.push_back(pid);
+        cases[pid].push_back(t);
+    }
+
+    // right recursion on A itself (the tails left by left-recursion
+    // elimination) loops instead of recursing
+    bool loops = false;
+    for (const int pid: order) {
+        const auto &body = g.productions[pid].body;
+        loops |= body.size() > 1 && body.back() == g.nonterminal_symbols_[A];
+    }
+
+    const std::string indent = loops ? "                " : "            ";
+    os << "    // " << comment_safe(g.nonterminal_symbols_[A].name) << "\n"
+            << "    template<typename Ctx>\n"
+            << "    bool parse_nt_" << A << "(Ctx &ctx) {\n";
+    if (loops) os << "        for (;;) {\n";
+    os << indent.substr(4) << "switch (ctx.peek()) {\n";
+
+    for (const int pid: order) {
+        const auto &prod = g.productions[pid];
+        for (const size_t t: cases[pid]) {
+            os << indent << "case " << t << ": // " << comment_safe(g.terminal_symbols_[t].name) << "\n";
+        }
+        os << indent << "    // " << comment_safe((std::ostringstream{} << prod).str()) << "\n";
+        os << indent << "    ctx.expand(" << A << ");\n";
+
+        std::vector<Symbol> body;
+        for (const auto &sym: prod.body) {
+            if (!sym.is_epsilon()) body.push_back(sym);
+        }
+        bool returned = false;
+        for (size_t i = 0; i < body.size(); ++i) {
+            const auto &sym = body[i];
+            const bool last = i + 1 == body.size();
+            if (sym.is_terminal()) {
+                os << indent << "    if (!ctx.match(" << g.terminal_ids_.at(sym.name) << ")) return false;\n";
+                continue;
+            }
+            const size_t B = g.nonterminal_ids_.at(sym.name);
+            if (last && B == A) {
+                os << indent << "    continue;\n";
+                returned = true;
+            } else if (last) {
+                os << indent << "    return parse_nt_" << B << "(ctx);\n";
+                returned = true;
+            } else {
+                os << indent << "    if (!parse_nt_" << B << "(ctx)) return false;\n";
+            }
+        }
+        if (!returned) {
+            os << indent << "    return true;\n";
+        }
+    }
+
+    os << indent << "default:\n"
+            << indent << "    return ctx.fail(" << A << ");\n"
+            << indent.substr(4) << "}\n";
+    if (loops) os << "        }\n";
+    os << "    }\n\n";
+}
+
+int main(const int argc, char *argv[]) {
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " <output-header>\n";
+        return 1;
+    }
+
+    const LL1Parser parser{};
+    const auto &g = parser.grammar_;
+
+    std::ostringstream os;
+    os << "// Generated by rdgen from the normalized LL(1) grammar. Do not edit.\n"
+            << "#pragma once\n"
+            << "#include <cstdint>\n"
+            << "#include <string_view>\n\n"
+            << "#include \"token.h\"\n\n"
+            << "namespace front::grammar::rd {\n";
+
+    os << "    inline constexpr uint32_t kTerminalCount = " << g.terminal_symbols_.size() << ";\n"
+            << "    inline constexpr uint32_t kEnd = " << g.terminal_ids_.at(Symbol::End().name) << ";\n"
+            << "    // lookahead id of tokens the grammar has no terminal for\n"
+            << "    inline constexpr uint32_t kUnknown = kTerminalCount;\n\n";
+
+    os << "    inline constexpr std::string_view kTerminalNames[] = {\n";
+    for (const auto &sym: g.terminal_symbols_) os << "        " << quoted(sym.name) << ",\n";
+    os << "    };\n\n";
+
+    os << "    inline constexpr std::string_view kNonterminalNames[] = {\n";
+    for (const auto &sym: g.nonterminal_symbols_) os << "        " << quoted(sym.name) << ",\n";
+    os << "    };\n\n";
+
+    os << "    struct TokenTerminal {\n"
+            << "        TokenType type;\n"
+            << "        TokenCategory category;\n"
+            << "        uint32_t terminal;\n"
+            << "    };\n\n"
+            << "    inline constexpr TokenTerminal kTokenTerminals[] = {\n";
+    std::map<std::pair<int, int>, size_t> token_terminals; // sorted for a stable output
+    for (const auto &[token, sym]: g.token_to_terminal_) {
+        if (const auto it = g.terminal_ids_.find(sym.name); it != g.terminal_ids_.end()) {
+            token_terminals[{static_cast<int>(token.type), static_cast<int>(token.category)}] = it->second;
+        }
+    }
+    for (const auto &[key, terminal]: token_terminals) {
+        os << "        {static_cast<TokenType>(" << key.first << "), "
+                << "static_cast<TokenCategory>(" << key.second << "), "
+                << terminal << "}, // " << comment_safe(g.terminal_symbols_[terminal].name) << "\n";
+    }
+    os << "    };\n\n";
+
+    for (size_t A = 0; A < g.nonterminal_symbols_.size(); ++A) {
+        os << "    template<typename Ctx>\n"
+                << "    bool parse_nt_" << A << "(Ctx &ctx);\n";
+    }
+    os << "\n";
+    for (size_t A = 0; A < g.nonterminal_symbols_.size(); ++A) {
+        emit_nonterminal(os, parser, A);
+    }
+
+    os << "    template<typename Ctx>\n"
+            << "    bool parse_start(Ctx &ctx) {\n"
+            << "        return parse_nt_" << g.nonterminal_ids_.at(g.start_symbol_.name) << "(ctx);\n"
+            << "    }\n"
+            << "}\n";
+
+    std::ofstream out(argv[1]);
+    if (!out) {
+        std::cerr << "Error: cannot write to output file: " << argv[1] << std::endl;
+        return 1;
+    }
+    out << os.str();
+    return 0;
+}